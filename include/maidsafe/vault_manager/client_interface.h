@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_H_
 #define MAIDSAFE_VAULT_MANAGER_CLIENT_INTERFACE_H_
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <future>
@@ -26,6 +27,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "asio/io_service_strand.hpp"
@@ -37,6 +39,11 @@
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/vault_event.h"
+#include "maidsafe/vault_manager/vault_removal_progress.h"
+#include "maidsafe/vault_manager/vault_statistics.h"
+#include "maidsafe/vault_manager/vault_summary.h"
+
 namespace maidsafe {
 
 namespace vault_manager {
@@ -49,9 +56,17 @@ struct PromiseAndTimer;
 }  // namespace detail
 
 struct Challenge;
+struct ListVaultsResponse;
 struct LogMessage;
+struct RemoveVaultProgress;
+struct RemoveVaultResponse;
+struct SessionTicket;
+struct UpgradeVaultsResponse;
+struct VaultLifecycleEvent;
+struct VaultNetworkStatus;
 struct VaultRunningResponse;
 struct VaultStartedResponse;
+struct VaultStatsResponse;
 
 class ClientInterface {
  public:
@@ -59,9 +74,16 @@ class ClientInterface {
   ClientInterface(ClientInterface&&) = delete;
   ClientInterface& operator=(ClientInterface) = delete;
 
-  explicit ClientInterface(const passport::Maid& maid);
+  // If 'session_ticket' is from GetSessionTicket() of an earlier instance and hasn't expired, the
+  // connection is validated using it rather than by signing a challenge with 'maid'.  Each ticket
+  // can only be used once.
+  explicit ClientInterface(const passport::Maid& maid,
+                           std::string session_ticket = std::string());
   ~ClientInterface();
 
+  // Returns a ticket allowing a later instance using the same Maid to reconnect cheaply.
+  std::string GetSessionTicket() const;
+
   std::future<std::unique_ptr<passport::PmidAndSigner>> TakeOwnership(
       const NonEmptyString& label, const boost::filesystem::path& vault_dir,
       DiskUsage max_disk_usage);
@@ -75,6 +97,49 @@ class ClientInterface {
       const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage);
 #endif
 
+  // Asks the VaultManager to switch to the vault executable at 'vault_executable_path' (which must be
+  // in the same directory as the current one) and restart all its vaults, 'batch_size' at a time,
+  // waiting for each batch to rejoin the network before restarting the next.  If a batch fails to
+  // rejoin, the VaultManager rolls back to the previous executable and the future throws.  On
+  // success, the future holds the labels of the upgraded vaults.  The request is refused if any
+  // vault on the host is owned by a different client.
+  std::future<std::vector<NonEmptyString>> UpgradeVaults(
+      const boost::filesystem::path& vault_executable_path, int batch_size = 1,
+      const std::chrono::steady_clock::duration& timeout = std::chrono::hours(1));
+
+  // The returned future becomes ready once at least 'vault_count' vaults owned by this client have
+  // joined the network and reported a routing table health of at least 'min_network_health' (0 to
+  // only require them to have joined).  It throws VaultManagerErrors::timed_out if that doesn't
+  // happen within 'timeout'.  A vault whose process exits isn't counted until it rejoins.
+  std::future<void> WaitForJoinedVaults(int vault_count, int min_network_health,
+                                        const std::chrono::steady_clock::duration& timeout);
+
+  // Retrieves the latest statistics reported by the vaults on this host (see HostStatistics).
+  std::future<HostStatistics> GetHostStatistics();
+
+  // Lists this client's vaults which match 'query'.  Several queries may be outstanding at once.
+  std::future<VaultList> ListVaults(ListVaultsQuery query = ListVaultsQuery());
+
+  // Retrieves the current state of this client's vault with 'label'.  The future throws
+  // CommonErrors::no_such_element if there is no such vault.
+  std::future<VaultSummary> GetVaultStatus(const NonEmptyString& label);
+
+  // 'functor' is invoked as each lifecycle event (see VaultEventType) of this client's vaults
+  // happens.  It is called on the thread handling the connection to the VaultManager, so shouldn't
+  // block.  Replaces any previous functor; pass nullptr to unsubscribe.  The VaultManager only
+  // sends events to subscribed clients, so events which happen before it receives the subscription
+  // are never seen.
+  void SubscribeToVaultEvents(std::function<void(VaultEvent)> functor);
+
+  // Stops this client's vault with 'label', removes it from the VaultManager's config and then
+  // deletes its directory in the background.  The future becomes ready once the vault has stopped
+  // and its removal from the config is durable; it throws CommonErrors::no_such_element if there is
+  // no such vault.  'on_progress', if given, is invoked periodically as the directory is deleted,
+  // and a final time with 'finished' set.  Like the functor passed to SubscribeToVaultEvents, it is
+  // called on the connection's thread.
+  std::future<void> RemoveVault(const NonEmptyString& label,
+                                std::function<void(VaultRemovalProgress)> on_progress = nullptr);
+
 #ifdef TESTING
   // This function sets up global variables specifying:
   // * the desired TCP listening port of the VaultManager (VM)
@@ -82,12 +147,23 @@ class ClientInterface {
   // * the path to an executable which the VM will treat as a MaidSafe vault
   // * a list of PublicPmids to allow starting a zero-state network
   //
+  // Any Pmids not available from the cache are generated in parallel.  The cache is only used if
+  // the environment variable MAIDSAFE_VAULT_MANAGER_CACHE_TEST_KEYS is set to 1, in which case the
+  // Pmids are kept in a file readable only by the current user in their app dir, and reused by
+  // later calls (including from other processes).
+  //
   // 'test_env_root_dir' must exist when this call is made or an error will be thrown.
   // The function should only be called once - further calls are no-ops.
   static void SetTestEnvironment(uint16_t test_vault_manager_port,
                                  boost::filesystem::path test_env_root_dir,
                                  boost::filesystem::path path_to_vault, int pmid_list_size);
 
+  // As above, but using the given Pmids rather than cached or newly-generated ones.
+  static void SetTestEnvironment(uint16_t test_vault_manager_port,
+                                 boost::filesystem::path test_env_root_dir,
+                                 boost::filesystem::path path_to_vault,
+                                 std::vector<passport::PmidAndSigner> pmids_and_signers);
+
 #ifdef USE_VLOGGING
   std::future<std::unique_ptr<passport::PmidAndSigner>> StartVault(
       const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
@@ -112,24 +188,62 @@ class ClientInterface {
  private:
   typedef detail::PromiseAndTimer<std::unique_ptr<passport::PmidAndSigner>, VaultStartedResponse>
       VaultRequest;
+  typedef detail::PromiseAndTimer<VaultList, ListVaultsResponse> ListVaultsRpc;
+  typedef detail::PromiseAndTimer<HostStatistics, VaultStatsResponse> HostStatisticsRpc;
+  typedef detail::PromiseAndTimer<std::vector<NonEmptyString>, UpgradeVaultsResponse>
+      UpgradeVaultsRpc;
+  struct JoinedVaultsWaiter;
+  struct RemoveVaultWaiter;
 
   std::shared_ptr<tcp::Connection> ConnectToVaultManager();
+  void HandleConnectionClosed();
   std::future<std::unique_ptr<passport::PmidAndSigner>> AddVaultRequest(
       const NonEmptyString& label);
   void HandleReceivedMessage(tcp::Message&& message);
   void HandleVaultRunningResponse(VaultRunningResponse&& vault_running_response);
+  void HandleVaultNetworkStatus(VaultNetworkStatus&& vault_network_status);
+  void HandleListVaultsResponse(ListVaultsResponse&& list_vaults_response);
+  void HandleVaultStatsResponse(VaultStatsResponse&& vault_stats_response);
+  void HandleUpgradeVaultsResponse(UpgradeVaultsResponse&& upgrade_vaults_response);
+  void HandleVaultLifecycleEvent(VaultLifecycleEvent&& vault_lifecycle_event);
+  void HandleRemoveVaultResponse(RemoveVaultResponse&& remove_vault_response);
+  void HandleRemoveVaultProgress(RemoveVaultProgress&& remove_vault_progress);
+  // Should be called with 'mutex_' locked.
+  int CountJoinedVaults(int min_network_health) const;
 #ifdef TESTING
   void HandleNetworkStableResponse();
 #endif
-  void InvokeCallBack(Challenge&& challenge, std::function<void(Challenge&&)>& callback);
+  template <typename MessageType>
+  void InvokeCallBack(MessageType&& message, std::function<void(MessageType&&)>& callback);
   void HandleLogMessage(LogMessage&& log_message);
+  // Called for each message the VaultManager may drop or coalesce, to provide it with flow control.
+  void AcknowledgeDroppableMessage();
+  void HandleSessionTicket(SessionTicket&& session_ticket);
 
   const passport::Maid kMaid_;
-  std::mutex mutex_;
+  mutable std::mutex mutex_;
   std::function<void(Challenge&&)> on_challenge_;
+  std::function<void(SessionTicket&&)> on_session_ticket_;
+  std::string session_ticket_;
   std::promise<void> network_stable_;
   std::once_flag network_stable_flag_;
   std::map<NonEmptyString, std::shared_ptr<VaultRequest>> ongoing_vault_requests_;
+  std::map<uint32_t, std::shared_ptr<ListVaultsRpc>> ongoing_list_vaults_requests_;
+  uint32_t next_list_vaults_request_id_;
+  std::map<uint32_t, std::shared_ptr<HostStatisticsRpc>> ongoing_host_statistics_requests_;
+  uint32_t next_host_statistics_request_id_;
+  std::map<uint32_t, std::shared_ptr<UpgradeVaultsRpc>> ongoing_upgrade_vaults_requests_;
+  uint32_t next_upgrade_vaults_request_id_;
+  // Keyed by vault label, values are the vault's 'joined network' flag and its network health.
+  std::map<NonEmptyString, std::pair<bool, int>> vault_network_status_;
+  std::vector<std::shared_ptr<JoinedVaultsWaiter>> joined_vaults_waiters_;
+  std::function<void(VaultEvent)> on_vault_event_;
+  std::map<NonEmptyString, std::shared_ptr<RemoveVaultWaiter>> ongoing_remove_vault_requests_;
+  // The 'on_progress' functors of removed vaults whose directories are being deleted.  Kept until
+  // the final progress report or until the connection to the VaultManager is lost.
+  std::map<NonEmptyString, std::function<void(VaultRemovalProgress)>> removal_progress_functors_;
+  // Only accessed by the connection's message handler.
+  int unacknowledged_messages_;
   AsioService asio_service_;
   asio::io_service::strand strand_;
   std::shared_ptr<tcp::Connection> tcp_connection_;
@@ -0,0 +1,68 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+enum class VaultEventType : int32_t {
+  kSpawned,        // The process has been started, or adopted from a previous VaultManager.
+  kConnected,      // The process has connected to the VaultManager.
+  kJoinedNetwork,  // The vault has joined the network.
+  kStopping,       // The VaultManager has asked the vault to stop.
+  kStopped,        // The process exited after being asked to stop.
+  kExited,         // The process exited unexpectedly.
+  kTimedOut,       // The process didn't connect, stop or answer heartbeats in time.
+  kRestarting      // The vault is being restarted after exiting unexpectedly.
+};
+
+// A lifecycle event of one of a client's vaults, as passed to the functor given to
+// ClientInterface::SubscribeToVaultEvents.
+struct VaultEvent {
+  VaultEvent()
+      : label(), type(VaultEventType::kSpawned), process_id(0), exit_code(0),
+        latency_microseconds(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(label, type, process_id, exit_code, latency_microseconds);
+  }
+
+  NonEmptyString label;
+  VaultEventType type;
+  // 0 if not yet known.
+  uint64_t process_id;
+  // Only meaningful for kStopped and kExited.
+  int32_t exit_code;
+  // For kConnected and kJoinedNetwork, the time since the process was started; for kStopped and
+  // kExited, the time since it connected (or started, if it never connected); otherwise 0.
+  int64_t latency_microseconds;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_EVENT_H_
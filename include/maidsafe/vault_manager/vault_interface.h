@@ -36,11 +36,14 @@
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/vault_manager/vault_config.h"
+#include "maidsafe/vault_manager/vault_statistics.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
+struct Challenge;
+struct HeartbeatRequest;
 struct VaultStartedResponse;
 
 class VaultInterface {
@@ -49,7 +52,16 @@ class VaultInterface {
   VaultInterface(VaultInterface&&) = delete;
   VaultInterface& operator=(VaultInterface) = delete;
 
-  explicit VaultInterface(tcp::Port vault_manager_port);
+  // If 'standby' is true, the process has been pre-started by the VaultManager as part of its pool
+  // of standby vaults, and the constructor will block until the VaultManager assigns it a config
+  // (or until kStandbyVaultTimeout expires).  Otherwise the config is expected almost immediately.
+  //
+  // Once configured, if the connection to the VaultManager is lost the vault keeps running and tries
+  // to reconnect for up to kVaultReconnectTimeout, in case the VaultManager is being restarted.  On
+  // reconnecting, the vault identifies itself by its process ID and signs a challenge using its
+  // Pmid so that the new VaultManager can adopt it.
+  explicit VaultInterface(tcp::Port vault_manager_port, bool standby = false);
+  ~VaultInterface();
 
   VaultConfig GetConfiguration();
 
@@ -58,6 +70,26 @@ class VaultInterface {
 
   void SendJoined();
 
+  // Should be called whenever routing reports a change in the routing table health.  The
+  // VaultManager forwards this to the vault's owner, e.g. to let a test network controller decide
+  // when the network has stabilised.
+  void SendNetworkHealth(int network_health);
+
+  // The VaultManager forwards these to the vault's owner, if connected.
+  void SendLogMessage(const std::string& message);
+
+  // Should be called periodically (e.g. every minute, matching the per-minute request rates).  The
+  // VaultManager keeps the latest report from each vault and aggregates them for its clients.
+  void SendStatistics(const VaultStatistics& statistics);
+
+  // By default, heartbeats from the VaultManager are answered on this interface's own thread, which
+  // only shows that the process is alive.  A vault should pass a functor which queues tasks on its
+  // main work loop, so that the replies also show the loop is making progress; if it hangs, the
+  // VaultManager restarts the vault after kMaxMissedHeartbeats.  'executor' is invoked on the
+  // interface's thread, so mustn't block.  The tasks it's given don't refer to this interface, so
+  // may safely be run after it's destroyed.
+  void SetHeartbeatExecutor(std::function<void(std::function<void()>)> executor);
+
 #ifdef TESTING
   void KillConnection();
   void SendInvalidMessage();
@@ -67,12 +99,24 @@ class VaultInterface {
  private:
   void HandleReceivedMessage(tcp::Message&& message);
   void OnConnectionClosed();
+  std::shared_ptr<tcp::Connection> Connect();
+  void Reconnect();
+  void SetExitCode(int exit_code);
 
   void HandleVaultStartedResponse(VaultStartedResponse&& vault_started_response);
   void HandleVaultShutdownRequest();
+  void HandleChallenge(Challenge&& challenge);
+  void HandleHeartbeatRequest(HeartbeatRequest&& heartbeat_request);
 
   std::promise<int> exit_code_promise_;
   std::once_flag exit_code_flag_;
+  std::mutex mutex_;
+  bool exiting_, reconnecting_;
+  // Re-sent to the VaultManager after reconnecting.
+  bool joined_network_;
+  int network_health_;
+  std::unique_ptr<VaultStatistics> statistics_;
+  std::function<void(std::function<void()>)> heartbeat_executor_;
   tcp::Port vault_manager_port_;
   std::function<void(VaultStartedResponse&&)> on_vault_started_response_;
   std::unique_ptr<VaultConfig> vault_config_;
@@ -82,6 +126,9 @@ class VaultInterface {
   // We need to ensure the connection is closed in the event of the constructor throwing, or the
   // asio_service destructor will hang.
   on_scope_exit connection_closer_;
+  // Runs Reconnect, which blocks, so can't run on 'asio_service_'.  Declared last so that a running
+  // attempt finishes before the members it uses are destroyed.
+  AsioService reconnect_service_;
 };
 
 }  // namespace vault_manager
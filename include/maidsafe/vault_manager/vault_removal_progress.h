@@ -0,0 +1,55 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_REMOVAL_PROGRESS_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_REMOVAL_PROGRESS_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Progress of the background deletion of a removed vault's directory, as passed to the functor
+// given to ClientInterface::RemoveVault.
+struct VaultRemovalProgress {
+  VaultRemovalProgress()
+      : label(), files_removed(0), bytes_removed(0), finished(false), failed(false) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(label, files_removed, bytes_removed, finished, failed);
+  }
+
+  NonEmptyString label;
+  uint64_t files_removed;
+  uint64_t bytes_removed;
+  // Set in the final report for the vault.
+  bool finished;
+  // Set in the final report if the directory couldn't be (completely) deleted, or was left in place
+  // because deleting it would have affected other data.
+  bool failed;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_REMOVAL_PROGRESS_H_
@@ -0,0 +1,80 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_STATISTICS_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_STATISTICS_H_
+
+#include <cstdint>
+#include <map>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Runtime statistics reported by a vault via VaultInterface::SendStatistics.  The rates are
+// requests per minute over the vault's most recent reporting period; the other values are current
+// totals.
+struct VaultStatistics {
+  VaultStatistics()
+      : chunks_stored(0),
+        bytes_used(0),
+        get_requests_per_minute(0),
+        put_requests_per_minute(0),
+        routing_table_size(0),
+        cache_hits(0),
+        cache_misses(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(chunks_stored, bytes_used, get_requests_per_minute, put_requests_per_minute,
+            routing_table_size, cache_hits, cache_misses);
+  }
+
+  uint64_t chunks_stored;
+  uint64_t bytes_used;
+  uint32_t get_requests_per_minute;
+  uint32_t put_requests_per_minute;
+  uint32_t routing_table_size;
+  uint64_t cache_hits;
+  uint64_t cache_misses;
+};
+
+// Statistics for all vaults run by a single VaultManager.  'vaults' holds the latest report from
+// each of the requesting client's vaults, keyed by vault label.  'totals' is the sum of the latest
+// reports from every vault on the host (whoever owns it), and 'vault_count' the number of vaults
+// which have reported; divide by this to get e.g. the mean routing table size.
+struct HostStatistics {
+  HostStatistics() : vaults(), totals(), vault_count(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vaults, totals, vault_count);
+  }
+
+  std::map<NonEmptyString, VaultStatistics> vaults;
+  VaultStatistics totals;
+  uint32_t vault_count;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_STATISTICS_H_
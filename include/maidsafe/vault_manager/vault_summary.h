@@ -0,0 +1,100 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_SUMMARY_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_SUMMARY_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+enum class ProcessStatus : int32_t { kBeforeStarted, kStarting, kRunning, kStopping };
+
+// The state of a single vault as reported by ClientInterface::ListVaults.  This deliberately holds
+// no key material; use ClientInterface::TakeOwnership to retrieve a vault's keys.
+struct VaultSummary {
+  VaultSummary()
+      : label(),
+        vault_dir(),
+        process_id(0),
+        status(ProcessStatus::kBeforeStarted),
+        joined_network(false),
+        network_health(-1),
+        heartbeat_rtt_microseconds(-1),
+        restart_count(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(label, vault_dir, process_id, status, joined_network, network_health,
+            heartbeat_rtt_microseconds, restart_count);
+  }
+
+  NonEmptyString label;
+  std::string vault_dir;
+  uint64_t process_id;
+  ProcessStatus status;
+  bool joined_network;
+  int32_t network_health;
+  // Smoothed round-trip time of the vault's heartbeats, or -1 if not yet measured.
+  int64_t heartbeat_rtt_microseconds;
+  int32_t restart_count;
+};
+
+// Selects which of the requesting client's vaults are listed.  Vaults owned by other clients are
+// never listed.  Empty 'statuses' or 'label_prefix' match any vault.  Results are ordered by label;
+// to retrieve the next page, set 'page_token' to the 'next_page_token' of the previous VaultList.
+// The VaultManager caps the page size (currently at 100 vaults); 'max_results' of 0 requests the
+// largest page allowed.
+struct ListVaultsQuery {
+  ListVaultsQuery() : statuses(), label_prefix(), page_token(), max_results(0) {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(statuses, label_prefix, page_token, max_results);
+  }
+
+  std::vector<ProcessStatus> statuses;
+  std::string label_prefix;
+  std::string page_token;
+  uint32_t max_results;
+};
+
+// One page of the results of a ListVaultsQuery.  'next_page_token' is empty on the last page.
+struct VaultList {
+  VaultList() : vaults(), next_page_token() {}
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vaults, next_page_token);
+  }
+
+  std::vector<VaultSummary> vaults;
+  std::string next_page_token;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_SUMMARY_H_
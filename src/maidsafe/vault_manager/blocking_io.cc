@@ -0,0 +1,185 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/blocking_io.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "asio/error.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/make_unique.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+struct BlockingIo::State {
+  explicit State(asio::io_service& completion_service_in)
+      : mutex(),
+        condition(),
+        completion_service(&completion_service_in),
+        running(0),
+        timer_service(),
+        pool_service() {}
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  // Reset once the BlockingIo has been destroyed, after which outcomes are discarded.
+  asio::io_service* completion_service;
+  int running;
+  // Declared first so that it outlives the timers of tasks still queued in 'pool_service'.
+  asio::io_service timer_service;
+  asio::io_service pool_service;
+};
+
+struct BlockingIo::Operation {
+  Operation(State& state_in, OnComplete on_complete_in)
+      : state(state_in),
+        mutex(),
+        timer(state_in.timer_service),
+        on_complete(std::move(on_complete_in)),
+        completed(false) {}
+
+  // Operations are only held by 'state' or by threads which share ownership of it.
+  State& state;
+  // Guards 'timer', which is used by both the pool's threads and the timer thread.
+  std::mutex mutex;
+  Timer timer;
+  OnComplete on_complete;
+  std::atomic<bool> completed;
+};
+
+BlockingIo::BlockingIo(asio::io_service& completion_service, int thread_count,
+                       std::chrono::steady_clock::duration shutdown_timeout)
+    : kShutdownTimeout_(shutdown_timeout),
+      state_(std::make_shared<State>(completion_service)),
+      work_(maidsafe::make_unique<asio::io_service::work>(state_->pool_service)),
+      timer_work_(maidsafe::make_unique<asio::io_service::work>(state_->timer_service)),
+      ordered_(state_->pool_service),
+      threads_(),
+      timer_thread_() {
+  auto state(state_);
+  for (int i(0); i < std::max(thread_count, 1); ++i)
+    threads_.emplace_back([state] { state->pool_service.run(); });
+  timer_thread_ = std::thread([state] { state->timer_service.run(); });
+}
+
+BlockingIo::~BlockingIo() {
+  work_.reset();
+  state_->pool_service.stop();
+  int running(0);
+  {
+    std::unique_lock<std::mutex> lock{state_->mutex};
+    state_->condition.wait_for(lock, kShutdownTimeout_, [this] { return state_->running == 0; });
+    running = state_->running;
+    state_->completion_service = nullptr;
+  }
+  timer_work_.reset();
+  state_->timer_service.stop();
+  timer_thread_.join();
+  if (running != 0)
+    LOG(kError) << "Abandoning " << running << " blocking I/O tasks which haven't finished.";
+  // The threads share ownership of 'state_', so can safely outlive this object.
+  for (auto& thread : threads_) {
+    if (running == 0)
+      thread.join();
+    else
+      thread.detach();
+  }
+}
+
+void BlockingIo::Run(Task task, OnComplete on_complete,
+                     std::chrono::steady_clock::duration timeout) {
+  Post(state_->pool_service, std::move(task), std::move(on_complete), timeout);
+}
+
+void BlockingIo::RunInOrder(Task task, OnComplete on_complete,
+                            std::chrono::steady_clock::duration timeout) {
+  Post(ordered_, std::move(task), std::move(on_complete), timeout);
+}
+
+template <typename Executor>
+void BlockingIo::Post(Executor& executor, Task task, OnComplete on_complete,
+                      std::chrono::steady_clock::duration timeout) {
+  auto operation(std::make_shared<Operation>(*state_, std::move(on_complete)));
+  // Bounds the time spent queued, e.g. behind a hung task in 'ordered_'.
+  StartTimer(operation, timeout);
+  executor.post([operation, task, timeout] {
+    if (operation->completed)
+      return;  // Timed out while queued.
+    State& state(operation->state);
+    {
+      std::lock_guard<std::mutex> lock{state.mutex};
+      ++state.running;
+    }
+    // Restarted so that the time spent queued isn't counted against the task itself.
+    StartTimer(operation, timeout);
+    std::exception_ptr error;
+    try {
+      task();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock{state.mutex};
+      --state.running;
+    }
+    state.condition.notify_all();
+    Complete(operation, error);
+  });
+}
+
+void BlockingIo::StartTimer(const std::shared_ptr<Operation>& operation,
+                            std::chrono::steady_clock::duration timeout) {
+  std::weak_ptr<Operation> weak_operation{operation};
+  std::lock_guard<std::mutex> lock{operation->mutex};
+  // Cancels any previous wait.
+  operation->timer.expires_from_now(timeout);
+  operation->timer.async_wait([weak_operation](const std::error_code& error_code) {
+    if (error_code == asio::error::operation_aborted)
+      return;
+    auto operation(weak_operation.lock());
+    if (!operation)
+      return;
+    LOG(kError) << "Timed out waiting for blocking I/O to complete.";
+    Complete(operation, std::make_exception_ptr(MakeError(VaultManagerErrors::timed_out)));
+  });
+}
+
+void BlockingIo::Complete(const std::shared_ptr<Operation>& operation, std::exception_ptr error) {
+  if (operation->completed.exchange(true))
+    return;
+  {
+    std::lock_guard<std::mutex> lock{operation->mutex};
+    std::error_code ignored_ec;
+    operation->timer.cancel(ignored_ec);
+  }
+  OnComplete on_complete(std::move(operation->on_complete));
+  std::lock_guard<std::mutex> lock{operation->state.mutex};
+  if (operation->state.completion_service && on_complete)
+    operation->state.completion_service->post([on_complete, error] { on_complete(error); });
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
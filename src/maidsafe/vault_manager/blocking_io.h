@@ -0,0 +1,94 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_BLOCKING_IO_H_
+#define MAIDSAFE_VAULT_MANAGER_BLOCKING_IO_H_
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Runs blocking filesystem operations on a dedicated pool of threads, so that a slow or hung disk
+// can't stall message handling on the VaultManager's asio thread.
+class BlockingIo {
+ public:
+  typedef std::function<void()> Task;
+  // Invoked with a null exception_ptr if the task succeeded, otherwise with the exception it threw
+  // or with VaultManagerErrors::timed_out.
+  typedef std::function<void(std::exception_ptr)> OnComplete;
+
+  // 'on_complete' functors are run via 'completion_service'.
+  BlockingIo(asio::io_service& completion_service, int thread_count,
+             std::chrono::steady_clock::duration shutdown_timeout = kBlockingIoTimeout);
+  // Discards tasks which haven't started and waits up to 'shutdown_timeout' for running ones to
+  // finish.  Threads still stuck after that (e.g. on a hung disk) are detached rather than joined,
+  // and the outcome of their tasks is discarded.
+  ~BlockingIo();
+  BlockingIo(const BlockingIo&) = delete;
+  BlockingIo(BlockingIo&&) = delete;
+  BlockingIo& operator=(BlockingIo) = delete;
+
+  // Runs 'task' on one of the pool's threads.  If it doesn't start within 'timeout' of being
+  // posted, it's skipped; if it doesn't finish within 'timeout' of starting, its eventual outcome
+  // is ignored (the task itself can't be interrupted).  In either case 'on_complete' is invoked
+  // with VaultManagerErrors::timed_out.
+  void Run(Task task, OnComplete on_complete,
+           std::chrono::steady_clock::duration timeout = kBlockingIoTimeout);
+  // As Run, except that tasks passed here are run one at a time, in the order given.  Tasks queued
+  // behind a hung one time out rather than waiting indefinitely.
+  void RunInOrder(Task task, OnComplete on_complete,
+                  std::chrono::steady_clock::duration timeout = kBlockingIoTimeout);
+
+ private:
+  struct Operation;
+  // Shared with the pool's threads, which may outlive this object.
+  struct State;
+
+  template <typename Executor>
+  void Post(Executor& executor, Task task, OnComplete on_complete,
+            std::chrono::steady_clock::duration timeout);
+  static void StartTimer(const std::shared_ptr<Operation>& operation,
+                         std::chrono::steady_clock::duration timeout);
+  static void Complete(const std::shared_ptr<Operation>& operation, std::exception_ptr error);
+
+  const std::chrono::steady_clock::duration kShutdownTimeout_;
+  std::shared_ptr<State> state_;
+  std::unique_ptr<asio::io_service::work> work_, timer_work_;
+  asio::io_service::strand ordered_;
+  std::vector<std::thread> threads_;
+  // Timeouts are handled on their own thread, since the pool's threads may all be stuck.
+  std::thread timer_thread_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_BLOCKING_IO_H_
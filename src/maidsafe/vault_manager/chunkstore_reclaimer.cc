@@ -0,0 +1,245 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/chunkstore_reclaimer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+// Both paths should be canonical.
+bool IsWithin(const fs::path& path, const fs::path& directory) {
+  auto path_itr(path.begin());
+  for (const auto& component : directory) {
+    if (path_itr == path.end() || *path_itr != component)
+      return false;
+    ++path_itr;
+  }
+  return true;
+}
+
+// Used to compare directories which may have been specified in different ways.
+fs::path Key(const fs::path& directory) {
+  boost::system::error_code error_code;
+  fs::path canonical_directory{fs::canonical(directory, error_code)};
+  return error_code ? fs::absolute(directory) : canonical_directory;
+}
+
+bool IsSafeToDelete(const fs::path& directory, const std::vector<fs::path>& managed_roots,
+                    const std::vector<fs::path>& protected_paths) {
+  boost::system::error_code error_code;
+  fs::path canonical_directory{fs::canonical(directory, error_code)};
+  if (error_code) {
+    LOG(kError) << "Failed to resolve " << directory << ": " << error_code.message();
+    return false;
+  }
+  if (canonical_directory.relative_path().empty()) {
+    LOG(kError) << "Refusing to delete filesystem root " << directory;
+    return false;
+  }
+  if (std::none_of(managed_roots.begin(), managed_roots.end(), [&](const fs::path& root) {
+        fs::path canonical_root{fs::canonical(root, error_code)};
+        return !error_code && canonical_root != canonical_directory &&
+               IsWithin(canonical_directory, canonical_root);
+      })) {
+    LOG(kError) << "Refusing to delete " << directory << " since it's outside the managed roots";
+    return false;
+  }
+  if (!fs::is_regular_file(canonical_directory / kReclaimableMarkerFilename, error_code)) {
+    LOG(kError) << "Refusing to delete " << directory << " since it wasn't created by the "
+                << "VaultManager";
+    return false;
+  }
+  for (const auto& protected_path : protected_paths) {
+    fs::path canonical_path{fs::canonical(protected_path, error_code)};
+    if (!error_code && IsWithin(canonical_path, canonical_directory)) {
+      LOG(kError) << "Refusing to delete " << directory << " since it contains " << protected_path;
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // unnamed namespace
+
+ChunkstoreReclaimer::ChunkstoreReclaimer(std::vector<fs::path> managed_roots,
+                                         GetProtectedPaths get_protected_paths,
+                                         int unlinks_per_second,
+                                         std::chrono::steady_clock::duration progress_interval)
+    : kManagedRoots_(std::move(managed_roots)),
+      kGetProtectedPaths_(std::move(get_protected_paths)),
+      kUnlinkInterval_(std::chrono::microseconds(1000000 / std::max(unlinks_per_second, 1))),
+      kProgressInterval_(progress_interval),
+      mutex_(),
+      condition_(),
+      jobs_(),
+      reclaiming_(),
+      stopping_(false),
+      next_unlink_(),
+      thread_([this] { Run(); }) {}
+
+ChunkstoreReclaimer::~ChunkstoreReclaimer() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+  }
+  condition_.notify_one();
+  thread_.join();
+}
+
+void ChunkstoreReclaimer::Reclaim(NonEmptyString label, fs::path directory,
+                                  OnProgress on_progress) {
+  Job job;
+  job.key = Key(directory);
+  job.directory = std::move(directory);
+  job.on_progress = std::move(on_progress);
+  job.progress.label = std::move(label);
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    reclaiming_.push_back(job.key);
+    jobs_.push_back(std::move(job));
+  }
+  condition_.notify_one();
+}
+
+bool ChunkstoreReclaimer::IsReclaiming(const fs::path& directory) {
+  fs::path key{Key(directory)};
+  std::lock_guard<std::mutex> lock{mutex_};
+  return std::find(reclaiming_.begin(), reclaiming_.end(), key) != reclaiming_.end();
+}
+
+void ChunkstoreReclaimer::Run() {
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock{mutex_};
+      condition_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+      if (stopping_)
+        return;
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    if (!Delete(job))
+      return;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      reclaiming_.erase(std::find(reclaiming_.begin(), reclaiming_.end(), job.key));
+    }
+    job.progress.finished = true;
+    if (job.on_progress)
+      job.on_progress(job.progress);
+  }
+}
+
+bool ChunkstoreReclaimer::Delete(Job& job) {
+  LOG(kInfo) << "Deleting " << job.directory << " of removed vault " << job.progress.label;
+  job.last_reported = std::chrono::steady_clock::now();
+  try {
+    boost::system::error_code error_code;
+    if (!fs::exists(job.directory, error_code))
+      return true;
+    // Fetched now rather than when queued, since a vault may have been started in the meantime.
+    std::vector<fs::path> protected_paths;
+    if (!FetchProtectedPaths(protected_paths))
+      return false;
+    if (!IsSafeToDelete(job.directory, kManagedRoots_, protected_paths)) {
+      job.progress.failed = true;
+    } else if (!DeleteTree(job.directory, job)) {
+      LOG(kWarning) << "Stopped while deleting " << job.directory << "; "
+                    << job.progress.files_removed << " files were deleted.";
+      return false;
+    }
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to delete " << job.directory << ": " << boost::diagnostic_information(e);
+    job.progress.failed = true;
+  }
+  return true;
+}
+
+bool ChunkstoreReclaimer::FetchProtectedPaths(std::vector<fs::path>& protected_paths) {
+  if (!kGetProtectedPaths_)
+    return true;
+  auto future(kGetProtectedPaths_());
+  // The provider may depend on a thread which is stopped before this one.
+  while (future.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (stopping_)
+      return false;
+  }
+  protected_paths = future.get();
+  return true;
+}
+
+bool ChunkstoreReclaimer::DeleteTree(const fs::path& directory, Job& job) {
+  // Listed up front, since deleting entries would otherwise invalidate the iteration.
+  std::vector<fs::path> entries;
+  for (fs::directory_iterator itr(directory), end; itr != end; ++itr)
+    entries.push_back(itr->path());
+  for (const auto& entry : entries) {
+    auto status(fs::symlink_status(entry));
+    if (fs::is_directory(status)) {
+      if (!DeleteTree(entry, job))
+        return false;
+      continue;
+    }
+    if (!Throttle())
+      return false;
+    std::uintmax_t size(fs::is_regular_file(status) ? fs::file_size(entry) : 0);
+    fs::remove(entry);
+    ++job.progress.files_removed;
+    job.progress.bytes_removed += size;
+    auto now(std::chrono::steady_clock::now());
+    if (job.on_progress && now - job.last_reported >= kProgressInterval_) {
+      job.on_progress(job.progress);
+      job.last_reported = now;
+    }
+  }
+  fs::remove(directory);
+  return true;
+}
+
+bool ChunkstoreReclaimer::Throttle() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  if (condition_.wait_until(lock, next_unlink_, [this] { return stopping_; }))
+    return false;
+  next_unlink_ = std::max(next_unlink_, std::chrono::steady_clock::now()) + kUnlinkInterval_;
+  return true;
+}
+
+void MarkAsReclaimable(const fs::path& directory) {
+  if (!WriteFile(directory / kReclaimableMarkerFilename, std::string()))
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
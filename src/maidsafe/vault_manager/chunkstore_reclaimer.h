@@ -0,0 +1,115 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_CHUNKSTORE_RECLAIMER_H_
+#define MAIDSAFE_VAULT_MANAGER_CHUNKSTORE_RECLAIMER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_removal_progress.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Deletes the directories of removed vaults on a dedicated thread, one directory at a time.  Files
+// are unlinked at a limited rate, since deleting a large chunkstore flat out would starve the
+// remaining vaults on the same disk of I/O.
+//
+// Since a vault's directory may have been chosen by its client, a directory is only deleted if it
+// lies within one of 'managed_roots' and was marked by 'MarkAsReclaimable' when it was created.
+class ChunkstoreReclaimer {
+ public:
+  // Invoked on the reclaimer's thread, so shouldn't block.
+  typedef std::function<void(VaultRemovalProgress)> OnProgress;
+  // Invoked on the reclaimer's thread as each deletion starts.  Should provide the current set of
+  // paths which mustn't be deleted (e.g. the directories of all live vaults).
+  typedef std::function<std::future<std::vector<boost::filesystem::path>>()> GetProtectedPaths;
+
+  ChunkstoreReclaimer(
+      std::vector<boost::filesystem::path> managed_roots, GetProtectedPaths get_protected_paths,
+      int unlinks_per_second = kMaxReclaimUnlinksPerSecond,
+      std::chrono::steady_clock::duration progress_interval = kReclaimProgressInterval);
+  // Stops after the current unlink, leaving any remaining files in place.
+  ~ChunkstoreReclaimer();
+  ChunkstoreReclaimer(const ChunkstoreReclaimer&) = delete;
+  ChunkstoreReclaimer(ChunkstoreReclaimer&&) = delete;
+  ChunkstoreReclaimer& operator=(ChunkstoreReclaimer) = delete;
+
+  // Queues 'directory' for deletion.  'on_progress' is invoked at most every 'progress_interval'
+  // while it's being deleted, then once with 'finished' set.  'directory' is left in place (and
+  // reported as 'failed') if it isn't reclaimable as described above, or if it contains any of the
+  // protected paths when its deletion starts.
+  void Reclaim(NonEmptyString label, boost::filesystem::path directory, OnProgress on_progress);
+
+  // Returns true if 'directory' is queued for deletion or is being deleted.  No vault should be
+  // started in such a directory.
+  bool IsReclaiming(const boost::filesystem::path& directory);
+
+ private:
+  struct Job {
+    boost::filesystem::path directory, key;
+    OnProgress on_progress;
+    VaultRemovalProgress progress;
+    std::chrono::steady_clock::time_point last_reported;
+  };
+
+  void Run();
+  // Returns false if stopped before finishing.
+  bool Delete(Job& job);
+  // Returns false if stopped before the protected paths were provided.
+  bool FetchProtectedPaths(std::vector<boost::filesystem::path>& protected_paths);
+  // Returns false if stopped before finishing.
+  bool DeleteTree(const boost::filesystem::path& directory, Job& job);
+  // Waits until the next unlink is allowed.  Returns false if stopped while waiting.
+  bool Throttle();
+
+  const std::vector<boost::filesystem::path> kManagedRoots_;
+  const GetProtectedPaths kGetProtectedPaths_;
+  const std::chrono::steady_clock::duration kUnlinkInterval_, kProgressInterval_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<Job> jobs_;
+  // Keys of the queued jobs and the one being run.
+  std::vector<boost::filesystem::path> reclaiming_;
+  bool stopping_;
+  std::chrono::steady_clock::time_point next_unlink_;
+  std::thread thread_;
+};
+
+// Writes the marker which allows 'directory' to be deleted by a ChunkstoreReclaimer.  Should only
+// be called for a directory which the VaultManager has itself just created.
+void MarkAsReclaimable(const boost::filesystem::path& directory);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_CHUNKSTORE_RECLAIMER_H_
@@ -18,21 +18,86 @@
 
 #include "maidsafe/vault_manager/client_connections.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "boost/exception/diagnostic_information.hpp"
+#include "cryptopp/hmac.h"
+#include "cryptopp/sha.h"
+
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/tcp/connection.h"
 
+#include "maidsafe/vault_manager/tracing.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/log_message.h"
+
 namespace maidsafe {
 
 namespace vault_manager {
 
-ClientConnections::ClientConnections(asio::io_service& io_service)
-    : io_service_(io_service), unvalidated_clients_(), clients_() {}
+namespace {
+
+typedef CryptoPP::HMAC<CryptoPP::SHA256> TicketMac;
+
+// Ticket layout: client name | expiry | nonce | MAC of the preceding fields.
+const std::size_t kNameSize(64), kExpirySize(8), kNonceSize(16);
+const std::size_t kNonceOffset(kNameSize + kExpirySize);
+const std::size_t kMacOffset(kNonceOffset + kNonceSize);
+const std::size_t kTicketSize(kMacOffset + TicketMac::DIGESTSIZE);
+
+std::string CalculateMac(const std::string& key, const std::string& data) {
+  TicketMac mac(reinterpret_cast<const unsigned char*>(key.data()), key.size());
+  std::string digest(TicketMac::DIGESTSIZE, 0);
+  mac.CalculateDigest(reinterpret_cast<unsigned char*>(&digest[0]),
+                      reinterpret_cast<const unsigned char*>(data.data()), data.size());
+  return digest;
+}
+
+std::string EncodeExpiry(std::chrono::steady_clock::time_point expiry) {
+  auto ticks(static_cast<std::uint64_t>(expiry.time_since_epoch().count()));
+  std::string encoded(kExpirySize, 0);
+  for (std::size_t i(0); i < kExpirySize; ++i)
+    encoded[i] = static_cast<char>((ticks >> (8 * i)) & 0xFF);
+  return encoded;
+}
 
-std::shared_ptr<ClientConnections> ClientConnections::MakeShared(asio::io_service& io_service) {
-  return std::shared_ptr<ClientConnections>{new ClientConnections{io_service}};
+std::chrono::steady_clock::time_point DecodeExpiry(const std::string& encoded) {
+  std::uint64_t ticks(0);
+  for (std::size_t i(0); i < kExpirySize; ++i)
+    ticks |= static_cast<std::uint64_t>(static_cast<unsigned char>(encoded[i])) << (8 * i);
+  return std::chrono::steady_clock::time_point(
+      std::chrono::steady_clock::duration(static_cast<std::chrono::steady_clock::rep>(ticks)));
+}
+
+}  // unnamed namespace
+
+ClientConnections::ClientConnections(asio::io_service& io_service, int max_pending_connections,
+                                     int validation_rate, int validation_burst)
+    : io_service_(io_service),
+      kMaxPendingConnections_(max_pending_connections),
+      kValidationRate_(validation_rate),
+      kValidationBurst_(validation_burst),
+      validation_tokens_(validation_burst),
+      last_validation_request_(std::chrono::steady_clock::now()),
+      rejected_count_(0),
+      unvalidated_clients_(),
+      clients_(),
+      kTicketKey_(RandomString(TicketMac::DEFAULT_KEYLENGTH)),
+      used_ticket_nonces_(),
+      flow_control_(),
+      vault_event_subscribers_() {}
+
+std::shared_ptr<ClientConnections> ClientConnections::MakeShared(asio::io_service& io_service,
+                                                                 int max_pending_connections,
+                                                                 int validation_rate,
+                                                                 int validation_burst) {
+  return std::shared_ptr<ClientConnections>{new ClientConnections{
+      io_service, max_pending_connections, validation_rate, validation_burst}};
 }
 
 ClientConnections::~ClientConnections() {
@@ -41,6 +106,14 @@ ClientConnections::~ClientConnections() {
 
 void ClientConnections::Add(tcp::ConnectionPtr connection, const asymm::PlainText& challenge) {
   assert(clients_.find(connection) == std::end(clients_));
+  if (!AdmitForValidation()) {
+    // Only log occasionally, since a connection storm would otherwise flood the log too.
+    if (rejected_count_++ % 100 == 0) {
+      LOG(kWarning) << "Rejecting Client TCP connection (" << rejected_count_ << " so far); "
+                    << unvalidated_clients_.size() << " clients are awaiting validation.";
+    }
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::cannot_exceed_limit));
+  }
   TimerPtr timer{std::make_shared<Timer>(io_service_, kRpcTimeout)};
   timer->async_wait([=](const std::error_code& error_code) {
     if (!error_code || error_code != asio::error::operation_aborted) {
@@ -53,6 +126,20 @@ void ClientConnections::Add(tcp::ConnectionPtr connection, const asymm::PlainTex
   static_cast<void>(result);
 }
 
+bool ClientConnections::AdmitForValidation() {
+  if (static_cast<int>(unvalidated_clients_.size()) >= kMaxPendingConnections_)
+    return false;
+  const auto kNow(std::chrono::steady_clock::now());
+  const std::chrono::duration<double> kElapsed(kNow - last_validation_request_);
+  last_validation_request_ = kNow;
+  validation_tokens_ = std::min(static_cast<double>(kValidationBurst_),
+                                validation_tokens_ + kElapsed.count() * kValidationRate_);
+  if (validation_tokens_ < 1.0)
+    return false;
+  validation_tokens_ -= 1.0;
+  return true;
+}
+
 void ClientConnections::Validate(tcp::ConnectionPtr connection, const passport::PublicMaid& maid,
                                  const asymm::Signature& signature) {
   auto itr(unvalidated_clients_.find(connection));
@@ -63,7 +150,12 @@ void ClientConnections::Validate(tcp::ConnectionPtr connection, const passport::
 
   on_scope_exit cleanup{[this, itr] { itr->first->Close(); }};
 
-  if (asymm::CheckSignature(itr->second.first, signature, maid.public_key())) {
+  bool valid_signature(false);
+  {
+    VAULT_MANAGER_TRACE_SPAN("asymm::CheckSignature");
+    valid_signature = asymm::CheckSignature(itr->second.first, signature, maid.public_key());
+  }
+  if (valid_signature) {
     LOG(kSuccess) << "Client " << maid.Name() << " TCP connection validated.";
   } else {
     LOG(kError) << "Client TCP connection validation failed.";
@@ -77,10 +169,65 @@ void ClientConnections::Validate(tcp::ConnectionPtr connection, const passport::
   static_cast<void>(result);
 }
 
+std::string ClientConnections::IssueTicket(tcp::ConnectionPtr connection) {
+  std::string ticket(FindValidated(connection).string());
+  ticket += EncodeExpiry(std::chrono::steady_clock::now() + kSessionTicketLifetime);
+  ticket += RandomString(kNonceSize);
+  ticket += CalculateMac(kTicketKey_, ticket);
+  assert(ticket.size() == kTicketSize);
+  return ticket;
+}
+
+ClientConnections::MaidName ClientConnections::Resume(tcp::ConnectionPtr connection,
+                                                      const std::string& ticket) {
+  VAULT_MANAGER_TRACE_SPAN("ClientConnections::Resume");
+  auto itr(unvalidated_clients_.find(connection));
+  if (itr == std::end(unvalidated_clients_)) {
+    LOG(kError) << "Unvalidated Client TCP connection not found.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::connection_not_found));
+  }
+
+  if (ticket.size() != kTicketSize ||
+      !TicketMac(reinterpret_cast<const unsigned char*>(kTicketKey_.data()), kTicketKey_.size())
+           .VerifyDigest(reinterpret_cast<const unsigned char*>(&ticket[kMacOffset]),
+                         reinterpret_cast<const unsigned char*>(ticket.data()), kMacOffset)) {
+    LOG(kWarning) << "Client presented an invalid session ticket.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+
+  const auto kNow(std::chrono::steady_clock::now());
+  auto nonce_itr(std::begin(used_ticket_nonces_));
+  while (nonce_itr != std::end(used_ticket_nonces_)) {
+    if (nonce_itr->second < kNow)
+      nonce_itr = used_ticket_nonces_.erase(nonce_itr);
+    else
+      ++nonce_itr;
+  }
+  const auto kExpiry(DecodeExpiry(ticket.substr(kNameSize, kExpirySize)));
+  if (kExpiry < kNow) {
+    LOG(kInfo) << "Client presented an expired session ticket.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  if (!used_ticket_nonces_.emplace(ticket.substr(kNonceOffset, kNonceSize), kExpiry).second) {
+    LOG(kWarning) << "Client presented a session ticket which has already been used.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+
+  MaidName maid_name(ticket.substr(0, kNameSize));
+  LOG(kSuccess) << "Client " << maid_name << " TCP connection validated by session ticket.";
+  bool result{clients_.emplace(connection, maid_name).second};
+  unvalidated_clients_.erase(itr);
+  assert(result);
+  static_cast<void>(result);
+  return maid_name;
+}
+
 bool ClientConnections::Remove(tcp::ConnectionPtr connection) {
   auto itr(clients_.find(connection));
   if (itr != std::end(clients_)) {
     clients_.erase(itr);
+    flow_control_.erase(connection);
+    vault_event_subscribers_.erase(connection);
     return true;
   }
 
@@ -93,6 +240,74 @@ bool ClientConnections::Remove(tcp::ConnectionPtr connection) {
   return false;
 }
 
+void ClientConnections::DoSendDroppable(tcp::ConnectionPtr connection, tcp::Message message,
+                                        const std::string& coalesce_key) {
+  if (clients_.find(connection) == std::end(clients_))
+    return;
+  FlowControl& flow_control(flow_control_[connection]);
+  if (flow_control.unacknowledged >= kMaxUnacknowledgedMessages) {
+    if (coalesce_key.empty())
+      ++flow_control.dropped;
+    else
+      flow_control.coalesced[coalesce_key] = std::move(message);
+    return;
+  }
+  // Anything pending for this key is superseded.
+  if (!coalesce_key.empty())
+    flow_control.coalesced.erase(coalesce_key);
+  try {
+    connection->Send(std::move(message));
+    ++flow_control.unacknowledged;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to send to client: " << boost::diagnostic_information(e);
+  }
+}
+
+void ClientConnections::HandleFlowControlAck(tcp::ConnectionPtr connection,
+                                             uint32_t message_count) {
+  auto itr(flow_control_.find(connection));
+  if (itr == std::end(flow_control_))
+    return;
+  itr->second.unacknowledged =
+      std::max(0, itr->second.unacknowledged - static_cast<int>(message_count));
+  SendPending(connection, itr->second);
+}
+
+void ClientConnections::SendPending(tcp::ConnectionPtr connection, FlowControl& flow_control) {
+  try {
+    while (flow_control.unacknowledged < kMaxUnacknowledgedMessages &&
+           !flow_control.coalesced.empty()) {
+      connection->Send(std::move(std::begin(flow_control.coalesced)->second));
+      flow_control.coalesced.erase(std::begin(flow_control.coalesced));
+      ++flow_control.unacknowledged;
+    }
+    if (flow_control.dropped != 0 && flow_control.unacknowledged < kMaxUnacknowledgedMessages) {
+      Send(connection, LogMessage("VaultManager dropped " + std::to_string(flow_control.dropped) +
+                                  " log messages since this client was too slow to receive them."));
+      flow_control.dropped = 0;
+      ++flow_control.unacknowledged;
+    }
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to send to client: " << boost::diagnostic_information(e);
+  }
+}
+
+void ClientConnections::SetSubscribedToVaultEvents(tcp::ConnectionPtr connection,
+                                                   bool subscribed) {
+  if (clients_.find(connection) == std::end(clients_)) {
+    LOG(kError) << "Validated Client TCP connection not found.";
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::connection_not_found));
+  }
+  if (subscribed)
+    vault_event_subscribers_.insert(connection);
+  else
+    vault_event_subscribers_.erase(connection);
+}
+
+bool ClientConnections::IsSubscribedToVaultEvents(tcp::ConnectionPtr connection) const {
+  return vault_event_subscribers_.count(connection) != 0;
+}
+
 void ClientConnections::CloseAll() {
   for (auto connection : unvalidated_clients_)
     connection.first->Close();
@@ -101,6 +316,7 @@ void ClientConnections::CloseAll() {
 }
 
 ClientConnections::MaidName ClientConnections::FindValidated(tcp::ConnectionPtr connection) const {
+  VAULT_MANAGER_TRACE_SPAN("ClientConnections::FindValidated");
   auto itr(clients_.find(connection));
   if (itr == std::end(clients_)) {
     auto unvalidated_itr(unvalidated_clients_.find(connection));
@@ -116,6 +332,7 @@ ClientConnections::MaidName ClientConnections::FindValidated(tcp::ConnectionPtr
 }
 
 tcp::ConnectionPtr ClientConnections::FindValidated(MaidName maid_name) const {
+  VAULT_MANAGER_TRACE_SPAN("ClientConnections::FindValidated");
   auto itr(std::find_if(std::begin(clients_), std::end(clients_),
                         [&maid_name](const std::pair<tcp::ConnectionPtr, MaidName> client) {
     return client.second == maid_name;
@@ -19,8 +19,12 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CLIENT_CONNECTIONS_H_
 #define MAIDSAFE_VAULT_MANAGER_CLIENT_CONNECTIONS_H_
 
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -28,6 +32,8 @@
 
 #include "maidsafe/common/identity.h"
 #include "maidsafe/common/rsa.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/vault_manager/config.h"
@@ -39,26 +45,82 @@ namespace vault_manager {
 class ClientConnections {
  public:
   using MaidName = Identity;
-  static std::shared_ptr<ClientConnections> MakeShared(asio::io_service& io_service);
+  static std::shared_ptr<ClientConnections> MakeShared(
+      asio::io_service& io_service, int max_pending_connections = kMaxPendingConnections,
+      int validation_rate = kClientValidationRate, int validation_burst = kClientValidationBurst);
   ~ClientConnections();
+  // Throws CommonErrors::cannot_exceed_limit if 'max_pending_connections' clients are already
+  // awaiting validation, or if clients are asking to be validated faster than 'validation_rate' per
+  // second (with bursts of up to 'validation_burst').
   void Add(tcp::ConnectionPtr connection, const asymm::PlainText& challenge);
   void Validate(tcp::ConnectionPtr connection, const passport::PublicMaid& maid,
                 const asymm::Signature& signature);
+  // Returns a ticket which the validated client on 'connection' can later pass to Resume on a new
+  // connection instead of signing the challenge.  Tickets are MAC'd with a key held only by this
+  // instance, expire after kSessionTicketLifetime and can only be used once.
+  std::string IssueTicket(tcp::ConnectionPtr connection);
+  // Validates the unvalidated 'connection' using a ticket from IssueTicket, returning the client's
+  // name.  If the ticket is rejected, the connection is left unvalidated (and open) so that the
+  // client can still answer its challenge.
+  MaidName Resume(tcp::ConnectionPtr connection, const std::string& ticket);
   bool Remove(tcp::ConnectionPtr connection);
+  // Sends a message which the validated client on 'connection' can afford to miss, subject to
+  // flow control (see kMaxUnacknowledgedMessages).  If the client is too far behind, the message is
+  // dropped if 'coalesce_key' is empty; otherwise it replaces any pending message with the same key
+  // and is sent once the client catches up.  Doesn't throw.
+  template <typename T>
+  void SendDroppable(tcp::ConnectionPtr connection, T message,
+                     const std::string& coalesce_key = std::string());
+  // Handles the client acknowledging receipt of 'message_count' droppable messages.  Pending
+  // coalesced messages are then sent, followed by a LogMessage reporting how many were dropped.
+  void HandleFlowControlAck(tcp::ConnectionPtr connection, uint32_t message_count);
+  // Records whether the validated client on 'connection' wants VaultLifecycleEvents.  Clients
+  // aren't subscribed until they ask to be.  Throws if 'connection' isn't validated.
+  void SetSubscribedToVaultEvents(tcp::ConnectionPtr connection, bool subscribed);
+  bool IsSubscribedToVaultEvents(tcp::ConnectionPtr connection) const;
   void CloseAll();
   MaidName FindValidated(tcp::ConnectionPtr connection) const;
   tcp::ConnectionPtr FindValidated(MaidName maid_name) const;
   std::vector<tcp::ConnectionPtr> GetAll() const;
 
  private:
-  explicit ClientConnections(asio::io_service& io_service);
+  ClientConnections(asio::io_service& io_service, int max_pending_connections,
+                    int validation_rate, int validation_burst);
+
+  struct FlowControl {
+    FlowControl() : unacknowledged(0), dropped(0), coalesced() {}
+    int unacknowledged;
+    uint64_t dropped;
+    std::map<std::string, tcp::Message> coalesced;
+  };
+
+  void DoSendDroppable(tcp::ConnectionPtr connection, tcp::Message message,
+                       const std::string& coalesce_key);
+  void SendPending(tcp::ConnectionPtr connection, FlowControl& flow_control);
+  bool AdmitForValidation();
 
   asio::io_service& io_service_;
+  const int kMaxPendingConnections_, kValidationRate_, kValidationBurst_;
+  // Token bucket for the validation rate limit.
+  double validation_tokens_;
+  std::chrono::steady_clock::time_point last_validation_request_;
+  std::uint64_t rejected_count_;
   std::map<tcp::ConnectionPtr, std::pair<asymm::PlainText, TimerPtr>,
            std::owner_less<tcp::ConnectionPtr>> unvalidated_clients_;
   std::map<tcp::ConnectionPtr, MaidName, std::owner_less<tcp::ConnectionPtr>> clients_;
+  const std::string kTicketKey_;
+  // Nonces of resumed tickets which haven't yet expired, with their expiry times.
+  std::map<std::string, std::chrono::steady_clock::time_point> used_ticket_nonces_;
+  std::map<tcp::ConnectionPtr, FlowControl, std::owner_less<tcp::ConnectionPtr>> flow_control_;
+  std::set<tcp::ConnectionPtr, std::owner_less<tcp::ConnectionPtr>> vault_event_subscribers_;
 };
 
+template <typename T>
+void ClientConnections::SendDroppable(tcp::ConnectionPtr connection, T message,
+                                      const std::string& coalesce_key) {
+  DoSendDroppable(connection, Serialise(T::tag, std::move(message)), coalesce_key);
+}
+
 }  // namespace vault_manager
 
 }  // namespace maidsafe
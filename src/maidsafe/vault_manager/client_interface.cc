@@ -18,6 +18,9 @@
 
 #include "maidsafe/vault_manager/client_interface.h"
 
+#include <algorithm>
+#include <system_error>
+
 #include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/config.h"
@@ -28,24 +31,83 @@
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/flow_control_ack.h"
+#include "maidsafe/vault_manager/messages/list_vaults_request.h"
+#include "maidsafe/vault_manager/messages/list_vaults_response.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/network_stable_request.h"
+#include "maidsafe/vault_manager/messages/remove_vault_progress.h"
+#include "maidsafe/vault_manager/messages/remove_vault_request.h"
+#include "maidsafe/vault_manager/messages/remove_vault_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/set_network_as_stable.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/upgrade_vaults_request.h"
+#include "maidsafe/vault_manager/messages/upgrade_vaults_response.h"
 #include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_events_subscription.h"
+#include "maidsafe/vault_manager/messages/vault_lifecycle_event.h"
+#include "maidsafe/vault_manager/messages/vault_network_status.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
+#include "maidsafe/vault_manager/messages/vault_stats_request.h"
+#include "maidsafe/vault_manager/messages/vault_stats_response.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
-ClientInterface::ClientInterface(const passport::Maid& maid)
+struct ClientInterface::JoinedVaultsWaiter {
+  JoinedVaultsWaiter(asio::io_service& io_service, int vault_count_in, int min_network_health_in,
+                     const std::chrono::steady_clock::duration& timeout)
+      : vault_count(vault_count_in),
+        min_network_health(min_network_health_in),
+        promise(),
+        timer(io_service, timeout) {}
+
+  const int vault_count;
+  const int min_network_health;
+  std::promise<void> promise;
+  Timer timer;
+};
+
+struct ClientInterface::RemoveVaultWaiter {
+  RemoveVaultWaiter(asio::io_service& io_service,
+                    std::function<void(VaultRemovalProgress)> on_progress_in)
+      : promise(),
+        timer(io_service, kVaultStopTimeout + kRpcTimeout),
+        on_progress(std::move(on_progress_in)),
+        responded(false) {}
+
+  std::promise<void> promise;
+  Timer timer;
+  std::function<void(VaultRemovalProgress)> on_progress;
+  // Set once 'promise' has been satisfied, by the response or by timing out.
+  bool responded;
+};
+
+ClientInterface::ClientInterface(const passport::Maid& maid, std::string session_ticket)
     : kMaid_(maid),
       mutex_(),
       on_challenge_(),
+      on_session_ticket_(),
+      session_ticket_(),
       network_stable_(),
       network_stable_flag_(),
+      ongoing_vault_requests_(),
+      ongoing_list_vaults_requests_(),
+      next_list_vaults_request_id_(0),
+      ongoing_host_statistics_requests_(),
+      next_host_statistics_request_id_(0),
+      ongoing_upgrade_vaults_requests_(),
+      next_upgrade_vaults_request_id_(0),
+      vault_network_status_(),
+      joined_vaults_waiters_(),
+      on_vault_event_(),
+      ongoing_remove_vault_requests_(),
+      removal_progress_functors_(),
+      unacknowledged_messages_(0),
       asio_service_(1),
       strand_(asio_service_.service()),
       tcp_connection_(ConnectToVaultManager()),
@@ -53,8 +115,19 @@ ClientInterface::ClientInterface(const passport::Maid& maid)
   Send(tcp_connection_, ValidateConnectionRequest());
   auto challenge = SetResponseCallback<std::unique_ptr<asymm::PlainText>, Challenge>(
                        on_challenge_, asio_service_.service(), mutex_).get();
+  if (!session_ticket.empty()) {
+    auto resumed = SetResponseCallback<std::string, SessionTicket>(
+        on_session_ticket_, asio_service_.service(), mutex_);
+    Send(tcp_connection_, ResumeSessionRequest(std::move(session_ticket)));
+    if (!resumed.get().empty())
+      return;
+    LOG(kInfo) << "Session ticket rejected; validating by signing challenge instead.";
+  }
+  auto validated = SetResponseCallback<std::string, SessionTicket>(
+      on_session_ticket_, asio_service_.service(), mutex_);
   Send(tcp_connection_, ChallengeResponse(passport::PublicMaid(kMaid_),
                                           asymm::Sign(*challenge, kMaid_.private_key())));
+  validated.get();
 }
 
 ClientInterface::~ClientInterface() {
@@ -64,6 +137,11 @@ ClientInterface::~ClientInterface() {
 #endif
 }
 
+std::string ClientInterface::GetSessionTicket() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return session_ticket_;
+}
+
 std::shared_ptr<tcp::Connection> ClientInterface::ConnectToVaultManager() {
   unsigned attempts{0};
   tcp::Port initial_port{GetInitialListeningPort()};
@@ -74,7 +152,7 @@ std::shared_ptr<tcp::Connection> ClientInterface::ConnectToVaultManager() {
       tcp::ConnectionPtr tcp_connection{tcp::Connection::MakeShared(strand_, port)};
       tcp_connection->Start(
           [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
-          [this] {});  // FIXME OnConnectionClosed
+          [this] { HandleConnectionClosed(); });
       LOG(kSuccess) << "Connected to VaultManager which is listening on port " << port;
       return tcp_connection;
     } catch (const std::exception&) {
@@ -87,6 +165,21 @@ std::shared_ptr<tcp::Connection> ClientInterface::ConnectToVaultManager() {
   BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::failed_to_connect));
 }
 
+void ClientInterface::HandleConnectionClosed() {
+  LOG(kWarning) << "Connection to VaultManager closed.";
+  std::lock_guard<std::mutex> lock{mutex_};
+  // No further responses or progress reports can arrive.
+  for (const auto& request : ongoing_remove_vault_requests_) {
+    request.second->responded = true;
+    std::error_code ignored_ec;
+    request.second->timer.cancel(ignored_ec);
+    request.second->promise.set_exception(
+        std::make_exception_ptr(MakeError(VaultManagerErrors::connection_aborted)));
+  }
+  ongoing_remove_vault_requests_.clear();
+  removal_progress_functors_.clear();
+}
+
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::TakeOwnership(
     const NonEmptyString& label, const boost::filesystem::path& vault_dir,
     DiskUsage max_disk_usage) {
@@ -113,6 +206,171 @@ std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVaul
 }
 #endif
 
+std::future<std::vector<NonEmptyString>> ClientInterface::UpgradeVaults(
+    const boost::filesystem::path& vault_executable_path, int batch_size,
+    const std::chrono::steady_clock::duration& timeout) {
+  auto request(std::make_shared<UpgradeVaultsRpc>(asio_service_.service(), timeout));
+  std::future<std::vector<NonEmptyString>> future{request->promise.get_future()};
+  uint32_t request_id{0};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    request_id = next_upgrade_vaults_request_id_++;
+    ongoing_upgrade_vaults_requests_.insert(std::make_pair(request_id, request));
+  }
+  request->timer.async_wait([request, request_id, this](const std::error_code& ec) {
+    if (ec && ec == asio::error::operation_aborted)
+      return;
+    LOG(kWarning) << "Timed out waiting for upgrade vaults response " << request_id;
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (ec)
+      request->SetException(ec);
+    else
+      request->SetException(MakeError(VaultManagerErrors::timed_out));
+    ongoing_upgrade_vaults_requests_.erase(request_id);
+  });
+  Send(tcp_connection_, UpgradeVaultsRequest(request_id, vault_executable_path, batch_size));
+  return future;
+}
+
+std::future<HostStatistics> ClientInterface::GetHostStatistics() {
+  auto request(std::make_shared<HostStatisticsRpc>(asio_service_.service()));
+  std::future<HostStatistics> future{request->promise.get_future()};
+  uint32_t request_id{0};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    request_id = next_host_statistics_request_id_++;
+    ongoing_host_statistics_requests_.insert(std::make_pair(request_id, request));
+  }
+  request->timer.async_wait([request, request_id, this](const std::error_code& ec) {
+    if (ec && ec == asio::error::operation_aborted)
+      return;
+    LOG(kWarning) << "Timed out waiting for host statistics response " << request_id;
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (ec)
+      request->SetException(ec);
+    else
+      request->SetException(MakeError(VaultManagerErrors::timed_out));
+    ongoing_host_statistics_requests_.erase(request_id);
+  });
+  Send(tcp_connection_, VaultStatsRequest(request_id));
+  return future;
+}
+
+std::future<VaultList> ClientInterface::ListVaults(ListVaultsQuery query) {
+  auto request(std::make_shared<ListVaultsRpc>(asio_service_.service()));
+  std::future<VaultList> future{request->promise.get_future()};
+  uint32_t request_id{0};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    request_id = next_list_vaults_request_id_++;
+    ongoing_list_vaults_requests_.insert(std::make_pair(request_id, request));
+  }
+  request->timer.async_wait([request, request_id, this](const std::error_code& ec) {
+    if (ec && ec == asio::error::operation_aborted)
+      return;
+    LOG(kWarning) << "Timed out waiting for list vaults response " << request_id;
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (ec)
+      request->SetException(ec);
+    else
+      request->SetException(MakeError(VaultManagerErrors::timed_out));
+    ongoing_list_vaults_requests_.erase(request_id);
+  });
+  Send(tcp_connection_, ListVaultsRequest(request_id, std::move(query)));
+  return future;
+}
+
+std::future<VaultSummary> ClientInterface::GetVaultStatus(const NonEmptyString& label) {
+  // Results are ordered by label, so the vault with exactly 'label' is the first with it as prefix.
+  ListVaultsQuery query;
+  query.label_prefix = label.string();
+  query.max_results = 1;
+  std::shared_future<VaultList> vault_list{ListVaults(std::move(query)).share()};
+  return std::async(std::launch::deferred, [vault_list, label]() -> VaultSummary {
+    const VaultList& result(vault_list.get());
+    if (result.vaults.empty() || result.vaults.front().label != label) {
+      LOG(kError) << "No vault with label " << label << " owned by this client.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+    }
+    return result.vaults.front();
+  });
+}
+
+void ClientInterface::SubscribeToVaultEvents(std::function<void(VaultEvent)> functor) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  bool was_subscribed{static_cast<bool>(on_vault_event_)};
+  on_vault_event_ = std::move(functor);
+  // The VaultManager only sends events to clients which have asked for them.  Sending while
+  // holding the lock keeps the VaultManager's view in step with ours under concurrent calls.
+  if (was_subscribed != static_cast<bool>(on_vault_event_))
+    Send(tcp_connection_, VaultEventsSubscription(static_cast<bool>(on_vault_event_)));
+}
+
+std::future<void> ClientInterface::RemoveVault(
+    const NonEmptyString& label, std::function<void(VaultRemovalProgress)> on_progress) {
+  auto waiter(std::make_shared<RemoveVaultWaiter>(asio_service_.service(), std::move(on_progress)));
+  std::future<void> future{waiter->promise.get_future()};
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!ongoing_remove_vault_requests_.insert(std::make_pair(label, waiter)).second) {
+      LOG(kError) << "Already removing vault " << label;
+      waiter->promise.set_exception(
+          std::make_exception_ptr(MakeError(CommonErrors::unable_to_handle_request)));
+      return future;
+    }
+  }
+  waiter->timer.async_wait([waiter, label, this](const std::error_code& ec) {
+    if (ec && ec == asio::error::operation_aborted)
+      return;
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (waiter->responded)
+      return;
+    waiter->responded = true;
+    auto itr(ongoing_remove_vault_requests_.find(label));
+    if (itr != std::end(ongoing_remove_vault_requests_) && itr->second == waiter)
+      ongoing_remove_vault_requests_.erase(itr);
+    LOG(kWarning) << "Timed out waiting for vault " << label << " to be removed.";
+    if (ec)
+      waiter->promise.set_exception(std::make_exception_ptr(std::system_error(ec)));
+    else
+      waiter->promise.set_exception(
+          std::make_exception_ptr(MakeError(VaultManagerErrors::timed_out)));
+  });
+  Send(tcp_connection_, RemoveVaultRequest(label));
+  return future;
+}
+
+std::future<void> ClientInterface::WaitForJoinedVaults(
+    int vault_count, int min_network_health, const std::chrono::steady_clock::duration& timeout) {
+  auto waiter(std::make_shared<JoinedVaultsWaiter>(asio_service_.service(), vault_count,
+                                                   min_network_health, timeout));
+  std::future<void> future{waiter->promise.get_future()};
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (CountJoinedVaults(min_network_health) >= vault_count) {
+    waiter->promise.set_value();
+    return future;
+  }
+  waiter->timer.async_wait([waiter, this](const std::error_code& ec) {
+    if (ec && ec == asio::error::operation_aborted)
+      return;
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(
+        std::find(std::begin(joined_vaults_waiters_), std::end(joined_vaults_waiters_), waiter));
+    if (itr == std::end(joined_vaults_waiters_))
+      return;  // Already satisfied.
+    joined_vaults_waiters_.erase(itr);
+    LOG(kWarning) << "Timed out waiting for " << waiter->vault_count << " vaults to join.  "
+                  << CountJoinedVaults(waiter->min_network_health) << " have joined.";
+    if (ec)
+      waiter->promise.set_exception(std::make_exception_ptr(std::system_error(ec)));
+    else
+      waiter->promise.set_exception(
+          std::make_exception_ptr(MakeError(VaultManagerErrors::timed_out)));
+  });
+  joined_vaults_waiters_.push_back(waiter);
+  return future;
+}
+
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::AddVaultRequest(
     const NonEmptyString& label) {
   std::shared_ptr<VaultRequest> request(
@@ -146,14 +404,40 @@ void ClientInterface::HandleReceivedMessage(tcp::Message&& message) {
       case MessageTag::kVaultRunningResponse:
         HandleVaultRunningResponse(Parse<VaultRunningResponse>(binary_input_stream));
         break;
+      case MessageTag::kVaultNetworkStatus:
+        AcknowledgeDroppableMessage();
+        HandleVaultNetworkStatus(Parse<VaultNetworkStatus>(binary_input_stream));
+        break;
+      case MessageTag::kUpgradeVaultsResponse:
+        HandleUpgradeVaultsResponse(Parse<UpgradeVaultsResponse>(binary_input_stream));
+        break;
+      case MessageTag::kVaultStatsResponse:
+        HandleVaultStatsResponse(Parse<VaultStatsResponse>(binary_input_stream));
+        break;
+      case MessageTag::kListVaultsResponse:
+        HandleListVaultsResponse(Parse<ListVaultsResponse>(binary_input_stream));
+        break;
+      case MessageTag::kVaultLifecycleEvent:
+        HandleVaultLifecycleEvent(Parse<VaultLifecycleEvent>(binary_input_stream));
+        break;
+      case MessageTag::kRemoveVaultResponse:
+        HandleRemoveVaultResponse(Parse<RemoveVaultResponse>(binary_input_stream));
+        break;
+      case MessageTag::kRemoveVaultProgress:
+        HandleRemoveVaultProgress(Parse<RemoveVaultProgress>(binary_input_stream));
+        break;
 #ifdef TESTING
       case MessageTag::kNetworkStableResponse:
         HandleNetworkStableResponse();
         break;
 #endif
       case MessageTag::kLogMessage:
+        AcknowledgeDroppableMessage();
         HandleLogMessage(Parse<LogMessage>(binary_input_stream));
         break;
+      case MessageTag::kSessionTicket:
+        HandleSessionTicket(Parse<SessionTicket>(binary_input_stream));
+        break;
       default:
         return;
     }
@@ -191,22 +475,159 @@ void ClientInterface::HandleVaultRunningResponse(VaultRunningResponse&& vault_ru
   }
 }
 
+void ClientInterface::HandleVaultNetworkStatus(VaultNetworkStatus&& vault_network_status) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  vault_network_status_[vault_network_status.vault_label] =
+      std::make_pair(vault_network_status.joined_network, vault_network_status.network_health);
+  auto itr(std::begin(joined_vaults_waiters_));
+  while (itr != std::end(joined_vaults_waiters_)) {
+    if (CountJoinedVaults((*itr)->min_network_health) >= (*itr)->vault_count) {
+      (*itr)->promise.set_value();
+      std::error_code ignored_ec;
+      (*itr)->timer.cancel(ignored_ec);
+      itr = joined_vaults_waiters_.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+}
+
+void ClientInterface::HandleListVaultsResponse(ListVaultsResponse&& list_vaults_response) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(ongoing_list_vaults_requests_.find(list_vaults_response.request_id));
+  if (itr == std::end(ongoing_list_vaults_requests_)) {
+    LOG(kWarning) << "No pending list vaults request " << list_vaults_response.request_id;
+    return;
+  }
+  try {
+    itr->second->SetValue(detail::GetValue(list_vaults_response));
+  } catch (const maidsafe_error& error) {
+    itr->second->SetException(error);
+  }
+  itr->second->timer.cancel();
+  ongoing_list_vaults_requests_.erase(itr);
+}
+
+void ClientInterface::HandleVaultStatsResponse(VaultStatsResponse&& vault_stats_response) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(ongoing_host_statistics_requests_.find(vault_stats_response.request_id));
+  if (itr == std::end(ongoing_host_statistics_requests_)) {
+    LOG(kWarning) << "No pending host statistics request " << vault_stats_response.request_id;
+    return;
+  }
+  try {
+    itr->second->SetValue(detail::GetValue(vault_stats_response));
+  } catch (const maidsafe_error& error) {
+    itr->second->SetException(error);
+  }
+  itr->second->timer.cancel();
+  ongoing_host_statistics_requests_.erase(itr);
+}
+
+void ClientInterface::HandleUpgradeVaultsResponse(UpgradeVaultsResponse&& upgrade_vaults_response) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(ongoing_upgrade_vaults_requests_.find(upgrade_vaults_response.request_id));
+  if (itr == std::end(ongoing_upgrade_vaults_requests_)) {
+    LOG(kWarning) << "No pending upgrade vaults request " << upgrade_vaults_response.request_id;
+    return;
+  }
+  try {
+    itr->second->SetValue(detail::GetValue(upgrade_vaults_response));
+  } catch (const maidsafe_error& error) {
+    itr->second->SetException(error);
+  }
+  itr->second->timer.cancel();
+  ongoing_upgrade_vaults_requests_.erase(itr);
+}
+
+void ClientInterface::HandleVaultLifecycleEvent(VaultLifecycleEvent&& vault_lifecycle_event) {
+  std::function<void(VaultEvent)> on_vault_event;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    on_vault_event = on_vault_event_;
+  }
+  if (on_vault_event)
+    on_vault_event(std::move(vault_lifecycle_event.event));
+}
+
+void ClientInterface::HandleRemoveVaultResponse(RemoveVaultResponse&& remove_vault_response) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto itr(ongoing_remove_vault_requests_.find(remove_vault_response.vault_label));
+  if (itr == std::end(ongoing_remove_vault_requests_) || itr->second->responded) {
+    LOG(kWarning) << "No pending request to remove vault " << remove_vault_response.vault_label;
+    return;
+  }
+  itr->second->responded = true;
+  std::error_code ignored_ec;
+  itr->second->timer.cancel(ignored_ec);
+  if (remove_vault_response.error) {
+    // Nothing is deleted, so there will be no progress reports.
+    itr->second->promise.set_exception(std::make_exception_ptr(*remove_vault_response.error));
+  } else {
+    if (itr->second->on_progress)
+      removal_progress_functors_[itr->first] = itr->second->on_progress;
+    itr->second->promise.set_value();
+  }
+  ongoing_remove_vault_requests_.erase(itr);
+}
+
+void ClientInterface::HandleRemoveVaultProgress(RemoveVaultProgress&& remove_vault_progress) {
+  std::function<void(VaultRemovalProgress)> on_progress;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(removal_progress_functors_.find(remove_vault_progress.progress.label));
+    if (itr == std::end(removal_progress_functors_))
+      return;
+    on_progress = itr->second;
+    if (remove_vault_progress.progress.finished)
+      removal_progress_functors_.erase(itr);
+  }
+  if (on_progress)
+    on_progress(std::move(remove_vault_progress.progress));
+}
+
+int ClientInterface::CountJoinedVaults(int min_network_health) const {
+  return static_cast<int>(std::count_if(
+      std::begin(vault_network_status_), std::end(vault_network_status_),
+      [min_network_health](const std::pair<const NonEmptyString, std::pair<bool, int>>& status) {
+        return status.second.first &&
+               (min_network_health <= 0 || status.second.second >= min_network_health);
+      }));
+}
+
 #ifdef TESTING
 void ClientInterface::HandleNetworkStableResponse() {
   std::call_once(network_stable_flag_, [&] { network_stable_.set_value(); });
 }
 #endif
 
-void ClientInterface::InvokeCallBack(Challenge&& challenge,
-                                     std::function<void(Challenge&&)>& callback) {
+template <typename MessageType>
+void ClientInterface::InvokeCallBack(MessageType&& message,
+                                     std::function<void(MessageType&&)>& callback) {
   if (callback)
-    callback(std::move(challenge));
+    callback(std::move(message));
   else
     LOG(kWarning) << "Call back not available";
 }
 
 void ClientInterface::HandleLogMessage(LogMessage&& log_message) { LOG(kInfo) << log_message.data; }
 
+void ClientInterface::AcknowledgeDroppableMessage() {
+  if (++unacknowledged_messages_ < kFlowControlAckBatch)
+    return;
+  Send(tcp_connection_, FlowControlAck(static_cast<uint32_t>(unacknowledged_messages_)));
+  unacknowledged_messages_ = 0;
+}
+
+void ClientInterface::HandleSessionTicket(SessionTicket&& session_ticket) {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (!session_ticket.ticket.empty())
+      session_ticket_ = session_ticket.ticket;
+  }
+  InvokeCallBack(std::move(session_ticket), on_session_ticket_);
+}
+
 #ifdef TESTING
 void ClientInterface::SetTestEnvironment(tcp::Port test_vault_manager_port,
                                          boost::filesystem::path test_env_root_dir,
@@ -215,6 +636,14 @@ void ClientInterface::SetTestEnvironment(tcp::Port test_vault_manager_port,
   test::SetEnvironment(test_vault_manager_port, test_env_root_dir, path_to_vault, pmid_list_size);
 }
 
+void ClientInterface::SetTestEnvironment(tcp::Port test_vault_manager_port,
+                                         boost::filesystem::path test_env_root_dir,
+                                         boost::filesystem::path path_to_vault,
+                                         std::vector<passport::PmidAndSigner> pmids_and_signers) {
+  test::SetEnvironment(test_vault_manager_port, test_env_root_dir, path_to_vault,
+                       std::move(pmids_and_signers));
+}
+
 #ifdef USE_VLOGGING
 std::future<std::unique_ptr<passport::PmidAndSigner>> ClientInterface::StartVault(
     const boost::filesystem::path& vault_dir, DiskUsage max_disk_usage,
@@ -23,11 +23,32 @@ namespace maidsafe {
 namespace vault_manager {
 
 const std::string kConfigFilename("vault_manager_config.dat");
+const std::string kEventLogFilename("vault_manager_events.dat");
 const std::string kBootstrapFilename("bootstrap.dat");
+const std::string kStandbyVaultArg("--standby");
+const std::string kReclaimableMarkerFilename(".vault_manager_reclaimable");
 
 const std::chrono::seconds kRpcTimeout(2);
 const std::chrono::seconds kVaultStopTimeout(10);
+const std::chrono::seconds kStandbyVaultTimeout(600);
+const std::chrono::seconds kVaultJoinTimeout(300);
+const std::chrono::seconds kVaultReconnectTimeout(60);
 const int kMaxVaultRestarts(5);
+const std::chrono::seconds kHeartbeatInterval(5);
+const int kMaxMissedHeartbeats(3);
+const std::chrono::seconds kSessionTicketLifetime(300);
+const int kMaxPendingConnections(256);
+const int kClientValidationRate(100);
+const int kClientValidationBurst(200);
+const int kMaxUnacknowledgedMessages(64);
+const int kFlowControlAckBatch(8);
+const std::size_t kMaxListVaultsPageSize(100);
+const int kBlockingIoThreads(4);
+const std::chrono::seconds kBlockingIoTimeout(30);
+const std::chrono::milliseconds kConfigWriteCoalesceWindow(200);
+const int kMaxReclaimUnlinksPerSecond(500);
+const std::chrono::seconds kReclaimProgressInterval(1);
+const std::chrono::seconds kIoLoadSampleInterval(10);
 
 }  // namespace vault_manager
 
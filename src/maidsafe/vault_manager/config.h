@@ -20,6 +20,7 @@
 #define MAIDSAFE_VAULT_MANAGER_CONFIG_H_
 
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -38,17 +39,60 @@ typedef asio::steady_timer Timer;
 typedef std::shared_ptr<Timer> TimerPtr;
 
 extern const std::string kConfigFilename;
+extern const std::string kEventLogFilename;
 extern const std::string kBootstrapFilename;
+extern const std::string kStandbyVaultArg;
+extern const std::string kReclaimableMarkerFilename;
 extern const std::chrono::seconds kRpcTimeout;
 extern const std::chrono::seconds kVaultStopTimeout;
+extern const std::chrono::seconds kStandbyVaultTimeout;
+extern const std::chrono::seconds kVaultJoinTimeout;
+extern const std::chrono::seconds kVaultReconnectTimeout;
 extern const int kMaxVaultRestarts;
+extern const std::chrono::seconds kHeartbeatInterval;
+extern const int kMaxMissedHeartbeats;
+extern const std::chrono::seconds kSessionTicketLifetime;
+// Admission control for incoming connections: at most this many connections may be awaiting
+// identification (in each of NewConnections and ClientConnections), and clients may ask to be
+// validated at a sustained rate of kClientValidationRate per second with bursts of up to
+// kClientValidationBurst.  Excess connections are closed immediately.  Only clients are rate
+// limited, so that a storm of them can't stop this VaultManager's own vaults from reconnecting.
+extern const int kMaxPendingConnections;
+extern const int kClientValidationRate;
+extern const int kClientValidationBurst;
+// Messages which clients can afford to miss (LogMessage and VaultNetworkStatus) are only sent while
+// fewer than kMaxUnacknowledgedMessages of them are unacknowledged by the client, which sends a
+// FlowControlAck after every kFlowControlAckBatch of them.
+extern const int kMaxUnacknowledgedMessages;
+extern const int kFlowControlAckBatch;
+extern const std::size_t kMaxListVaultsPageSize;
+// Filesystem operations run on a pool of kBlockingIoThreads threads rather than the asio thread,
+// and are reported as failed if they take longer than kBlockingIoTimeout.
+extern const int kBlockingIoThreads;
+extern const std::chrono::seconds kBlockingIoTimeout;
+// Changes to the config file made within kConfigWriteCoalesceWindow of each other are written
+// together.
+extern const std::chrono::milliseconds kConfigWriteCoalesceWindow;
+// The directories of removed vaults are deleted in the background at no more than
+// kMaxReclaimUnlinksPerSecond files per second, with progress reported to the owner at most every
+// kReclaimProgressInterval.
+extern const int kMaxReclaimUnlinksPerSecond;
+extern const std::chrono::seconds kReclaimProgressInterval;
+// When there are several data volumes, their I/O load is sampled every kIoLoadSampleInterval so
+// that new vaults can be placed away from busy devices.
+extern const std::chrono::seconds kIoLoadSampleInterval;
 
 DEFINE_OSTREAMABLE_ENUM_VALUES(
     MessageTag, std::uint8_t,
     (ValidateConnectionRequest)(Challenge)(ChallengeResponse)(StartVaultRequest)(
         TakeOwnershipRequest)(VaultRunningResponse)(VaultStarted)(VaultStartedResponse)(
         VaultShutdownRequest)(MaxDiskUsageUpdate)(JoinedNetwork)(LogMessage)(SetNetworkAsStable)(
-        NetworkStableRequest)(NetworkStableResponse))
+        NetworkStableRequest)(NetworkStableResponse)(UpgradeVaultsRequest)(UpgradeVaultsResponse)(
+        VaultReconnectRequest)(VaultChallengeResponse)(NetworkHealthUpdate)(VaultNetworkStatus)(
+        HeartbeatRequest)(HeartbeatResponse)(VaultStats)(VaultStatsRequest)(VaultStatsResponse)(
+        ResumeSessionRequest)(SessionTicket)(FlowControlAck)(ListVaultsRequest)(
+        ListVaultsResponse)(VaultLifecycleEvent)(RemoveVaultRequest)(RemoveVaultResponse)(
+        RemoveVaultProgress)(VaultEventsSubscription))
 
 }  // namespace vault_manager
 
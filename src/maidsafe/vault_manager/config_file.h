@@ -22,8 +22,11 @@
 #include <memory>
 #include <vector>
 
+#include "cereal/types/vector.hpp"
+
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/crypto.h"
+#include "maidsafe/common/process.h"
 #include "maidsafe/common/serialisation/types/boost_filesystem.h"
 
 #include "maidsafe/vault_manager/config.h"
@@ -43,7 +46,7 @@ struct ConfigFile {
       : symm_key_and_iv(std::move(other.symm_key_and_iv)),
         vaults(std::move(other.vaults)) {}
 
-  ConfigFile(crypto::AES256KeyAndIV symm_key_and_iv_in, std::vector<VaultInfo> vaults_in)
+  ConfigFile(crypto::AES256KeyAndIV symm_key_and_iv_in, std::vector<VaultInfoPtr> vaults_in)
       : symm_key_and_iv(std::move(symm_key_and_iv_in)),
         vaults(std::move(vaults_in)) {}
 
@@ -61,6 +64,7 @@ struct ConfigFile {
   void load(Archive& archive) {
     std::size_t vault_count(0);
     archive(symm_key_and_iv, vault_count);
+    std::vector<VaultInfo> loaded_vaults;
     for (std::size_t i(0); i < vault_count; ++i) {
       VaultInfo vault;
       crypto::CipherText encrypted_pmid, encrypted_anpmid;
@@ -72,24 +76,41 @@ struct ConfigFile {
                          passport::DecryptAnpmid(encrypted_anpmid, symm_key_and_iv)));
       if (has_owner_name)
         archive(vault.owner_name);
+      loaded_vaults.push_back(std::move(vault));
+    }
+    // Process IDs were added after the original format, so may be missing from older files.
+    try {
+      std::vector<process::ProcessId> process_ids;
+      archive(process_ids);
+      for (std::size_t i(0); i < process_ids.size() && i < loaded_vaults.size(); ++i)
+        loaded_vaults[i].process_id = process_ids[i];
+    } catch (const std::exception&) {
+      for (auto& vault : loaded_vaults)
+        vault.process_id = 0;
     }
+    for (auto& vault : loaded_vaults)
+      vaults.push_back(std::make_shared<const VaultInfo>(std::move(vault)));
   }
 
   template <typename Archive>
   void save(Archive& archive) const {
     archive(symm_key_and_iv, vaults.size());
     for (const auto& vault : vaults) {
-      archive(passport::EncryptPmid(vault.pmid_and_signer->first, symm_key_and_iv),
-              passport::EncryptAnpmid(vault.pmid_and_signer->second, symm_key_and_iv),
-              vault.vault_dir, vault.label, vault.max_disk_usage,
-              vault.owner_name.IsInitialised());
-      if (vault.owner_name.IsInitialised())
-        archive(vault.owner_name);
+      archive(passport::EncryptPmid(vault->pmid_and_signer->first, symm_key_and_iv),
+              passport::EncryptAnpmid(vault->pmid_and_signer->second, symm_key_and_iv),
+              vault->vault_dir, vault->label, vault->max_disk_usage,
+              vault->owner_name.IsInitialised());
+      if (vault->owner_name.IsInitialised())
+        archive(vault->owner_name);
     }
+    std::vector<process::ProcessId> process_ids;
+    for (const auto& vault : vaults)
+      process_ids.push_back(vault->process_id);
+    archive(process_ids);
   }
 
   crypto::AES256KeyAndIV symm_key_and_iv;
-  std::vector<VaultInfo> vaults;
+  std::vector<VaultInfoPtr> vaults;
 };
 
 }  // namespace vault_manager
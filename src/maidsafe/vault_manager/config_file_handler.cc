@@ -18,6 +18,17 @@
 
 #include "maidsafe/vault_manager/config_file_handler.h"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef MAIDSAFE_WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <string>
 
 #include "boost/filesystem/operations.hpp"
@@ -29,6 +40,7 @@
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/vault_manager/config_file.h"
+#include "maidsafe/vault_manager/tracing.h"
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/vault_info.h"
 
@@ -49,6 +61,89 @@ ConfigFile ParseConfigFile(const fs::path& config_file_path, std::mutex& mutex)
   return Parse<ConfigFile>(content);
 }
 
+#ifdef MAIDSAFE_WIN32
+int OpenForWriting(const fs::path& path) {
+  return _wopen(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+int WriteSome(int file_descriptor, const char* data, std::size_t size) {
+  return _write(file_descriptor, data, static_cast<unsigned>(std::min<std::size_t>(size, 1 << 30)));
+}
+
+bool Sync(int file_descriptor) { return _commit(file_descriptor) == 0; }
+
+bool Close(int file_descriptor) { return _close(file_descriptor) == 0; }
+
+// Windows doesn't support syncing a directory; MoveFileEx (used by fs::rename) is sufficient.
+void SyncDirectory(const fs::path&) {}
+#else
+int OpenForWriting(const fs::path& path) {
+  return open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+}
+
+ssize_t WriteSome(int file_descriptor, const char* data, std::size_t size) {
+  return write(file_descriptor, data, size);
+}
+
+bool Sync(int file_descriptor) { return fsync(file_descriptor) == 0; }
+
+bool Close(int file_descriptor) { return close(file_descriptor) == 0; }
+
+// Makes the rename itself durable.  Failure here is logged but not fatal, since the new file's
+// contents are already on disk.
+void SyncDirectory(const fs::path& directory) {
+  int file_descriptor{open(directory.c_str(), O_RDONLY)};
+  if (file_descriptor == -1 || !Sync(file_descriptor))
+    LOG(kWarning) << "Failed to sync " << directory << ": " << std::strerror(errno);
+  if (file_descriptor != -1)
+    Close(file_descriptor);
+}
+#endif
+
+// Writes 'content' to a temporary file alongside 'path', flushes it to disk, then renames it over
+// 'path'.  A crash at any point leaves either the complete old or the complete new file in place.
+bool WriteFileDurably(const fs::path& path, const SerialisedData& content) {
+  fs::path temp_path{path};
+  temp_path += ".tmp";
+  int file_descriptor{OpenForWriting(temp_path)};
+  if (file_descriptor == -1) {
+    LOG(kError) << "Failed to open " << temp_path << ": " << std::strerror(errno);
+    return false;
+  }
+
+  const char* data{reinterpret_cast<const char*>(content.data())};
+  std::size_t remaining{content.size()};
+  bool written{true};
+  while (written && remaining > 0) {
+    auto result(WriteSome(file_descriptor, data, remaining));
+    if (result < 0) {
+      written = (errno == EINTR);
+      continue;
+    }
+    data += result;
+    remaining -= static_cast<std::size_t>(result);
+  }
+  if (!written || !Sync(file_descriptor)) {
+    LOG(kError) << "Failed to write " << temp_path << ": " << std::strerror(errno);
+    written = false;
+  }
+  if (!Close(file_descriptor))
+    written = false;
+
+  boost::system::error_code error_code;
+  if (written) {
+    fs::rename(temp_path, path, error_code);
+    if (!error_code) {
+      SyncDirectory(path.parent_path());
+      return true;
+    }
+    LOG(kError) << "Failed to rename " << temp_path << " to " << path << ": "
+                << error_code.message();
+  }
+  fs::remove(temp_path, error_code);
+  return false;
+}
+
 crypto::AES256KeyAndIV InitialiseKeyAndIv(const fs::path& config_file_path, std::mutex& mutex) {
   boost::system::error_code error_code;
   if (!fs::exists(config_file_path, error_code) ||
@@ -73,7 +168,7 @@ ConfigFileHandler::ConfigFileHandler(fs::path config_file_path)
 }
 
 void ConfigFileHandler::CreateConfigFile() {
-  ConfigFile config(kSymmKeyAndIV_, std::vector<VaultInfo>{});
+  ConfigFile config(kSymmKeyAndIV_, std::vector<VaultInfoPtr>{});
 
   boost::system::error_code error_code;
   if (!fs::exists(config_file_path_.parent_path(), error_code)) {
@@ -95,13 +190,17 @@ void ConfigFileHandler::CreateConfigFile() {
 std::vector<VaultInfo> ConfigFileHandler::ReadConfigFile() const {
   ConfigFile config{ParseConfigFile(config_file_path_, mutex_)};
   assert(config.symm_key_and_iv == kSymmKeyAndIV_);
-  return config.vaults;
+  std::vector<VaultInfo> vaults;
+  for (const auto& vault : config.vaults)
+    vaults.push_back(*vault);
+  return vaults;
 }
 
-void ConfigFileHandler::WriteConfigFile(std::vector<VaultInfo> vaults) const {
+void ConfigFileHandler::WriteConfigFile(std::vector<VaultInfoPtr> vaults) const {
+  VAULT_MANAGER_TRACE_SPAN("ConfigFileHandler::WriteConfigFile");
   ConfigFile config(kSymmKeyAndIV_, std::move(vaults));
   std::lock_guard<std::mutex> lock{mutex_};
-  if (!WriteFile(config_file_path_, Serialise(config))) {
+  if (!WriteFileDurably(config_file_path_, Serialise(config))) {
     LOG(kError) << "Failed to write config file " << config_file_path_;
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
   }
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_CONFIG_FILE_HANDLER_H_
 #define MAIDSAFE_VAULT_MANAGER_CONFIG_FILE_HANDLER_H_
 
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -32,12 +33,13 @@ namespace maidsafe {
 namespace vault_manager {
 
 struct VaultInfo;
+typedef std::shared_ptr<const VaultInfo> VaultInfoPtr;
 
 class ConfigFileHandler {
  public:
   explicit ConfigFileHandler(boost::filesystem::path config_file_path);
   std::vector<VaultInfo> ReadConfigFile() const;
-  void WriteConfigFile(std::vector<VaultInfo> vaults) const;
+  void WriteConfigFile(std::vector<VaultInfoPtr> vaults) const;
   const crypto::AES256KeyAndIV& SymmKeyAndIV() const { return kSymmKeyAndIV_; }
 
  private:
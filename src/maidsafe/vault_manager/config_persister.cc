@@ -0,0 +1,107 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/config_persister.h"
+
+#include <exception>
+#include <utility>
+
+#include "asio/error.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/vault_manager/blocking_io.h"
+#include "maidsafe/vault_manager/tracing.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+struct ConfigPersister::PendingWrite {
+  PendingWrite() : durable(), durable_future(durable.get_future().share()) {}
+
+  std::promise<void> durable;
+  std::shared_future<void> durable_future;
+  std::vector<OnWritten> on_written;
+};
+
+ConfigPersister::ConfigPersister(asio::io_service& io_service, BlockingIo& blocking_io,
+                                 const ConfigFileHandler& config_file_handler, Snapshot snapshot,
+                                 std::chrono::steady_clock::duration coalesce_window)
+    : blocking_io_(blocking_io),
+      config_file_handler_(config_file_handler),
+      snapshot_(std::move(snapshot)),
+      kCoalesceWindow_(coalesce_window),
+      timer_(io_service),
+      pending_write_() {}
+
+std::shared_future<void> ConfigPersister::MarkDirty(OnWritten on_written) {
+  if (!pending_write_) {
+    pending_write_ = std::make_shared<PendingWrite>();
+    timer_.expires_from_now(kCoalesceWindow_);
+    timer_.async_wait([this](const std::error_code& error_code) {
+      if (error_code != asio::error::operation_aborted)
+        Write();
+    });
+  }
+  if (on_written)
+    pending_write_->on_written.push_back(std::move(on_written));
+  return pending_write_->durable_future;
+}
+
+std::shared_future<void> ConfigPersister::Flush() {
+  auto durable_future(MarkDirty());
+  Write();
+  return durable_future;
+}
+
+void ConfigPersister::Write() {
+  VAULT_MANAGER_TRACE_SPAN("ConfigPersister::Write");
+  if (!pending_write_)
+    return;  // Already written by an explicit Flush.
+  std::error_code ignored_ec;
+  timer_.cancel(ignored_ec);
+  std::shared_ptr<PendingWrite> pending_write;
+  pending_write.swap(pending_write_);
+
+  // The snapshot is taken here rather than when marked dirty, so it includes every change made
+  // during the window.  Writes are run in order so that an earlier snapshot can't overwrite it.
+  std::vector<VaultInfoPtr> vaults{snapshot_()};
+  const ConfigFileHandler& config_file_handler(config_file_handler_);
+  blocking_io_.RunInOrder(
+      [&config_file_handler, vaults] { config_file_handler.WriteConfigFile(vaults); },
+      [pending_write](std::exception_ptr io_error) {
+        if (io_error) {
+          try {
+            std::rethrow_exception(io_error);
+          } catch (const std::exception& e) {
+            LOG(kError) << "Failed to write config file: " << boost::diagnostic_information(e);
+          }
+          pending_write->durable.set_exception(io_error);
+        } else {
+          pending_write->durable.set_value();
+        }
+        for (const auto& on_written : pending_write->on_written)
+          on_written(io_error);
+      });
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,82 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_CONFIG_PERSISTER_H_
+#define MAIDSAFE_VAULT_MANAGER_CONFIG_PERSISTER_H_
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "asio/io_service.hpp"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/config_file_handler.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+class BlockingIo;
+
+// Write-behind persistence of the config file.  Changes are marked via MarkDirty, and all changes
+// marked within 'coalesce_window' of the first are written together in a single write, run via
+// 'blocking_io'.  All public functions must be called from 'io_service'.
+class ConfigPersister {
+ public:
+  typedef std::function<std::vector<VaultInfoPtr>()> Snapshot;
+  // Invoked via 'io_service' with a null exception_ptr once the write is durable, otherwise with
+  // the reason it failed.
+  typedef std::function<void(std::exception_ptr)> OnWritten;
+
+  ConfigPersister(asio::io_service& io_service, BlockingIo& blocking_io,
+                  const ConfigFileHandler& config_file_handler, Snapshot snapshot,
+                  std::chrono::steady_clock::duration coalesce_window = kConfigWriteCoalesceWindow);
+  ConfigPersister(const ConfigPersister&) = delete;
+  ConfigPersister(ConfigPersister&&) = delete;
+  ConfigPersister& operator=(ConfigPersister) = delete;
+
+  // Schedules a write, unless one is already scheduled.  The returned future becomes ready once a
+  // write including this change is durable on disk, or holds the exception if that write failed.
+  // 'on_written', if given, is invoked at the same time.
+  std::shared_future<void> MarkDirty(OnWritten on_written = nullptr);
+  // As MarkDirty, but takes the snapshot and starts the write immediately.  The write is queued
+  // behind any already started, so once the returned future is ready all of them have completed.
+  std::shared_future<void> Flush();
+
+ private:
+  struct PendingWrite;
+
+  void Write();
+
+  BlockingIo& blocking_io_;
+  const ConfigFileHandler& config_file_handler_;
+  const Snapshot snapshot_;
+  const std::chrono::steady_clock::duration kCoalesceWindow_;
+  Timer timer_;
+  std::shared_ptr<PendingWrite> pending_write_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_CONFIG_PERSISTER_H_
@@ -0,0 +1,239 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/event_log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const char kFileHeader[] = "MSVMEV01";
+const std::size_t kFileHeaderSize = sizeof(kFileHeader) - 1;
+const std::chrono::milliseconds kWriterIdleInterval(100);
+
+template <typename T>
+void EncodeInteger(T value, char* out) {
+  typename std::make_unsigned<T>::type unsigned_value(value);
+  for (std::size_t i(0); i < sizeof(T); ++i)
+    out[i] = static_cast<char>((unsigned_value >> (8 * i)) & 0xFF);
+}
+
+template <typename T>
+T DecodeInteger(const char* in) {
+  typename std::make_unsigned<T>::type unsigned_value(0);
+  for (std::size_t i(0); i < sizeof(T); ++i) {
+    unsigned_value |= static_cast<typename std::make_unsigned<T>::type>(
+                          static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  return static_cast<T>(unsigned_value);
+}
+
+std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+  std::size_t result(2);
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+}  // unnamed namespace
+
+const std::size_t EventRecord::kSize;
+const std::size_t EventRecord::kLabelSize;
+
+EventRecord::EventRecord()
+    : timestamp(0), latency(0), label(), process_id(0), exit_code(0), type(EventType::kStarting) {}
+
+EventRecord::EventRecord(EventType type_in, std::string label_in, std::uint64_t process_id_in,
+                         std::int32_t exit_code_in, std::chrono::microseconds latency_in)
+    : timestamp(std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())),
+      latency(latency_in),
+      label(std::move(label_in)),
+      process_id(process_id_in),
+      exit_code(exit_code_in),
+      type(type_in) {}
+
+EventRecord::Encoded EventRecord::Encode() const {
+  Encoded encoded;
+  encoded.fill(0);
+  EncodeInteger<std::int64_t>(timestamp.count(), &encoded[0]);
+  EncodeInteger<std::uint64_t>(process_id, &encoded[8]);
+  EncodeInteger<std::int64_t>(latency.count(), &encoded[16]);
+  EncodeInteger<std::int32_t>(exit_code, &encoded[24]);
+  encoded[28] = static_cast<char>(type);
+  std::memcpy(&encoded[32], label.data(), std::min(label.size(), kLabelSize));
+  return encoded;
+}
+
+EventRecord EventRecord::Decode(const Encoded& encoded) {
+  const auto kType(static_cast<std::uint8_t>(encoded[28]));
+  if (kType > static_cast<std::uint8_t>(EventType::kJoinedNetwork)) {
+    LOG(kError) << "Unknown event type " << static_cast<int>(kType);
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  EventRecord record;
+  record.timestamp = std::chrono::microseconds(DecodeInteger<std::int64_t>(&encoded[0]));
+  record.process_id = DecodeInteger<std::uint64_t>(&encoded[8]);
+  record.latency = std::chrono::microseconds(DecodeInteger<std::int64_t>(&encoded[16]));
+  record.exit_code = DecodeInteger<std::int32_t>(&encoded[24]);
+  record.type = static_cast<EventType>(kType);
+  const char* const kLabelBegin(&encoded[32]);
+  record.label.assign(kLabelBegin, std::find(kLabelBegin, kLabelBegin + kLabelSize, '\0'));
+  return record;
+}
+
+EventLog::EventLog(fs::path path, std::size_t capacity)
+    : kPath_(std::move(path)),
+      kMask_(RoundUpToPowerOfTwo(capacity) - 1),
+      slots_(new Slot[kMask_ + 1]),
+      enqueue_position_(0),
+      dequeue_position_(0),
+      dropped_count_(0),
+      running_(true),
+      writer_() {
+  for (std::size_t i(0); i <= kMask_; ++i)
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  writer_ = std::thread([this] { Run(); });
+}
+
+EventLog::~EventLog() {
+  running_ = false;
+  writer_.join();
+  if (dropped_count_ != 0U)
+    LOG(kWarning) << "Dropped " << dropped_count_ << " records from event log " << kPath_;
+}
+
+void EventLog::Record(EventType type, const std::string& label, std::uint64_t process_id,
+                      std::int32_t exit_code, std::chrono::microseconds latency) {
+  const EventRecord::Encoded kEncoded(
+      EventRecord(type, label, process_id, exit_code, latency).Encode());
+  std::size_t position(enqueue_position_.load(std::memory_order_relaxed));
+  for (;;) {
+    Slot& slot(slots_[position & kMask_]);
+    const std::size_t kSequence(slot.sequence.load(std::memory_order_acquire));
+    if (kSequence == position) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        slot.data = kEncoded;
+        slot.sequence.store(position + 1, std::memory_order_release);
+        return;
+      }
+    } else if (kSequence < position) {  // The writer hasn't yet freed this slot - buffer is full.
+      ++dropped_count_;
+      return;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool EventLog::TryPop(EventRecord::Encoded& data) {
+  Slot& slot(slots_[dequeue_position_ & kMask_]);
+  if (slot.sequence.load(std::memory_order_acquire) != dequeue_position_ + 1)
+    return false;
+  data = slot.data;
+  slot.sequence.store(dequeue_position_ + kMask_ + 1, std::memory_order_release);
+  ++dequeue_position_;
+  return true;
+}
+
+void EventLog::Run() {
+  boost::system::error_code ec;
+  std::uintmax_t size(fs::exists(kPath_, ec) ? fs::file_size(kPath_, ec) : 0U);
+  if (!ec) {
+    // Drop any partial record (or header) left by a crash mid-write, since records appended after
+    // it would otherwise be misaligned.
+    const std::uintmax_t kValidSize(
+        size < kFileHeaderSize ? 0U : size - (size - kFileHeaderSize) % EventRecord::kSize);
+    if (kValidSize != size) {
+      LOG(kWarning) << "Truncating " << size - kValidSize << " trailing bytes from event log "
+                    << kPath_;
+      fs::resize_file(kPath_, kValidSize, ec);
+      if (ec)
+        LOG(kError) << "Failed to truncate event log " << kPath_ << ": " << ec.message();
+      size = kValidSize;
+    }
+  }
+  const bool kNewFile(!ec && size == 0U);
+  std::ofstream file(kPath_.string(), std::ios::out | std::ios::binary | std::ios::app);
+  if (file && kNewFile)
+    file.write(kFileHeader, kFileHeaderSize);
+  if (!file)
+    LOG(kError) << "Failed to open event log " << kPath_ << " - events will be discarded.";
+
+  EventRecord::Encoded data;
+  for (;;) {
+    // Read 'running_' before draining, so that records added before the destructor was called are
+    // always written.
+    const bool kRunning(running_);
+    bool popped(false);
+    while (TryPop(data)) {
+      popped = true;
+      if (file)
+        file.write(data.data(), data.size());
+    }
+    if (popped && file)
+      file.flush();
+    if (!kRunning)
+      return;
+    if (!popped)
+      Sleep(kWriterIdleInterval);
+  }
+}
+
+std::vector<EventRecord> ReadEventLog(const fs::path& path) {
+  std::ifstream file(path.string(), std::ios::in | std::ios::binary);
+  if (!file) {
+    LOG(kError) << "Failed to open event log " << path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  char header[kFileHeaderSize];
+  if (!file.read(header, kFileHeaderSize) ||
+      !std::equal(header, header + kFileHeaderSize, kFileHeader)) {
+    LOG(kError) << path << " is not an event log.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
+  }
+  std::vector<EventRecord> records;
+  EventRecord::Encoded encoded;
+  // A trailing partial record (e.g. from a crash mid-write) is ignored.
+  while (file.read(encoded.data(), encoded.size()))
+    records.push_back(EventRecord::Decode(encoded));
+  return records;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,124 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_EVENT_LOG_H_
+#define MAIDSAFE_VAULT_MANAGER_EVENT_LOG_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/type_macros.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+DEFINE_OSTREAMABLE_ENUM_VALUES(EventType, std::uint8_t,
+                               (Starting)(Running)(Stopping)(Exited)(UnexpectedExit)(Restarting)(
+                                   TimedOut)(JoinedNetwork))
+
+// One vault lifecycle event.  On disk each is a fixed-size record of kSize bytes, all integers
+// little-endian:
+//   [0, 8)   timestamp: microseconds since the Unix epoch
+//   [8, 16)  process ID (0 if unknown)
+//   [16, 24) latency in microseconds: for kRunning and kJoinedNetwork, the time since the process
+//            was started; for kExited and kUnexpectedExit, the time since it was running (or
+//            started, if it never ran); otherwise 0
+//   [24, 28) exit code (only meaningful for kExited and kUnexpectedExit)
+//   [28]     EventType
+//   [29, 32) reserved (zero)
+//   [32, 64) vault label, truncated or zero-padded
+struct EventRecord {
+  static const std::size_t kSize = 64;
+  static const std::size_t kLabelSize = 32;
+  typedef std::array<char, kSize> Encoded;
+
+  EventRecord();
+  EventRecord(EventType type_in, std::string label_in, std::uint64_t process_id_in,
+              std::int32_t exit_code_in, std::chrono::microseconds latency_in);
+
+  Encoded Encode() const;
+  // Throws CommonErrors::parsing_error if 'encoded' has an unknown event type.
+  static EventRecord Decode(const Encoded& encoded);
+
+  std::chrono::microseconds timestamp, latency;
+  std::string label;
+  std::uint64_t process_id;
+  std::int32_t exit_code;
+  EventType type;
+};
+
+// Appends EventRecords to a binary file for offline analysis (see tools/event_log_reader.cc).
+// Recording is lock-free and never blocks: records go into a fixed-capacity ring buffer which a
+// dedicated thread drains to disk.  If the buffer is full the record is dropped and counted, since
+// the caller is typically on the VaultManager's asio thread.
+class EventLog {
+ public:
+  // The file is created (with a header) if it doesn't exist; otherwise records are appended, after
+  // truncating any partial record at the end of the file.
+  // 'capacity' is rounded up to a power of two.
+  explicit EventLog(boost::filesystem::path path, std::size_t capacity = 4096);
+  // Writes any buffered records before returning.
+  ~EventLog();
+  EventLog(const EventLog&) = delete;
+  EventLog(EventLog&&) = delete;
+  EventLog& operator=(EventLog) = delete;
+
+  void Record(EventType type, const std::string& label, std::uint64_t process_id,
+              std::int32_t exit_code = 0,
+              std::chrono::microseconds latency = std::chrono::microseconds(0));
+  std::uint64_t DroppedCount() const { return dropped_count_; }
+
+ private:
+  // Bounded multi-producer, single-consumer queue slot: 'sequence' equals the slot's enqueue
+  // position when free, and that position plus one once it holds a record.
+  struct Slot {
+    std::atomic<std::size_t> sequence;
+    EventRecord::Encoded data;
+  };
+
+  bool TryPop(EventRecord::Encoded& data);
+  void Run();
+
+  const boost::filesystem::path kPath_;
+  const std::size_t kMask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<std::size_t> enqueue_position_;
+  std::size_t dequeue_position_;  // Only accessed by 'writer_'.
+  std::atomic<std::uint64_t> dropped_count_;
+  std::atomic<bool> running_;
+  std::thread writer_;
+};
+
+// Returns all complete records in the file at 'path'.  Throws CommonErrors::filesystem_io_error if
+// the file can't be read or CommonErrors::parsing_error if it isn't an event log.
+std::vector<EventRecord> ReadEventLog(const boost::filesystem::path& path);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_EVENT_LOG_H_
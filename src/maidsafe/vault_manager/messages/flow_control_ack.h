@@ -0,0 +1,61 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_FLOW_CONTROL_ACK_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_FLOW_CONTROL_ACK_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Client to VaultManager, acknowledging receipt of 'message_count' messages which the VaultManager
+// may drop or coalesce for slow clients (LogMessage and VaultNetworkStatus).
+struct FlowControlAck {
+  static const MessageTag tag = MessageTag::kFlowControlAck;
+
+  FlowControlAck() = default;
+  FlowControlAck(const FlowControlAck&) = delete;
+  FlowControlAck(FlowControlAck&& other) MAIDSAFE_NOEXCEPT
+      : message_count(std::move(other.message_count)) {}
+  explicit FlowControlAck(uint32_t message_count_in) : message_count(message_count_in) {}
+  ~FlowControlAck() = default;
+  FlowControlAck& operator=(const FlowControlAck&) = delete;
+  FlowControlAck& operator=(FlowControlAck&& other) MAIDSAFE_NOEXCEPT {
+    message_count = std::move(other.message_count);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(message_count);
+  }
+
+  uint32_t message_count;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_FLOW_CONTROL_ACK_H_
@@ -0,0 +1,61 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_REMOVE_VAULT_PROGRESS_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_REMOVE_VAULT_PROGRESS_H_
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_removal_progress.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client, at most every kReclaimProgressInterval while a removed vault's directory
+// is being deleted, and once when it's finished.
+struct RemoveVaultProgress {
+  static const MessageTag tag = MessageTag::kRemoveVaultProgress;
+
+  RemoveVaultProgress() = default;
+  RemoveVaultProgress(const RemoveVaultProgress&) = delete;
+  RemoveVaultProgress(RemoveVaultProgress&& other) MAIDSAFE_NOEXCEPT
+      : progress(std::move(other.progress)) {}
+  explicit RemoveVaultProgress(VaultRemovalProgress progress_in)
+      : progress(std::move(progress_in)) {}
+  ~RemoveVaultProgress() = default;
+  RemoveVaultProgress& operator=(const RemoveVaultProgress&) = delete;
+  RemoveVaultProgress& operator=(RemoveVaultProgress&& other) MAIDSAFE_NOEXCEPT {
+    progress = std::move(other.progress);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(progress);
+  }
+
+  VaultRemovalProgress progress;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_REMOVE_VAULT_PROGRESS_H_
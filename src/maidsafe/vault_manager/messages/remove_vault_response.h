@@ -0,0 +1,70 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_REMOVE_VAULT_RESPONSE_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_REMOVE_VAULT_RESPONSE_H_
+
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client, once the vault has stopped and its removal from the config file is
+// durable (or has failed).  Deletion of its directory continues in the background and is reported
+// via RemoveVaultProgress.
+struct RemoveVaultResponse {
+  static const MessageTag tag = MessageTag::kRemoveVaultResponse;
+
+  RemoveVaultResponse() = default;
+  RemoveVaultResponse(const RemoveVaultResponse&) = delete;
+  RemoveVaultResponse(RemoveVaultResponse&& other) MAIDSAFE_NOEXCEPT
+      : vault_label(std::move(other.vault_label)), error(std::move(other.error)) {}
+  explicit RemoveVaultResponse(NonEmptyString vault_label_in)
+      : vault_label(std::move(vault_label_in)), error() {}
+  RemoveVaultResponse(NonEmptyString vault_label_in, maidsafe_error error_in)
+      : vault_label(std::move(vault_label_in)), error(std::move(error_in)) {}
+  ~RemoveVaultResponse() = default;
+  RemoveVaultResponse& operator=(const RemoveVaultResponse&) = delete;
+  RemoveVaultResponse& operator=(RemoveVaultResponse&& other) MAIDSAFE_NOEXCEPT {
+    vault_label = std::move(other.vault_label);
+    error = std::move(other.error);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_label, error);
+  }
+
+  NonEmptyString vault_label;
+  boost::optional<maidsafe_error> error;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_REMOVE_VAULT_RESPONSE_H_
@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_UPGRADE_VAULTS_REQUEST_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_UPGRADE_VAULTS_REQUEST_H_
+
+#include <cstdint>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/serialisation/types/boost_filesystem.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Client to VaultManager.  'request_id' is echoed in the UpgradeVaultsResponse.
+struct UpgradeVaultsRequest {
+  static const MessageTag tag = MessageTag::kUpgradeVaultsRequest;
+
+  UpgradeVaultsRequest() = default;
+
+  UpgradeVaultsRequest(const UpgradeVaultsRequest&) = delete;
+
+  UpgradeVaultsRequest(UpgradeVaultsRequest&& other) MAIDSAFE_NOEXCEPT
+      : request_id(std::move(other.request_id)),
+        vault_executable_path(std::move(other.vault_executable_path)),
+        batch_size(std::move(other.batch_size)) {}
+
+  UpgradeVaultsRequest(uint32_t request_id_in, boost::filesystem::path vault_executable_path_in,
+                       int32_t batch_size_in)
+      : request_id(request_id_in),
+        vault_executable_path(std::move(vault_executable_path_in)),
+        batch_size(batch_size_in) {}
+
+  ~UpgradeVaultsRequest() = default;
+
+  UpgradeVaultsRequest& operator=(const UpgradeVaultsRequest&) = delete;
+
+  UpgradeVaultsRequest& operator=(UpgradeVaultsRequest&& other) MAIDSAFE_NOEXCEPT {
+    request_id = std::move(other.request_id);
+    vault_executable_path = std::move(other.vault_executable_path);
+    batch_size = std::move(other.batch_size);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(request_id, vault_executable_path, batch_size);
+  }
+
+  uint32_t request_id;
+  boost::filesystem::path vault_executable_path;
+  int32_t batch_size;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_UPGRADE_VAULTS_REQUEST_H_
@@ -0,0 +1,85 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_UPGRADE_VAULTS_RESPONSE_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_UPGRADE_VAULTS_RESPONSE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "boost/optional.hpp"
+#include "cereal/types/boost_optional.hpp"
+#include "cereal/types/vector.hpp"
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// VaultManager to Client
+struct UpgradeVaultsResponse {
+  static const MessageTag tag = MessageTag::kUpgradeVaultsResponse;
+
+  UpgradeVaultsResponse() = default;
+
+  UpgradeVaultsResponse(const UpgradeVaultsResponse&) = delete;
+
+  UpgradeVaultsResponse(UpgradeVaultsResponse&& other) MAIDSAFE_NOEXCEPT
+      : request_id(std::move(other.request_id)),
+        upgraded_labels(std::move(other.upgraded_labels)),
+        error(std::move(other.error)) {}
+
+  UpgradeVaultsResponse(uint32_t request_id_in, std::vector<NonEmptyString> upgraded_labels_in)
+      : request_id(request_id_in), upgraded_labels(std::move(upgraded_labels_in)), error() {}
+
+  UpgradeVaultsResponse(uint32_t request_id_in, maidsafe_error error_in)
+      : request_id(request_id_in), upgraded_labels(), error(std::move(error_in)) {}
+
+  ~UpgradeVaultsResponse() = default;
+
+  UpgradeVaultsResponse& operator=(const UpgradeVaultsResponse&) = delete;
+
+  UpgradeVaultsResponse& operator=(UpgradeVaultsResponse&& other) MAIDSAFE_NOEXCEPT {
+    request_id = std::move(other.request_id);
+    upgraded_labels = std::move(other.upgraded_labels);
+    error = std::move(other.error);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(request_id, upgraded_labels, error);
+  }
+
+  uint32_t request_id;
+  // Labels of the vaults now running the new executable.  Empty if 'error' is set, since all
+  // restarted vaults will have been rolled back to the previous executable.
+  std::vector<NonEmptyString> upgraded_labels;
+  boost::optional<maidsafe_error> error;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_UPGRADE_VAULTS_RESPONSE_H_
@@ -0,0 +1,60 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_CHALLENGE_RESPONSE_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_CHALLENGE_RESPONSE_H_
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Vault to VaultManager - the Challenge signed using the vault's Pmid private key.
+struct VaultChallengeResponse {
+  static const MessageTag tag = MessageTag::kVaultChallengeResponse;
+
+  VaultChallengeResponse() = default;
+  VaultChallengeResponse(const VaultChallengeResponse&) = delete;
+  VaultChallengeResponse(VaultChallengeResponse&& other) MAIDSAFE_NOEXCEPT
+      : signature(std::move(other.signature)) {}
+  explicit VaultChallengeResponse(asymm::Signature signature_in)
+      : signature(std::move(signature_in)) {}
+  ~VaultChallengeResponse() = default;
+  VaultChallengeResponse& operator=(const VaultChallengeResponse&) = delete;
+  VaultChallengeResponse& operator=(VaultChallengeResponse&& other) MAIDSAFE_NOEXCEPT {
+    signature = std::move(other.signature);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(signature);
+  }
+
+  asymm::Signature signature;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_CHALLENGE_RESPONSE_H_
@@ -0,0 +1,72 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_NETWORK_STATUS_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_NETWORK_STATUS_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Sent to a vault's owner whenever the vault joins the network or its routing table health
+// changes.  'network_health' is -1 if the vault hasn't reported it.
+struct VaultNetworkStatus {
+  static const MessageTag tag = MessageTag::kVaultNetworkStatus;
+
+  VaultNetworkStatus() = default;
+  VaultNetworkStatus(const VaultNetworkStatus&) = delete;
+  VaultNetworkStatus(VaultNetworkStatus&& other) MAIDSAFE_NOEXCEPT
+      : vault_label(std::move(other.vault_label)),
+        joined_network(std::move(other.joined_network)),
+        network_health(std::move(other.network_health)) {}
+  VaultNetworkStatus(NonEmptyString vault_label_in, bool joined_network_in,
+                     int32_t network_health_in)
+      : vault_label(std::move(vault_label_in)),
+        joined_network(joined_network_in),
+        network_health(network_health_in) {}
+  ~VaultNetworkStatus() = default;
+  VaultNetworkStatus& operator=(const VaultNetworkStatus&) = delete;
+  VaultNetworkStatus& operator=(VaultNetworkStatus&& other) MAIDSAFE_NOEXCEPT {
+    vault_label = std::move(other.vault_label);
+    joined_network = std::move(other.joined_network);
+    network_health = std::move(other.network_health);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(vault_label, joined_network, network_health);
+  }
+
+  NonEmptyString vault_label;
+  bool joined_network;
+  int32_t network_health;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_NETWORK_STATUS_H_
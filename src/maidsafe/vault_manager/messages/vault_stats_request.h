@@ -0,0 +1,61 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STATS_REQUEST_H_
+#define MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STATS_REQUEST_H_
+
+#include <cstdint>
+
+#include "maidsafe/common/config.h"
+
+#include "maidsafe/vault_manager/config.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// Client to VaultManager.  'request_id' is echoed in the VaultStatsResponse so that a client can
+// have several requests outstanding.
+struct VaultStatsRequest {
+  static const MessageTag tag = MessageTag::kVaultStatsRequest;
+
+  VaultStatsRequest() = default;
+  VaultStatsRequest(const VaultStatsRequest&) = delete;
+  VaultStatsRequest(VaultStatsRequest&& other) MAIDSAFE_NOEXCEPT
+      : request_id(std::move(other.request_id)) {}
+  explicit VaultStatsRequest(uint32_t request_id_in) : request_id(request_id_in) {}
+  ~VaultStatsRequest() = default;
+  VaultStatsRequest& operator=(const VaultStatsRequest&) = delete;
+  VaultStatsRequest& operator=(VaultStatsRequest&& other) MAIDSAFE_NOEXCEPT {
+    request_id = std::move(other.request_id);
+    return *this;
+  };
+
+  template <typename Archive>
+  void serialize(Archive& archive) {
+    archive(request_id);
+  }
+
+  uint32_t request_id;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_MESSAGES_VAULT_STATS_REQUEST_H_
@@ -29,16 +29,28 @@ namespace maidsafe {
 
 namespace vault_manager {
 
-NewConnections::NewConnections(asio::io_service& io_service)
-    : io_service_(io_service), connections_() {}
-
-std::shared_ptr<NewConnections> NewConnections::MakeShared(asio::io_service& io_service) {
-  return std::shared_ptr<NewConnections>{new NewConnections{io_service}};
+NewConnections::NewConnections(asio::io_service& io_service, int max_pending_connections)
+    : io_service_(io_service),
+      kMaxPendingConnections_(max_pending_connections),
+      connections_(),
+      rejected_count_(0) {}
+
+std::shared_ptr<NewConnections> NewConnections::MakeShared(asio::io_service& io_service,
+                                                           int max_pending_connections) {
+  return std::shared_ptr<NewConnections>{new NewConnections{io_service, max_pending_connections}};
 }
 
 NewConnections::~NewConnections() { assert(connections_.empty()); }
 
-void NewConnections::Add(tcp::ConnectionPtr connection) {
+bool NewConnections::Add(tcp::ConnectionPtr connection) {
+  if (static_cast<int>(connections_.size()) >= kMaxPendingConnections_) {
+    // Only log occasionally, since a connection storm would otherwise flood the log too.
+    if (rejected_count_++ % 100 == 0) {
+      LOG(kWarning) << "Rejecting new connection (" << rejected_count_ << " so far); "
+                    << connections_.size() << " connections are awaiting identification.";
+    }
+    return false;
+  }
   TimerPtr timer{std::make_shared<Timer>(io_service_, kRpcTimeout)};
   timer->async_wait([connection](const std::error_code& error_code) {
     if (!error_code || error_code != asio::error::operation_aborted) {
@@ -49,6 +61,7 @@ void NewConnections::Add(tcp::ConnectionPtr connection) {
   bool result{connections_.emplace(connection, timer).second};
   assert(result);
   static_cast<void>(result);
+  return true;
 }
 
 bool NewConnections::Remove(tcp::ConnectionPtr connection) {
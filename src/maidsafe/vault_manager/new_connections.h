@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_NEW_CONNECTIONS_H_
 #define MAIDSAFE_VAULT_MANAGER_NEW_CONNECTIONS_H_
 
+#include <cstdint>
 #include <map>
 #include <memory>
 
@@ -34,17 +35,22 @@ namespace vault_manager {
 
 class NewConnections : public std::enable_shared_from_this<NewConnections> {
  public:
-  static std::shared_ptr<NewConnections> MakeShared(asio::io_service& io_service);
+  static std::shared_ptr<NewConnections> MakeShared(
+      asio::io_service& io_service, int max_pending_connections = kMaxPendingConnections);
   ~NewConnections();
-  void Add(tcp::ConnectionPtr connection);
+  // Returns false without adding 'connection' if doing so would exceed 'max_pending_connections'.
+  // The caller should then close the connection.
+  bool Add(tcp::ConnectionPtr connection);
   bool Remove(tcp::ConnectionPtr connection);
   void CloseAll();
 
  private:
-  explicit NewConnections(asio::io_service& io_service);
+  NewConnections(asio::io_service& io_service, int max_pending_connections);
 
   asio::io_service& io_service_;
+  const int kMaxPendingConnections_;
   std::map<tcp::ConnectionPtr, TimerPtr, std::owner_less<tcp::ConnectionPtr>> connections_;
+  std::uint64_t rejected_count_;
 };
 
 }  // namespace vault_manager
@@ -0,0 +1,129 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/process_launcher.h"
+
+#include <system_error>
+
+#ifndef MAIDSAFE_WIN32
+#include <spawn.h>
+#endif
+
+#ifdef MAIDSAFE_APPLE
+#include <crt_externs.h>
+#elif defined(MAIDSAFE_BSD)
+extern "C" char** environ;
+#endif
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4702)
+#endif
+#include "boost/process/execute.hpp"
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+#include "boost/process/initializers.hpp"
+#include "boost/tokenizer.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/on_scope_exit.h"
+#include "maidsafe/common/process.h"
+
+namespace bp = boost::process;
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+#ifndef MAIDSAFE_WIN32
+// Splits the command line in the same way as boost::process::initializers::set_cmd_line does on
+// POSIX, so both launch methods see identical argv arrays.
+std::vector<std::string> SplitCommandLine(const std::string& command_line) {
+  typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+  boost::escaped_list_separator<char> separator('\\', ' ', '\"');
+  Tokenizer tokenizer(command_line, separator);
+  return std::vector<std::string>(tokenizer.begin(), tokenizer.end());
+}
+
+char** GetEnvironment() {
+#ifdef MAIDSAFE_APPLE
+  return *_NSGetEnviron();
+#else
+  return environ;
+#endif
+}
+
+bp::child PosixSpawn(const fs::path& executable_path, const std::vector<std::string>& args) {
+  std::vector<std::string> split_args{SplitCommandLine(process::ConstructCommandLine(args))};
+  std::vector<char*> argv;
+  argv.reserve(split_args.size() + 1);
+  for (auto& arg : split_args)
+    argv.push_back(&arg[0]);
+  argv.push_back(nullptr);
+
+  posix_spawnattr_t attributes;
+  posix_spawnattr_init(&attributes);
+  on_scope_exit destroy_attributes{[&attributes] { posix_spawnattr_destroy(&attributes); }};
+#ifdef POSIX_SPAWN_USEVFORK
+  posix_spawnattr_setflags(&attributes, POSIX_SPAWN_USEVFORK);
+#endif
+
+  pid_t pid{0};
+  int result{posix_spawn(&pid, executable_path.c_str(), nullptr, &attributes, argv.data(),
+                         GetEnvironment())};
+  if (result != 0) {
+    std::error_code error_code{result, std::generic_category()};
+    LOG(kError) << "Failed to spawn " << executable_path << ": " << error_code.message();
+    BOOST_THROW_EXCEPTION(std::system_error(error_code));
+  }
+  return bp::child{pid};
+}
+#endif
+
+}  // unnamed namespace
+
+bp::child LaunchProcess(LaunchMethod launch_method, const fs::path& executable_path,
+                        const std::vector<std::string>& args, asio::io_service& io_service) {
+  if (launch_method == LaunchMethod::kPosixSpawn) {
+#ifdef MAIDSAFE_WIN32
+    LOG(kError) << "posix_spawn is not available on Windows.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+#else
+    return PosixSpawn(executable_path, args);
+#endif
+  }
+
+#ifdef MAIDSAFE_WIN32
+  static_cast<void>(io_service);
+#endif
+  return bp::execute(bp::initializers::run_exe(executable_path),
+                     bp::initializers::set_cmd_line(process::ConstructCommandLine(args)),
+#ifndef MAIDSAFE_WIN32
+                     bp::initializers::notify_io_service(io_service),
+#endif
+                     bp::initializers::throw_on_error(), bp::initializers::inherit_env());
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
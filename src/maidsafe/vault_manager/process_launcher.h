@@ -0,0 +1,58 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_PROCESS_LAUNCHER_H_
+#define MAIDSAFE_VAULT_MANAGER_PROCESS_LAUNCHER_H_
+
+#include <string>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/process/child.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// kExecute uses boost::process::execute, which fork()s the calling process before exec'ing.  The
+// cost of the fork grows with the size of the caller's address space.  kPosixSpawn uses
+// posix_spawn, which on Linux is implemented with clone(CLONE_VM | CLONE_VFORK) and so doesn't copy
+// the caller's page tables.  kPosixSpawn isn't available on Windows.
+enum class LaunchMethod { kExecute, kPosixSpawn };
+
+#ifdef MAIDSAFE_WIN32
+const LaunchMethod kDefaultLaunchMethod = LaunchMethod::kExecute;
+#else
+const LaunchMethod kDefaultLaunchMethod = LaunchMethod::kPosixSpawn;
+#endif
+
+// Starts 'executable_path' with the parent's environment.  'args' is the full command line
+// including the executable path as the first element; it is passed through
+// process::ConstructCommandLine and split in the same way for both launch methods.  Throws on
+// failure.
+boost::process::child LaunchProcess(LaunchMethod launch_method,
+                                    const boost::filesystem::path& executable_path,
+                                    const std::vector<std::string>& args,
+                                    asio::io_service& io_service);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_PROCESS_LAUNCHER_H_
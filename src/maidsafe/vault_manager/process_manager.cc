@@ -19,21 +19,9 @@
 #include "maidsafe/vault_manager/process_manager.h"
 
 #include <algorithm>
+#include <string>
 #include <type_traits>
 
-#ifdef MAIDSAFE_BSD
-extern "C" char** environ;
-#endif
-
-#ifdef _MSC_VER
-#pragma warning(push)
-#pragma warning(disable : 4702)
-#endif
-#include "boost/process/execute.hpp"
-#ifdef _MSC_VER
-#pragma warning(pop)
-#endif
-#include "boost/process/initializers.hpp"
 #include "boost/process/mitigate.hpp"
 #include "boost/process/terminate.hpp"
 #include "boost/process/wait_for_exit.hpp"
@@ -46,7 +34,9 @@ extern "C" char** environ;
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/visualiser_log.h"
 
+#include "maidsafe/vault_manager/tracing.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/heartbeat_request.h"
 #include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
 
 namespace bp = boost::process;
@@ -80,21 +70,79 @@ void CheckNewVaultDoesntConflict(const VaultInfo& new_vault, const VaultInfo& ex
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
   }
 
-  if (ConnectionsEqual(new_vault.tcp_connection, existing_vault.tcp_connection)) {
+  if (new_vault.tcp_connection &&
+      ConnectionsEqual(new_vault.tcp_connection, existing_vault.tcp_connection)) {
     LOG(kError) << "Vault process with this tcp_connection already exists.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
   }
 }
 
+void CheckVaultExecutable(const fs::path& vault_executable_path) {
+  boost::system::error_code ec;
+  if (!fs::exists(vault_executable_path, ec) || ec) {
+    LOG(kError) << vault_executable_path << " doesn't exist.  " << (ec ? ec.message() : "");
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (!fs::is_regular_file(vault_executable_path, ec) || ec) {
+    LOG(kError) << vault_executable_path << " is not a regular file.  " << (ec ? ec.message() : "");
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (fs::is_symlink(vault_executable_path, ec) || ec) {
+    LOG(kError) << vault_executable_path << " is a symlink.  " << (ec ? ec.message() : "");
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+}
+
+VaultEventType ToVaultEventType(EventType type) {
+  switch (type) {
+    case EventType::kStarting:
+      return VaultEventType::kSpawned;
+    case EventType::kRunning:
+      return VaultEventType::kConnected;
+    case EventType::kJoinedNetwork:
+      return VaultEventType::kJoinedNetwork;
+    case EventType::kStopping:
+      return VaultEventType::kStopping;
+    case EventType::kExited:
+      return VaultEventType::kStopped;
+    case EventType::kUnexpectedExit:
+      return VaultEventType::kExited;
+    case EventType::kTimedOut:
+      return VaultEventType::kTimedOut;
+    case EventType::kRestarting:
+      return VaultEventType::kRestarting;
+    default:
+      LOG(kError) << "Unknown event type " << type;
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+}
+
+// Replaces 'vault_info' with a modified copy, leaving any snapshots already handed out unchanged.
+template <typename Modify>
+const VaultInfoPtr& Update(VaultInfoPtr& vault_info, Modify modify) {
+  auto updated(std::make_shared<VaultInfo>(*vault_info));
+  modify(*updated);
+  vault_info = std::move(updated);
+  return vault_info;
+}
+
 }  // unnamed namespace
 
 ProcessManager::Child::Child(VaultInfo info, asio::io_service& io_service, int restarts)
-    : info(std::move(info)),
+    : info(std::make_shared<const VaultInfo>(std::move(info))),
       on_exit(),
       timer(maidsafe::make_unique<Timer>(io_service)),
       restart_count(restarts),
       process_args(),
       status(ProcessStatus::kBeforeStarted),
+      adopted(false),
+      start_time(),
+      running_time(),
+      heartbeat_sequence(0),
+      missed_heartbeats(0),
+      heartbeat_sent(),
+      heartbeat_rtt(-1),
+      statistics(),
 #ifdef MAIDSAFE_WIN32
       process(PROCESS_INFORMATION()),
       handle(io_service) {
@@ -111,6 +159,14 @@ ProcessManager::Child::Child(Child&& other)
       restart_count(std::move(other.restart_count)),
       process_args(std::move(other.process_args)),
       status(std::move(other.status)),
+      adopted(std::move(other.adopted)),
+      start_time(std::move(other.start_time)),
+      running_time(std::move(other.running_time)),
+      heartbeat_sequence(std::move(other.heartbeat_sequence)),
+      missed_heartbeats(std::move(other.missed_heartbeats)),
+      heartbeat_sent(std::move(other.heartbeat_sent)),
+      heartbeat_rtt(std::move(other.heartbeat_rtt)),
+      statistics(std::move(other.statistics)),
 #ifdef MAIDSAFE_WIN32
       process(std::move(other.process)),
       handle(std::move(other.handle)) {
@@ -133,6 +189,14 @@ void swap(ProcessManager::Child& lhs, ProcessManager::Child& rhs) {
   swap(lhs.restart_count, rhs.restart_count);
   swap(lhs.process_args, rhs.process_args);
   swap(lhs.status, rhs.status);
+  swap(lhs.adopted, rhs.adopted);
+  swap(lhs.start_time, rhs.start_time);
+  swap(lhs.running_time, rhs.running_time);
+  swap(lhs.heartbeat_sequence, rhs.heartbeat_sequence);
+  swap(lhs.missed_heartbeats, rhs.missed_heartbeats);
+  swap(lhs.heartbeat_sent, rhs.heartbeat_sent);
+  swap(lhs.heartbeat_rtt, rhs.heartbeat_rtt);
+  swap(lhs.statistics, rhs.statistics);
   swap(lhs.process, rhs.process);
 #ifdef MAIDSAFE_WIN32
   swap(lhs.handle, rhs.handle);
@@ -142,47 +206,71 @@ void swap(ProcessManager::Child& lhs, ProcessManager::Child& rhs) {
 
 
 ProcessManager::ProcessManager(asio::io_service& io_service, fs::path vault_executable_path,
-                               tcp::Port listening_port)
+                               tcp::Port listening_port, LaunchMethod launch_method)
     : io_service_(io_service),
 #ifndef MAIDSAFE_WIN32
       signal_set_(io_service_, SIGCHLD),
 #endif
       stop_all_flag_(),
       kListeningPort_(listening_port),
-      kVaultExecutablePath_(vault_executable_path),
-      vaults_() {
+      vault_executable_path_(vault_executable_path),
+      kLaunchMethod_(launch_method),
+      vaults_(),
+      standby_pool_size_(0),
+      standby_failures_(0),
+      on_standby_assigned_(),
+      standby_vaults_(),
+      event_log_(),
+      on_vault_event_(),
+      heartbeat_timer_(io_service_) {
   static_assert(std::is_same<ProcessId, process::ProcessId>::value,
                 "process::ProcessId is statically checked as being of suitable size for holding a "
                 "pid_t or DWORD, so vault_manager::ProcessId should use the same type.");
-  boost::system::error_code ec;
-  if (!fs::exists(kVaultExecutablePath_, ec) || ec) {
-    LOG(kError) << kVaultExecutablePath_ << " doesn't exist.  " << (ec ? ec.message() : "");
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
-  }
-  if (!fs::is_regular_file(kVaultExecutablePath_, ec) || ec) {
-    LOG(kError) << kVaultExecutablePath_ << " is not a regular file.  " << (ec ? ec.message() : "");
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
-  }
-  if (fs::is_symlink(kVaultExecutablePath_, ec) || ec) {
-    LOG(kError) << kVaultExecutablePath_ << " is a symlink.  " << (ec ? ec.message() : "");
-    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
-  }
+  CheckVaultExecutable(vault_executable_path_);
   InitSignalHandler();
+  ScheduleHeartbeat();
 }
 
 std::shared_ptr<ProcessManager> ProcessManager::MakeShared(
     asio::io_service& io_service, boost::filesystem::path vault_executable_path,
-    tcp::Port listening_port) {
+    tcp::Port listening_port, LaunchMethod launch_method) {
   return std::shared_ptr<ProcessManager>{
-      new ProcessManager{io_service, vault_executable_path, listening_port}};
+      new ProcessManager{io_service, vault_executable_path, listening_port, launch_method}};
 }
 
 ProcessManager::~ProcessManager() { assert(vaults_.empty()); }
 
+fs::path ProcessManager::VaultExecutablePath() const { return vault_executable_path_; }
+
+void ProcessManager::SetVaultExecutablePath(fs::path vault_executable_path) {
+  CheckVaultExecutable(vault_executable_path);
+  boost::system::error_code ec;
+  if (!fs::equivalent(vault_executable_path.parent_path(), vault_executable_path_.parent_path(),
+                      ec) || ec) {
+    LOG(kError) << vault_executable_path << " is not in the same directory as the current vault "
+                << "executable " << vault_executable_path_;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (vault_executable_path == vault_executable_path_)
+    return;
+  vault_executable_path_ = std::move(vault_executable_path);
+  LOG(kInfo) << "Vault executable set to " << vault_executable_path_;
+  // Standby processes are running the previous executable, so replace them.
+  if (!standby_vaults_.empty()) {
+    const int kPoolSize{standby_pool_size_};
+    StopStandbyProcesses();
+    standby_pool_size_ = kPoolSize;
+    standby_failures_ = 0;
+    ReplenishStandbyPool();
+  }
+}
+
 void ProcessManager::StopAll() {
   std::call_once(stop_all_flag_, [this] {
+    StopStandbyProcesses();
     for (const auto& vault : vaults_)
-      StopProcess(vault.info.tcp_connection);
+      StopProcess(vault.info->tcp_connection);
+    heartbeat_timer_.cancel();
 #ifndef MAIDSAFE_WIN32
     std::error_code ignored_ec;
     signal_set_.cancel(ignored_ec);
@@ -193,15 +281,39 @@ void ProcessManager::StopAll() {
 void ProcessManager::StopAllWithInterval() {
   int index(0);
   std::call_once(stop_all_flag_, [this, &index] {
+    StopStandbyProcesses();
     std::vector<tcp::ConnectionPtr> connections;
     for (const auto& vault : vaults_)
-      connections.push_back(vault.info.tcp_connection);
+      connections.push_back(vault.info->tcp_connection);
     for (const auto& connection : connections) {
       ++index;
       TLOG(kDefaultColour) << "stopping vault " << index << '\n';
       StopProcess(connection);
       Sleep(std::chrono::seconds(5));
     }
+    heartbeat_timer_.cancel();
+#ifndef MAIDSAFE_WIN32
+    std::error_code ignored_ec;
+    signal_set_.cancel(ignored_ec);
+#endif
+  });
+}
+
+void ProcessManager::ReleaseAll() {
+  std::call_once(stop_all_flag_, [this] {
+    StopStandbyProcesses();
+    // Remove the vaults before closing their connections so that the closures aren't treated as
+    // the vaults having failed.
+    std::vector<Child> released_vaults;
+    released_vaults.swap(vaults_);
+    for (auto& vault : released_vaults) {
+      vault.timer->cancel();
+      if (vault.info->tcp_connection)
+        vault.info->tcp_connection->Close();
+      LOG(kInfo) << "Released vault " << vault.info->label << " with process ID "
+                 << GetProcessId(vault);
+    }
+    heartbeat_timer_.cancel();
 #ifndef MAIDSAFE_WIN32
     std::error_code ignored_ec;
     signal_set_.cancel(ignored_ec);
@@ -209,14 +321,37 @@ void ProcessManager::StopAllWithInterval() {
   });
 }
 
-std::vector<VaultInfo> ProcessManager::GetAll() const {
-  std::vector<VaultInfo> all_vaults;
+void ProcessManager::SetStandbyPool(int pool_size, OnStandbyAssignedFunctor on_standby_assigned) {
+  if (pool_size < 0 || !on_standby_assigned) {
+    LOG(kError) << "Invalid standby pool parameters.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (on_standby_assigned_) {
+    LOG(kError) << "Standby pool has already been set.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
+  }
+  standby_pool_size_ = pool_size;
+  on_standby_assigned_ = std::move(on_standby_assigned);
+  ReplenishStandbyPool();
+}
+
+void ProcessManager::SetEventLog(std::shared_ptr<EventLog> event_log) {
+  event_log_ = std::move(event_log);
+}
+
+void ProcessManager::SetVaultEventFunctor(OnVaultEventFunctor on_vault_event) {
+  on_vault_event_ = std::move(on_vault_event);
+}
+
+std::vector<VaultInfoPtr> ProcessManager::GetAll() const {
+  std::vector<VaultInfoPtr> all_vaults;
   for (const auto& vault : vaults_)
     all_vaults.push_back(vault.info);
   return all_vaults;
 }
 
 void ProcessManager::AddProcess(VaultInfo info, int restart_count) {
+  VAULT_MANAGER_TRACE_SPAN("ProcessManager::AddProcess");
   if (info.vault_dir.empty() || !info.label.IsInitialised() || !info.pmid_and_signer) {
     LOG(kError) << "Can't add vault: vault_dir path and/or vault label and/or Pmid is empty.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
@@ -226,7 +361,16 @@ void ProcessManager::AddProcess(VaultInfo info, int restart_count) {
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
   }
   for (const auto& vault : vaults_)
-    CheckNewVaultDoesntConflict(info, vault.info);
+    CheckNewVaultDoesntConflict(info, *vault.info);
+  info.process_id = 0;
+  info.joined_network = false;
+  info.network_health = -1;
+
+  auto standby_itr(std::find_if(
+      std::begin(standby_vaults_), std::end(standby_vaults_),
+      [](const Child& standby) { return standby.status == ProcessStatus::kRunning; }));
+  if (standby_itr != std::end(standby_vaults_))
+    return AssignStandby(standby_itr, std::move(info), restart_count);
 
   // emplace offers strong exception guarantee - only need to cover subsequent calls.
   auto itr(vaults_.emplace(std::end(vaults_), Child{info, io_service_, restart_count}));
@@ -235,26 +379,182 @@ void ProcessManager::AddProcess(VaultInfo info, int restart_count) {
   strong_guarantee.Release();
 }
 
-VaultInfo ProcessManager::HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id) {
+bool ProcessManager::AdoptProcess(VaultInfo info) {
+  if (info.vault_dir.empty() || !info.label.IsInitialised() || !info.pmid_and_signer) {
+    LOG(kError) << "Can't adopt vault: vault_dir path and/or vault label and/or Pmid is empty.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  if (info.process_id == 0)
+    return false;
+  for (const auto& vault : vaults_)
+    CheckNewVaultDoesntConflict(info, *vault.info);
+
+  info.tcp_connection.reset();
+  // emplace offers strong exception guarantee - only need to cover subsequent calls.
+  auto itr(vaults_.emplace(std::end(vaults_), Child{info, io_service_, 0}));
+  on_scope_exit strong_guarantee{[this, itr] { vaults_.erase(itr); }};
+#ifdef MAIDSAFE_WIN32
+  HANDLE process_handle{OpenProcess(SYNCHRONIZE | PROCESS_QUERY_INFORMATION | PROCESS_TERMINATE,
+                                    FALSE, static_cast<DWORD>(info.process_id))};
+  if (!process_handle)
+    return false;
+  PROCESS_INFORMATION process_information{};
+  process_information.hProcess = process_handle;
+  process_information.dwProcessId = static_cast<DWORD>(info.process_id);
+  itr->process = bp::child(process_information);
+#else
+  itr->process = bp::child(static_cast<pid_t>(info.process_id));
+#endif
+  if (!IsRunning(*itr)) {
+    LOG(kInfo) << "Vault " << info.label << " with process ID " << info.process_id
+               << " is no longer running.";
+    return false;
+  }
+  itr->adopted = true;
+  itr->status = ProcessStatus::kStarting;
+  itr->start_time = std::chrono::steady_clock::now();
+  RecordEvent(*itr, EventType::kStarting);
+
+  NonEmptyString label{info.label};
+#ifdef MAIDSAFE_WIN32
+  HANDLE copied_handle;
+  DuplicateHandle(GetCurrentProcess(), itr->process.process_handle(), GetCurrentProcess(),
+                  &copied_handle, 0, FALSE, DUPLICATE_SAME_ACCESS);
+  itr->handle.assign(copied_handle);
+  HANDLE native_handle{itr->handle.native_handle()};
+  itr->handle.async_wait([this, label, native_handle](const std::error_code&) {
+    DWORD exit_code;
+    GetExitCodeProcess(native_handle, &exit_code);
+    OnProcessExit(label, BOOST_PROCESS_EXITSTATUS(exit_code), false);
+  });
+#endif
+  // Not being our child, we won't get SIGCHLD for an adopted process on POSIX systems, so its exit
+  // is detected via its TCP connection closing once it has reconnected.
+  itr->timer->expires_from_now(kVaultReconnectTimeout + kRpcTimeout);
+  itr->timer->async_wait([this, label](const std::error_code& error_code) {
+    if (error_code) {
+      if (error_code != asio::error::operation_aborted)
+        LOG(kError) << "Error waiting for adopted process to reconnect: " << error_code.message();
+      return;
+    }
+    OnAdoptionTimeout(label);
+  });
+  strong_guarantee.Release();
+  LOG(kInfo) << "Waiting for vault " << label << " with process ID " << info.process_id
+             << " to reconnect.";
+  return true;
+}
+
+VaultInfoPtr ProcessManager::FindAwaitingAdoption(ProcessId process_id) const {
   auto itr(
       std::find_if(std::begin(vaults_), std::end(vaults_), [this, process_id](const Child& vault) {
-        return GetProcessId(vault) == process_id;
+        return vault.adopted && vault.status == ProcessStatus::kStarting &&
+               GetProcessId(vault) == process_id;
       }));
   if (itr == std::end(vaults_)) {
-    LOG(kError) << "Failed to find vault with process ID " << process_id << " in child processes.";
+    LOG(kError) << "No adopted vault with process ID " << process_id << " awaiting reconnection.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
   }
+  return itr->info;
+}
+
+VaultInfoPtr ProcessManager::HandleVaultAdopted(tcp::ConnectionPtr connection,
+                                                ProcessId process_id) {
+  auto itr(DoFind(FindAwaitingAdoption(process_id)->label));
   itr->timer->cancel();
-  itr->info.tcp_connection = connection;
+  Update(itr->info, [&](VaultInfo& info) { info.tcp_connection = connection; });
   itr->status = ProcessStatus::kRunning;
+  itr->running_time = std::chrono::steady_clock::now();
+  RecordEvent(*itr, EventType::kRunning, 0, itr->start_time);
+  LOG(kSuccess) << "Adopted vault " << itr->info->label << " with process ID " << process_id;
+  return itr->info;
+}
+
+VaultInfoPtr ProcessManager::HandleVaultStarted(tcp::ConnectionPtr connection,
+                                                ProcessId process_id) {
+  // Adopted processes must prove their identity via HandleVaultAdopted instead.
+  auto itr(
+      std::find_if(std::begin(vaults_), std::end(vaults_), [this, process_id](const Child& vault) {
+        return !vault.adopted && GetProcessId(vault) == process_id;
+      }));
+  if (itr == std::end(vaults_)) {
+    itr = std::find_if(
+        std::begin(standby_vaults_), std::end(standby_vaults_),
+        [this, process_id](const Child& standby) { return GetProcessId(standby) == process_id; });
+    if (itr == std::end(standby_vaults_)) {
+      LOG(kError) << "Failed to find vault with process ID " << process_id
+                  << " in child processes.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+    }
+    standby_failures_ = 0;
+    LOG(kInfo) << "Standby vault process " << process_id << " is ready.";
+  }
+  itr->timer->cancel();
+  Update(itr->info, [&](VaultInfo& info) {
+    info.tcp_connection = connection;
+    if (info.label.IsInitialised())
+      info.process_id = process_id;
+  });
+  itr->status = ProcessStatus::kRunning;
+  itr->running_time = std::chrono::steady_clock::now();
+  RecordEvent(*itr, EventType::kRunning, 0, itr->start_time);
   return itr->info;
 }
 
 void ProcessManager::AssignOwner(const NonEmptyString& label, const Identity& owner_name,
                                  DiskUsage max_disk_usage) {
   auto itr(DoFind(label));
-  itr->info.owner_name = owner_name;
-  itr->info.max_disk_usage = max_disk_usage;
+  Update(itr->info, [&](VaultInfo& info) {
+    info.owner_name = owner_name;
+    info.max_disk_usage = max_disk_usage;
+  });
+}
+
+VaultInfoPtr ProcessManager::SetJoinedNetwork(tcp::ConnectionPtr connection) {
+  auto itr(DoFind(connection));
+  if (itr->info->joined_network)
+    return itr->info;
+  RecordEvent(*itr, EventType::kJoinedNetwork, 0, itr->start_time);
+  return Update(itr->info, [](VaultInfo& info) { info.joined_network = true; });
+}
+
+VaultInfoPtr ProcessManager::SetNetworkHealth(tcp::ConnectionPtr connection, int network_health) {
+  auto itr(DoFind(connection));
+  if (itr->info->network_health == network_health)
+    return itr->info;
+  return Update(itr->info, [network_health](VaultInfo& info) {
+    info.network_health = network_health;
+  });
+}
+
+void ProcessManager::HandleHeartbeatResponse(tcp::ConnectionPtr connection, uint32_t sequence) {
+  auto itr(DoFind(connection));
+  if (sequence != itr->heartbeat_sequence ||
+      itr->heartbeat_sent == std::chrono::steady_clock::time_point()) {
+    return;
+  }
+  itr->missed_heartbeats = 0;
+  auto rtt(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                 itr->heartbeat_sent));
+  itr->heartbeat_sent = std::chrono::steady_clock::time_point();
+  // Exponentially-weighted moving average, so that a single slow reply doesn't dominate.
+  if (itr->heartbeat_rtt.count() < 0)
+    itr->heartbeat_rtt = rtt;
+  else
+    itr->heartbeat_rtt = (itr->heartbeat_rtt * 7 + rtt) / 8;
+}
+
+void ProcessManager::SetStatistics(tcp::ConnectionPtr connection, VaultStatistics statistics) {
+  DoFind(connection)->statistics = std::move(statistics);
+}
+
+std::vector<std::pair<VaultInfoPtr, VaultStatistics>> ProcessManager::GetAllStatistics() const {
+  std::vector<std::pair<VaultInfoPtr, VaultStatistics>> all_statistics;
+  for (const auto& vault : vaults_) {
+    if (vault.statistics)
+      all_statistics.emplace_back(vault.info, *vault.statistics);
+  }
+  return all_statistics;
 }
 
 void ProcessManager::StartProcess(std::vector<Child>::iterator itr) {
@@ -263,20 +563,41 @@ void ProcessManager::StartProcess(std::vector<Child>::iterator itr) {
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::already_initialised));
   }
 
-  std::vector<std::string> args{1, kVaultExecutablePath_.string()};
+  // Standby processes don't have a label or vault_dir until they're assigned a vault.
+  bool standby{!itr->info->label.IsInitialised()};
+  std::vector<std::string> args{1, vault_executable_path_.string()};
   args.emplace_back(std::to_string(kListeningPort_));
-  args.emplace_back("--log_folder " + (itr->info.vault_dir / "logs").string());
+  if (!standby)
+    args.emplace_back("--log_folder " + (itr->info->vault_dir / "logs").string());
   args.insert(std::end(args), std::begin(itr->process_args), std::end(itr->process_args));
 
-  NonEmptyString label{itr->info.label};
-  itr->process = bp::execute(bp::initializers::run_exe(kVaultExecutablePath_),
-                             bp::initializers::set_cmd_line(process::ConstructCommandLine(args)),
-#ifndef MAIDSAFE_WIN32
-                             bp::initializers::notify_io_service(io_service_),
-#endif
-                             bp::initializers::throw_on_error(), bp::initializers::inherit_env());
+  {
+    VAULT_MANAGER_TRACE_SPAN("LaunchProcess");
+    itr->process = LaunchProcess(kLaunchMethod_, vault_executable_path_, args, io_service_);
+  }
 
   itr->status = ProcessStatus::kStarting;
+  itr->start_time = std::chrono::steady_clock::now();
+  RecordEvent(*itr, EventType::kStarting);
+
+  std::function<void(int, bool)> on_exit;
+  if (standby) {
+    // The process may have been assigned a vault (and moved to 'vaults_') by the time it exits.
+    ProcessId process_id{GetProcessId(*itr)};
+    on_exit = [this, process_id](int exit_code, bool terminate) {
+      auto child_itr(std::find_if(
+          std::begin(vaults_), std::end(vaults_),
+          [this, process_id](const Child& vault) { return GetProcessId(vault) == process_id; }));
+      if (child_itr != std::end(vaults_))
+        return OnProcessExit(child_itr->info->label, exit_code, terminate);
+      OnStandbyProcessExit(process_id, exit_code, terminate);
+    };
+  } else {
+    NonEmptyString label{itr->info->label};
+    on_exit = [this, label](int exit_code, bool terminate) {
+      OnProcessExit(label, exit_code, terminate);
+    };
+  }
 
 #ifdef MAIDSAFE_WIN32
   HANDLE copied_handle;
@@ -284,25 +605,88 @@ void ProcessManager::StartProcess(std::vector<Child>::iterator itr) {
                   &copied_handle, 0, FALSE, DUPLICATE_SAME_ACCESS);
   itr->handle.assign(copied_handle);
   HANDLE native_handle{itr->handle.native_handle()};
-  itr->handle.async_wait([this, label, native_handle](const std::error_code&) {
+  itr->handle.async_wait([on_exit, native_handle](const std::error_code&) {
     DWORD exit_code;
     GetExitCodeProcess(native_handle, &exit_code);
-    OnProcessExit(label, BOOST_PROCESS_EXITSTATUS(exit_code));
+    on_exit(BOOST_PROCESS_EXITSTATUS(exit_code), false);
   });
 #endif
 
+  const VaultInfoPtr kInfo(itr->info);
+  const ProcessId kProcessId(GetProcessId(*itr));
   itr->timer->expires_from_now(kRpcTimeout);
-  itr->timer->async_wait([this, label](const std::error_code& error_code) {
+  itr->timer->async_wait([this, on_exit, kInfo, kProcessId](const std::error_code& error_code) {
     if (error_code) {
       if (error_code != asio::error::operation_aborted)
         LOG(kError) << "Error waiting for new process to connect via TCP: " << error_code.message();
       return;
     }
     LOG(kWarning) << "Timed out waiting for new process to connect via TCP.";
-    OnProcessExit(label, -1, true);
+    RecordEvent(*kInfo, kProcessId, EventType::kTimedOut);
+    on_exit(-1, true);
   });
 }
 
+void ProcessManager::StartStandbyProcess() {
+  // emplace offers strong exception guarantee - only need to cover subsequent calls.
+  auto itr(standby_vaults_.emplace(std::end(standby_vaults_), Child{VaultInfo{}, io_service_, 0}));
+  on_scope_exit strong_guarantee{[this, itr] { standby_vaults_.erase(itr); }};
+  itr->process_args.emplace_back(kStandbyVaultArg);
+  StartProcess(itr);
+  strong_guarantee.Release();
+}
+
+void ProcessManager::ReplenishStandbyPool() {
+  while (static_cast<int>(standby_vaults_.size()) < standby_pool_size_) {
+    try {
+      StartStandbyProcess();
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to start standby vault process: " << boost::diagnostic_information(e);
+      return;
+    }
+  }
+}
+
+void ProcessManager::AssignStandby(std::vector<Child>::iterator standby_itr, VaultInfo info,
+                                   int restart_count) {
+  // emplace offers strong exception guarantee, and nothing after it can throw.
+  vaults_.emplace_back(VaultInfo{}, io_service_, restart_count);
+  swap(vaults_.back(), *standby_itr);
+  standby_vaults_.erase(standby_itr);
+
+  // The process keeps the args it was launched with, so it won't log to info.vault_dir / "logs".
+  Child& vault(vaults_.back());
+  info.tcp_connection = vault.info->tcp_connection;
+  info.process_id = GetProcessId(vault);
+  vault.info = std::make_shared<const VaultInfo>(std::move(info));
+  vault.restart_count = restart_count;
+  // The standby process is already connected, so the vault is running as soon as it's assigned.
+  vault.start_time = vault.running_time = std::chrono::steady_clock::now();
+  RecordEvent(vault, EventType::kRunning);
+  LOG(kInfo) << "Assigned vault " << vault.info->label << " to standby process "
+             << GetProcessId(vault);
+
+  try {
+    on_standby_assigned_(vault.info);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Error executing on_standby_assigned functor: "
+                << boost::diagnostic_information(e);
+  }
+  io_service_.post([this] { ReplenishStandbyPool(); });
+}
+
+void ProcessManager::StopStandbyProcesses() {
+  standby_pool_size_ = 0;
+  for (auto itr(std::begin(standby_vaults_)); itr != std::end(standby_vaults_); ++itr) {
+    itr->timer->cancel();
+    if (itr->info->tcp_connection)
+      itr->info->tcp_connection->Close();
+    if (IsRunning(*itr))
+      TerminateProcess(itr);
+  }
+  standby_vaults_.clear();
+}
+
 void ProcessManager::InitSignalHandler() {
 #ifndef MAIDSAFE_WIN32
   signal_set_.async_wait([this](const std::error_code& error_code, int signum) {
@@ -329,14 +713,23 @@ void ProcessManager::InitSignalHandler() {
     auto child_itr(std::find_if(
         std::begin(vaults_), std::end(vaults_),
         [this, process_id](const Child& vault) { return GetProcessId(vault) == process_id; }));
-    if (child_itr == std::end(vaults_))
+    if (child_itr == std::end(vaults_)) {
+#ifdef __GNUC__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wold-style-cast"
+#endif
+      OnStandbyProcessExit(process_id, BOOST_PROCESS_EXITSTATUS(exit_code));
+#ifdef __GNUC__
+#pragma GCC diagnostic pop
+#endif
       return;
+    }
 
 #ifdef __GNUC__
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 #endif
-    OnProcessExit(child_itr->info.label, BOOST_PROCESS_EXITSTATUS(exit_code));
+    OnProcessExit(child_itr->info->label, BOOST_PROCESS_EXITSTATUS(exit_code));
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
@@ -344,6 +737,49 @@ void ProcessManager::InitSignalHandler() {
 #endif
 }
 
+void ProcessManager::ScheduleHeartbeat() {
+  heartbeat_timer_.expires_from_now(kHeartbeatInterval);
+  heartbeat_timer_.async_wait([this](const std::error_code& error_code) {
+    if (error_code) {
+      if (error_code != asio::error::operation_aborted)
+        LOG(kError) << "Error waiting for heartbeat timer: " << error_code.message();
+      return;
+    }
+    SendHeartbeats();
+    ScheduleHeartbeat();
+  });
+}
+
+void ProcessManager::SendHeartbeats() {
+  std::vector<NonEmptyString> unresponsive_vaults;
+  const auto kNow(std::chrono::steady_clock::now());
+  for (auto& vault : vaults_) {
+    if (vault.status != ProcessStatus::kRunning || !vault.info->tcp_connection)
+      continue;
+    if (vault.heartbeat_sent != std::chrono::steady_clock::time_point() &&
+        ++vault.missed_heartbeats >= kMaxMissedHeartbeats) {
+      unresponsive_vaults.push_back(vault.info->label);
+      continue;
+    }
+    vault.heartbeat_sent = kNow;
+    try {
+      Send(vault.info->tcp_connection, HeartbeatRequest(++vault.heartbeat_sequence));
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to send heartbeat to vault " << vault.info->label << ": "
+                    << boost::diagnostic_information(e);
+    }
+  }
+
+  // A running vault failing to answer is treated as an unexpected exit, so it gets restarted.
+  for (const auto& label : unresponsive_vaults) {
+    auto itr(DoFind(label));
+    LOG(kWarning) << "Vault " << label << " missed " << itr->missed_heartbeats
+                  << " heartbeats; terminating now.";
+    RecordEvent(*itr, EventType::kTimedOut);
+    OnProcessExit(label, -1, true);
+  }
+}
+
 void ProcessManager::StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on_exit_functor) {
   auto itr(std::begin(vaults_));
   try {
@@ -354,23 +790,57 @@ void ProcessManager::StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on
   }
   itr->on_exit = on_exit_functor;
   itr->status = ProcessStatus::kStopping;
-  Send(itr->info.tcp_connection, VaultShutdownRequest());
-  NonEmptyString label{itr->info.label};
+  RecordEvent(*itr, EventType::kStopping);
+  // The process is exiting, so a subsequent VaultManager mustn't try to adopt it (see ReleaseAll).
+  VaultInfo info{*itr->info};
+  info.process_id = 0;
+  itr->info = std::make_shared<const VaultInfo>(std::move(info));
+  Send(itr->info->tcp_connection, VaultShutdownRequest());
+  NonEmptyString label{itr->info->label};
+  const VaultInfoPtr kInfo(itr->info);
+  const ProcessId kProcessId(GetProcessId(*itr));
   itr->timer->expires_from_now(kVaultStopTimeout);
-  itr->timer->async_wait([this, label](const std::error_code& error_code) {
+  itr->timer->async_wait([this, label, kInfo, kProcessId](const std::error_code& error_code) {
     if (error_code) {
       if (error_code != asio::error::operation_aborted)
         LOG(kError) << "Error waiting for Vault to stop: " << error_code.message();
       return;
     }
     LOG(kWarning) << "Timed out waiting for Vault to stop; terminating now.";
+    RecordEvent(*kInfo, kProcessId, EventType::kTimedOut);
     OnProcessExit(label, -1, true);
   });
 }
 
+void ProcessManager::StopProcess(const NonEmptyString& label, OnExitFunctor on_exit_functor) {
+  auto itr(DoFind(label));
+  if (itr->status == ProcessStatus::kStopping) {
+    LOG(kError) << "Vault " << label << " is already being stopped.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+  }
+  if (itr->info->tcp_connection)
+    return StopProcess(itr->info->tcp_connection, on_exit_functor);
+
+  // It can't be asked to shut down.  An adopted process which hasn't reconnected can't be confirmed
+  // as being a vault, so isn't terminated.
+  itr->on_exit = on_exit_functor;
+  itr->status = ProcessStatus::kStopping;
+  RecordEvent(*itr, EventType::kStopping);
+  OnProcessExit(label, -1, !itr->adopted);
+}
+
 bool ProcessManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
+  auto standby_itr(std::find_if(std::begin(standby_vaults_), std::end(standby_vaults_),
+                                [connection](const Child& standby) {
+    return ConnectionsEqual(standby.info->tcp_connection, connection);
+  }));
+  if (standby_itr != std::end(standby_vaults_)) {
+    OnStandbyProcessExit(GetProcessId(*standby_itr), -1, true);
+    return true;
+  }
+
   try {
-    OnProcessExit(DoFind(connection)->info.label, -1, true);
+    OnProcessExit(DoFind(connection)->info->label, -1, true);
   } catch (const maidsafe_error& error) {
     if (error.code() == make_error_code(CommonErrors::no_such_element))
       return false;
@@ -379,12 +849,15 @@ bool ProcessManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
   return true;
 }
 
-VaultInfo ProcessManager::Find(const NonEmptyString& label) const { return DoFind(label)->info; }
+VaultInfoPtr ProcessManager::Find(const NonEmptyString& label) const {
+  return DoFind(label)->info;
+}
 
 std::vector<ProcessManager::Child>::const_iterator ProcessManager::DoFind(
     const NonEmptyString& label) const {
+  VAULT_MANAGER_TRACE_SPAN("ProcessManager::DoFind");
   auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
-                        [this, &label](const Child& vault) { return vault.info.label == label; }));
+                        [this, &label](const Child& vault) { return vault.info->label == label; }));
   if (itr == std::end(vaults_)) {
     LOG(kError) << "Vault process with label " << label << " doesn't exist.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
@@ -393,8 +866,9 @@ std::vector<ProcessManager::Child>::const_iterator ProcessManager::DoFind(
 }
 
 std::vector<ProcessManager::Child>::iterator ProcessManager::DoFind(const NonEmptyString& label) {
+  VAULT_MANAGER_TRACE_SPAN("ProcessManager::DoFind");
   auto itr(std::find_if(std::begin(vaults_), std::end(vaults_),
-                        [this, &label](const Child& vault) { return vault.info.label == label; }));
+                        [this, &label](const Child& vault) { return vault.info->label == label; }));
   if (itr == std::end(vaults_)) {
     LOG(kError) << "Vault process with label " << label << " doesn't exist.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
@@ -402,15 +876,67 @@ std::vector<ProcessManager::Child>::iterator ProcessManager::DoFind(const NonEmp
   return itr;
 }
 
-VaultInfo ProcessManager::Find(tcp::ConnectionPtr connection) const {
+VaultInfoPtr ProcessManager::Find(tcp::ConnectionPtr connection) const {
   return DoFind(connection)->info;
 }
 
+VaultList ProcessManager::ListVaults(const Identity& owner_name,
+                                     const ListVaultsQuery& query) const {
+  VAULT_MANAGER_TRACE_SPAN("ProcessManager::ListVaults");
+  // A host only runs a handful of vaults, and 'vaults_' is searched linearly throughout, so rather
+  // than maintaining a separate index the matches are found with a single pass.  They're ordered by
+  // label so that pages are stable regardless of the order in which vaults were added, but only
+  // the first page's worth are sorted.
+  std::vector<const Child*> matches;
+  for (const auto& vault : vaults_) {
+    if (!(vault.info->owner_name == owner_name))
+      continue;
+    const std::string& label(vault.info->label.string());
+    if (!query.page_token.empty() && label <= query.page_token)
+      continue;
+    if (label.compare(0, query.label_prefix.size(), query.label_prefix) != 0)
+      continue;
+    if (!query.statuses.empty() &&
+        std::find(std::begin(query.statuses), std::end(query.statuses), vault.status) ==
+            std::end(query.statuses)) {
+      continue;
+    }
+    matches.push_back(&vault);
+  }
+
+  std::size_t page_size(kMaxListVaultsPageSize);
+  if (query.max_results != 0)
+    page_size = std::min(page_size, static_cast<std::size_t>(query.max_results));
+  auto page_end(matches.begin() + std::min(page_size, matches.size()));
+  std::partial_sort(matches.begin(), page_end, matches.end(),
+                    [](const Child* lhs, const Child* rhs) {
+                      return lhs->info->label.string() < rhs->info->label.string();
+                    });
+  VaultList vault_list;
+  for (auto itr(matches.begin()); itr != page_end; ++itr) {
+    const Child& vault(**itr);
+    VaultSummary summary;
+    summary.label = vault.info->label;
+    summary.vault_dir = vault.info->vault_dir.string();
+    summary.process_id = GetProcessId(vault);
+    summary.status = vault.status;
+    summary.joined_network = vault.info->joined_network;
+    summary.network_health = vault.info->network_health;
+    summary.heartbeat_rtt_microseconds = vault.heartbeat_rtt.count();
+    summary.restart_count = vault.restart_count;
+    vault_list.vaults.push_back(std::move(summary));
+  }
+  if (page_end != matches.end())
+    vault_list.next_page_token = vault_list.vaults.back().label.string();
+  return vault_list;
+}
+
 std::vector<ProcessManager::Child>::const_iterator ProcessManager::DoFind(
     tcp::ConnectionPtr connection) const {
+  VAULT_MANAGER_TRACE_SPAN("ProcessManager::DoFind");
   auto itr(
       std::find_if(std::begin(vaults_), std::end(vaults_), [this, connection](const Child& vault) {
-        return ConnectionsEqual(vault.info.tcp_connection, connection);
+        return ConnectionsEqual(vault.info->tcp_connection, connection);
       }));
   if (itr == std::end(vaults_))
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
@@ -418,9 +944,10 @@ std::vector<ProcessManager::Child>::const_iterator ProcessManager::DoFind(
 }
 
 std::vector<ProcessManager::Child>::iterator ProcessManager::DoFind(tcp::ConnectionPtr connection) {
+  VAULT_MANAGER_TRACE_SPAN("ProcessManager::DoFind");
   auto itr(
       std::find_if(std::begin(vaults_), std::end(vaults_), [this, connection](const Child& vault) {
-        return ConnectionsEqual(vault.info.tcp_connection, connection);
+        return ConnectionsEqual(vault.info->tcp_connection, connection);
       }));
   if (itr == std::end(vaults_))
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
@@ -451,7 +978,7 @@ bool ProcessManager::IsRunning(const Child& vault) const {
 void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, bool terminate) {
   auto child_itr(
       std::find_if(std::begin(vaults_), std::end(vaults_),
-                   [this, &label](const Child& vault) { return vault.info.label == label; }));
+                   [this, &label](const Child& vault) { return vault.info->label == label; }));
   if (child_itr == std::end(vaults_))
     return;
 
@@ -459,7 +986,7 @@ void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, b
   int restart_count{-1};
   if (child_itr->status != ProcessStatus::kStopping) {  // Unexpected exit - try to restart.
     restart_count = child_itr->restart_count;
-    vault_info = child_itr->info;
+    vault_info = *child_itr->info;
     LOG(kError) << "Vault " << vault_info.pmid_and_signer->first.name() << " stopped unexpectedly";
 #ifdef USE_VLOGGING
     log::VisualiserLogMessage::SendVaultStoppedMessage(
@@ -472,12 +999,16 @@ void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, b
     }
   }
 
+  const bool kHasRun(child_itr->running_time != std::chrono::steady_clock::time_point());
+  RecordEvent(*child_itr, restart_count < 0 ? EventType::kExited : EventType::kUnexpectedExit,
+              exit_code, kHasRun ? child_itr->running_time : child_itr->start_time);
+
   bool is_running{IsRunning(*child_itr)};
   if (terminate && is_running)
     TerminateProcess(child_itr);
 
-  if (child_itr->info.tcp_connection)
-    child_itr->info.tcp_connection->Close();
+  if (child_itr->info->tcp_connection)
+    child_itr->info->tcp_connection->Close();
 
   OnExitFunctor on_exit{child_itr->on_exit};
   vaults_.erase(child_itr);
@@ -486,6 +1017,53 @@ void ProcessManager::OnProcessExit(const NonEmptyString& label, int exit_code, b
   RestartIfRequired(restart_count, std::move(vault_info));
 }
 
+void ProcessManager::OnStandbyProcessExit(ProcessId process_id, int exit_code, bool terminate) {
+  auto standby_itr(std::find_if(
+      std::begin(standby_vaults_), std::end(standby_vaults_),
+      [this, process_id](const Child& standby) { return GetProcessId(standby) == process_id; }));
+  if (standby_itr == std::end(standby_vaults_))
+    return;
+
+  LOG(kWarning) << "Standby vault process " << process_id << " exited with code " << exit_code;
+  // A standby which had connected may simply have timed out waiting to be assigned a vault.
+  bool failed_to_connect{standby_itr->status != ProcessStatus::kRunning};
+  standby_itr->timer->cancel();
+  if (terminate && IsRunning(*standby_itr))
+    TerminateProcess(standby_itr);
+  if (standby_itr->info->tcp_connection)
+    standby_itr->info->tcp_connection->Close();
+  standby_vaults_.erase(standby_itr);
+
+  if (failed_to_connect && ++standby_failures_ > kMaxVaultRestarts) {
+    LOG(kError) << "Too many consecutive standby vault failures - no longer maintaining pool.";
+    standby_pool_size_ = 0;
+    return;
+  }
+  io_service_.post([this] { ReplenishStandbyPool(); });
+}
+
+void ProcessManager::OnAdoptionTimeout(const NonEmptyString& label) {
+  auto child_itr(
+      std::find_if(std::begin(vaults_), std::end(vaults_),
+                   [this, &label](const Child& vault) { return vault.info->label == label; }));
+  if (child_itr == std::end(vaults_) || !child_itr->adopted ||
+      child_itr->status != ProcessStatus::kStarting) {
+    return;
+  }
+  LOG(kWarning) << "Timed out waiting for adopted vault " << label << " to reconnect; starting a "
+                << "new process for it.";
+  VaultInfo vault_info{*child_itr->info};
+  vault_info.process_id = 0;
+  vaults_.erase(child_itr);
+  io_service_.post([vault_info, this] {
+    try {
+      AddProcess(std::move(vault_info));
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed restarting vault: " << boost::diagnostic_information(e);
+    }
+  });
+}
+
 void ProcessManager::TerminateProcess(std::vector<Child>::iterator itr) {
   boost::system::error_code ec;
   bp::terminate(itr->process, ec);
@@ -516,6 +1094,7 @@ void ProcessManager::RestartIfRequired(int restart_count, VaultInfo vault_info)
     return;
 
   LOG(kWarning) << "Restarting vault " << vault_info.label;
+  RecordEvent(vault_info, vault_info.process_id, EventType::kRestarting);
   io_service_.post([vault_info, restart_count, this] {
     try {
       AddProcess(std::move(vault_info), restart_count + 1);
@@ -525,6 +1104,36 @@ void ProcessManager::RestartIfRequired(int restart_count, VaultInfo vault_info)
   });
 }
 
+void ProcessManager::RecordEvent(const Child& vault, EventType type, int exit_code,
+                                 std::chrono::steady_clock::time_point since) const {
+  std::chrono::microseconds latency(0);
+  if (since != std::chrono::steady_clock::time_point())
+    latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since);
+  RecordEvent(*vault.info, GetProcessId(vault), type, exit_code, latency);
+}
+
+void ProcessManager::RecordEvent(const VaultInfo& info, ProcessId process_id, EventType type,
+                                 int exit_code, std::chrono::microseconds latency) const {
+  if (!info.label.IsInitialised())
+    return;
+  if (event_log_)
+    event_log_->Record(type, info.label.string(), process_id, exit_code, latency);
+  if (!on_vault_event_)
+    return;
+  VaultEvent event;
+  event.label = info.label;
+  event.type = ToVaultEventType(type);
+  event.process_id = process_id;
+  event.exit_code = exit_code;
+  event.latency_microseconds = latency.count();
+  try {
+    on_vault_event_(info.owner_name, std::move(event));
+  } catch (const std::exception& e) {
+    LOG(kError) << "Error executing on_vault_event functor: " << boost::diagnostic_information(e);
+  }
+}
+
 }  // namespace vault_manager
 
 }  // namespace maidsafe
@@ -19,11 +19,13 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_PROCESS_MANAGER_H_
 #define MAIDSAFE_VAULT_MANAGER_PROCESS_MANAGER_H_
 
+#include <chrono>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "asio/io_service.hpp"
@@ -33,6 +35,7 @@
 #include "asio/signal_set.hpp"
 #endif
 #include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
 #include "boost/process/child.hpp"
 
 #include "maidsafe/common/error.h"
@@ -42,7 +45,12 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/event_log.h"
+#include "maidsafe/vault_manager/process_launcher.h"
+#include "maidsafe/vault_manager/vault_event.h"
 #include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/vault_statistics.h"
+#include "maidsafe/vault_manager/vault_summary.h"
 
 namespace maidsafe {
 
@@ -50,48 +58,109 @@ namespace vault_manager {
 
 typedef uint64_t ProcessId;
 
-enum class ProcessStatus { kBeforeStarted, kStarting, kRunning, kStopping };
-
 // All functions provide the strong exception guarantee.
 class ProcessManager {
  public:
   typedef std::function<void(maidsafe_error, int)> OnExitFunctor;
+  typedef std::function<void(VaultInfoPtr)> OnStandbyAssignedFunctor;
+  typedef std::function<void(const Identity& owner_name, VaultEvent event)> OnVaultEventFunctor;
 
   ProcessManager(const ProcessManager&) = delete;
   ProcessManager(ProcessManager&&) = delete;
   ProcessManager& operator=(ProcessManager) = delete;
 
-  static std::shared_ptr<ProcessManager> MakeShared(asio::io_service& io_service,
-                                                    boost::filesystem::path vault_executable_path,
-                                                    tcp::Port listening_port);
+  static std::shared_ptr<ProcessManager> MakeShared(
+      asio::io_service& io_service, boost::filesystem::path vault_executable_path,
+      tcp::Port listening_port, LaunchMethod launch_method = kDefaultLaunchMethod);
   ~ProcessManager();
+  // Vaults asked to stop have their process IDs cleared, so GetAll no longer offers them for
+  // adoption.
   void StopAll();
   void StopAllWithInterval();
-  std::vector<VaultInfo> GetAll() const;
+  // Closes the connections to all vaults without stopping them, so that they can be adopted by a
+  // subsequent ProcessManager instance.  The process IDs are kept.  Standby processes are stopped.
+  void ReleaseAll();
+  // Keeps 'pool_size' vault processes started and connected, but not yet assigned a config.  When a
+  // vault is subsequently added (including a restart after an unexpected exit), a ready standby
+  // process is given the new vault's details and 'on_standby_assigned' is invoked so the config can
+  // be sent to it, avoiding the cost of starting a new process.  Should only be called once.
+  void SetStandbyPool(int pool_size, OnStandbyAssignedFunctor on_standby_assigned);
+  // Lifecycle events of vaults (not standby processes) are recorded to 'event_log' if non-null.
+  void SetEventLog(std::shared_ptr<EventLog> event_log);
+  // 'on_vault_event' is also invoked for each lifecycle event of vaults, along with the vault's
+  // owner (uninitialised if it has none).
+  void SetVaultEventFunctor(OnVaultEventFunctor on_vault_event);
+  // Only affects vaults started after this call; running vaults are unaffected, but standby
+  // processes are replaced.  To avoid clients being able to run arbitrary executables, the new path
+  // must be in the same directory as the current one.
+  void SetVaultExecutablePath(boost::filesystem::path vault_executable_path);
+  boost::filesystem::path VaultExecutablePath() const;
+  std::vector<VaultInfoPtr> GetAll() const;
   void AddProcess(VaultInfo info, int restart_count = 0);
-  VaultInfo HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id);
+  // Tracks the vault process identified by 'info.process_id' which was left running by a previous
+  // VaultManager instance.  Returns false if there is no such running process.  The vault is
+  // expected to reconnect and prove its identity (see HandleVaultAdopted).  If it hasn't done so
+  // within kVaultReconnectTimeout, the process is forgotten (not terminated, since it can't be
+  // confirmed as being a vault) and a new one is started in its place.
+  bool AdoptProcess(VaultInfo info);
+  // Returns the details of the adopted vault with 'process_id' which hasn't yet reconnected.
+  VaultInfoPtr FindAwaitingAdoption(ProcessId process_id) const;
+  VaultInfoPtr HandleVaultStarted(tcp::ConnectionPtr connection, ProcessId process_id);
+  // Should only be called once the reconnected vault has proven its identity.
+  VaultInfoPtr HandleVaultAdopted(tcp::ConnectionPtr connection, ProcessId process_id);
   void AssignOwner(const NonEmptyString& label, const Identity& owner_name,
                    DiskUsage max_disk_usage);
+  // Record the network status reported by the vault on 'connection' and return its updated details.
+  VaultInfoPtr SetJoinedNetwork(tcp::ConnectionPtr connection);
+  VaultInfoPtr SetNetworkHealth(tcp::ConnectionPtr connection, int network_health);
+  // Records the vault's reply to a HeartbeatRequest.  Only a reply to the latest request counts,
+  // resetting the missed heartbeat count and updating the smoothed heartbeat RTT; a late reply to
+  // an earlier one is ignored, since the vault may have hung after sending it.
+  void HandleHeartbeatResponse(tcp::ConnectionPtr connection, uint32_t sequence);
+  void SetStatistics(tcp::ConnectionPtr connection, VaultStatistics statistics);
+  // Returns the latest statistics reported by each vault which has reported any.
+  std::vector<std::pair<VaultInfoPtr, VaultStatistics>> GetAllStatistics() const;
   void StopProcess(tcp::ConnectionPtr connection, OnExitFunctor on_exit_functor = nullptr);
+  // As above, but also handles a vault which hasn't yet connected by terminating its process (or,
+  // if it was adopted, by forgetting it).  Either way the vault isn't restarted.  Throws
+  // CommonErrors::no_such_element if there's no such vault, or
+  // CommonErrors::unable_to_handle_request if it's already being stopped.
+  void StopProcess(const NonEmptyString& label, OnExitFunctor on_exit_functor);
   // Returns false if the process doesn't exist.
   bool HandleConnectionClosed(tcp::ConnectionPtr connection);
-  VaultInfo Find(const NonEmptyString& label) const;
-  VaultInfo Find(tcp::ConnectionPtr connection) const;
+  VaultInfoPtr Find(const NonEmptyString& label) const;
+  VaultInfoPtr Find(tcp::ConnectionPtr connection) const;
+  // Returns the page of vaults owned by 'owner_name' and matching 'query'.  Only the summaries of
+  // the listed vaults are copied.
+  VaultList ListVaults(const Identity& owner_name, const ListVaultsQuery& query) const;
 
  private:
   ProcessManager(asio::io_service& io_service, boost::filesystem::path vault_executable_path,
-                 tcp::Port listening_port);
+                 tcp::Port listening_port, LaunchMethod launch_method);
 
   struct Child {
     Child(VaultInfo info, asio::io_service& io_service, int restarts);
     Child(Child&& other);
     Child& operator=(Child other);
-    VaultInfo info;
+    // Replaced rather than modified in place (see VaultInfoPtr).
+    VaultInfoPtr info;
     OnExitFunctor on_exit;
     std::unique_ptr<Timer> timer;
     int restart_count;
     std::vector<std::string> process_args;
     ProcessStatus status;
+    bool adopted;
+    // When the process was started (or adopted) and when it connected, for the event log.
+    std::chrono::steady_clock::time_point start_time, running_time;
+    // When the unanswered HeartbeatRequest with 'heartbeat_sequence' was sent; default-constructed
+    // if there is none outstanding.
+    uint32_t heartbeat_sequence;
+    int missed_heartbeats;
+    std::chrono::steady_clock::time_point heartbeat_sent;
+    // Measurements which change too often to publish a new 'info' for each.  'heartbeat_rtt' is
+    // smoothed, and -1 until the first heartbeat response.
+    std::chrono::microseconds heartbeat_rtt;
+    boost::optional<VaultStatistics> statistics;
 #ifdef MAIDSAFE_WIN32
     asio::windows::object_handle handle;
 #endif
@@ -103,7 +172,13 @@ class ProcessManager {
   friend void swap(Child& lhs, Child& rhs);
 
   void StartProcess(std::vector<Child>::iterator itr);
+  void StartStandbyProcess();
+  void ReplenishStandbyPool();
+  void AssignStandby(std::vector<Child>::iterator standby_itr, VaultInfo info, int restart_count);
+  void StopStandbyProcesses();
   void InitSignalHandler();
+  void ScheduleHeartbeat();
+  void SendHeartbeats();
 
   std::vector<Child>::const_iterator DoFind(const NonEmptyString& label) const;
   std::vector<Child>::iterator DoFind(const NonEmptyString& label);
@@ -112,9 +187,17 @@ class ProcessManager {
   ProcessId GetProcessId(const Child& vault) const;
   bool IsRunning(const Child& vault) const;
   void OnProcessExit(const NonEmptyString& label, int exit_code, bool terminate = false);
+  void OnStandbyProcessExit(ProcessId process_id, int exit_code, bool terminate = false);
+  void OnAdoptionTimeout(const NonEmptyString& label);
   void TerminateProcess(std::vector<Child>::iterator itr);
   void InvokeOnExitFunctor(OnExitFunctor on_exit, int exit_code, bool terminate);
   void RestartIfRequired(int restart_count, VaultInfo vault_info);
+  // 'since' is the start of the latency to be recorded; the default means none.
+  void RecordEvent(const Child& vault, EventType type, int exit_code = 0,
+                   std::chrono::steady_clock::time_point since =
+                       std::chrono::steady_clock::time_point()) const;
+  void RecordEvent(const VaultInfo& info, ProcessId process_id, EventType type, int exit_code = 0,
+                   std::chrono::microseconds latency = std::chrono::microseconds(0)) const;
 
   asio::io_service& io_service_;
 #ifndef MAIDSAFE_WIN32
@@ -122,8 +205,16 @@ class ProcessManager {
 #endif
   std::once_flag stop_all_flag_;
   const tcp::Port kListeningPort_;
-  const boost::filesystem::path kVaultExecutablePath_;
+  boost::filesystem::path vault_executable_path_;
+  const LaunchMethod kLaunchMethod_;
   std::vector<Child> vaults_;
+  int standby_pool_size_, standby_failures_;
+  OnStandbyAssignedFunctor on_standby_assigned_;
+  // Children here have an empty VaultInfo (other than the tcp_connection once connected).
+  std::vector<Child> standby_vaults_;
+  std::shared_ptr<EventLog> event_log_;
+  OnVaultEventFunctor on_vault_event_;
+  Timer heartbeat_timer_;
 };
 
 }  // namespace vault_manager
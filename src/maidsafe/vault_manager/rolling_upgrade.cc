@@ -0,0 +1,196 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/rolling_upgrade.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/vault_manager/process_manager.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+RollingUpgrade::RollingUpgrade(asio::io_service& io_service,
+                               std::shared_ptr<ProcessManager> process_manager, int batch_size,
+                               std::chrono::steady_clock::duration join_timeout,
+                               RestartFunctor restart_functor, OnCompleteFunctor on_complete)
+    : io_service_(io_service),
+      process_manager_(std::move(process_manager)),
+      kBatchSize_(batch_size),
+      kJoinTimeout_(join_timeout),
+      restart_functor_(std::move(restart_functor)),
+      on_complete_(std::move(on_complete)),
+      timer_(io_service_),
+      previous_executable_path_(),
+      pending_(),
+      in_flight_(),
+      upgraded_(),
+      rollback_error_(),
+      deferred_attempts_(0),
+      finished_(false) {
+  if (kBatchSize_ < 1) {
+    LOG(kError) << "Batch size must be at least 1.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+}
+
+std::shared_ptr<RollingUpgrade> RollingUpgrade::MakeShared(
+    asio::io_service& io_service, std::shared_ptr<ProcessManager> process_manager, int batch_size,
+    std::chrono::steady_clock::duration join_timeout, RestartFunctor restart_functor,
+    OnCompleteFunctor on_complete) {
+  return std::shared_ptr<RollingUpgrade>{new RollingUpgrade{
+      io_service, std::move(process_manager), batch_size, join_timeout,
+      std::move(restart_functor), std::move(on_complete)}};
+}
+
+void RollingUpgrade::Start(fs::path vault_executable_path) {
+  previous_executable_path_ = process_manager_->VaultExecutablePath();
+  process_manager_->SetVaultExecutablePath(std::move(vault_executable_path));
+  for (const auto& vault_info : process_manager_->GetAll())
+    pending_.push_back(vault_info->label);
+  LOG(kInfo) << "Starting rolling upgrade of " << pending_.size() << " vaults in batches of "
+             << kBatchSize_;
+  RestartNextBatch();
+}
+
+void RollingUpgrade::HandleJoinedNetwork(const NonEmptyString& label) {
+  if (finished_ || in_flight_.erase(label) == 0U)
+    return;
+  if (!rollback_error_)
+    upgraded_.push_back(label);
+  if (in_flight_.empty()) {
+    std::error_code ignored_ec;
+    timer_.cancel(ignored_ec);
+    RestartNextBatch();
+  }
+}
+
+void RollingUpgrade::Stop() {
+  finished_ = true;
+  std::error_code ignored_ec;
+  timer_.cancel(ignored_ec);
+}
+
+void RollingUpgrade::RestartNextBatch() {
+  if (finished_)
+    return;
+
+  std::deque<NonEmptyString> not_connected;
+  while (static_cast<int>(in_flight_.size()) < kBatchSize_ && !pending_.empty()) {
+    NonEmptyString label{pending_.front()};
+    pending_.pop_front();
+    VaultInfoPtr vault_info;
+    try {
+      vault_info = process_manager_->Find(label);
+    } catch (const std::exception&) {
+      LOG(kWarning) << "Vault " << hex::Substr(label) << " no longer exists; skipping.";
+      continue;
+    }
+    if (!vault_info->tcp_connection) {
+      // The vault is between processes (e.g. being restarted after a crash), so try it again later.
+      not_connected.push_back(std::move(label));
+      continue;
+    }
+    in_flight_.insert(label);
+    restart_functor_(*vault_info);
+  }
+  pending_.insert(std::end(pending_), std::begin(not_connected), std::end(not_connected));
+
+  if (in_flight_.empty() && pending_.empty()) {
+    if (rollback_error_)
+      return Finish(*rollback_error_);
+    return Finish(MakeError(CommonErrors::success));
+  }
+
+  auto self(shared_from_this());
+  if (in_flight_.empty()) {
+    // Everything left is currently unconnected.  Retry shortly, but not indefinitely.
+    if (++deferred_attempts_ > kMaxVaultRestarts) {
+      LOG(kError) << pending_.size() << " vaults failed to reconnect during rolling upgrade.";
+      if (rollback_error_)
+        return Finish(*rollback_error_);
+      return RollBack(MakeError(VaultManagerErrors::failed_to_connect));
+    }
+    timer_.expires_from_now(kRpcTimeout);
+    timer_.async_wait([self](const std::error_code& error_code) {
+      if (error_code != asio::error::operation_aborted)
+        self->RestartNextBatch();
+    });
+    return;
+  }
+
+  deferred_attempts_ = 0;
+  timer_.expires_from_now(kJoinTimeout_);
+  timer_.async_wait([self](const std::error_code& error_code) {
+    if (error_code != asio::error::operation_aborted)
+      self->HandleBatchTimeout();
+  });
+}
+
+void RollingUpgrade::HandleBatchTimeout() {
+  if (finished_)
+    return;
+  LOG(kError) << "Timed out waiting for " << in_flight_.size() << " vaults to join the network.";
+  if (rollback_error_)
+    return Finish(*rollback_error_);
+  RollBack(MakeError(VaultManagerErrors::timed_out));
+}
+
+void RollingUpgrade::RollBack(maidsafe_error error) {
+  LOG(kWarning) << "Rolling back upgrade to " << previous_executable_path_;
+  rollback_error_ = std::move(error);
+  try {
+    process_manager_->SetVaultExecutablePath(previous_executable_path_);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to restore previous vault executable: "
+                << boost::diagnostic_information(e);
+    return Finish(*rollback_error_);
+  }
+  // Vaults which were part of the failed batch are rolled back first.
+  pending_.assign(std::begin(in_flight_), std::end(in_flight_));
+  pending_.insert(std::end(pending_), std::begin(upgraded_), std::end(upgraded_));
+  in_flight_.clear();
+  upgraded_.clear();
+  deferred_attempts_ = 0;
+  RestartNextBatch();
+}
+
+void RollingUpgrade::Finish(maidsafe_error error) {
+  if (finished_)
+    return;
+  finished_ = true;
+  std::error_code ignored_ec;
+  timer_.cancel(ignored_ec);
+  if (error.code() == make_error_code(CommonErrors::success))
+    LOG(kSuccess) << "Rolling upgrade of " << upgraded_.size() << " vaults finished.";
+  else
+    LOG(kError) << "Rolling upgrade failed: " << boost::diagnostic_information(error);
+  auto self(shared_from_this());
+  io_service_.post([self, error] { self->on_complete_(error, self->upgraded_); });
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
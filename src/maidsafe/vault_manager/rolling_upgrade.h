@@ -0,0 +1,101 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_ROLLING_UPGRADE_H_
+#define MAIDSAFE_VAULT_MANAGER_ROLLING_UPGRADE_H_
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "asio/io_service.hpp"
+#include "boost/filesystem/path.hpp"
+#include "boost/optional.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/types.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/vault_info.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+class ProcessManager;
+
+// Switches the ProcessManager to a new vault executable, then restarts the running vaults
+// 'batch_size' at a time.  The next batch is only restarted once every vault in the current batch
+// has reported JoinedNetwork.  If a batch fails to join within 'join_timeout', the previous
+// executable is restored and all vaults restarted so far are restarted again (in batches) to roll
+// them back.
+//
+// Not threadsafe - all functions must be called on the io_service's thread, as must the functors.
+class RollingUpgrade : public std::enable_shared_from_this<RollingUpgrade> {
+ public:
+  typedef std::function<void(VaultInfo)> RestartFunctor;
+  typedef std::function<void(maidsafe_error, std::vector<NonEmptyString>)> OnCompleteFunctor;
+
+  RollingUpgrade(const RollingUpgrade&) = delete;
+  RollingUpgrade(RollingUpgrade&&) = delete;
+  RollingUpgrade& operator=(RollingUpgrade) = delete;
+
+  static std::shared_ptr<RollingUpgrade> MakeShared(
+      asio::io_service& io_service, std::shared_ptr<ProcessManager> process_manager,
+      int batch_size, std::chrono::steady_clock::duration join_timeout,
+      RestartFunctor restart_functor, OnCompleteFunctor on_complete);
+  // Throws if 'vault_executable_path' is rejected by the ProcessManager.
+  void Start(boost::filesystem::path vault_executable_path);
+  void HandleJoinedNetwork(const NonEmptyString& label);
+  // Abandons the upgrade without invoking 'on_complete' or rolling back.
+  void Stop();
+
+ private:
+  RollingUpgrade(asio::io_service& io_service, std::shared_ptr<ProcessManager> process_manager,
+                 int batch_size, std::chrono::steady_clock::duration join_timeout,
+                 RestartFunctor restart_functor, OnCompleteFunctor on_complete);
+
+  void RestartNextBatch();
+  void HandleBatchTimeout();
+  void RollBack(maidsafe_error error);
+  void Finish(maidsafe_error error);
+
+  asio::io_service& io_service_;
+  std::shared_ptr<ProcessManager> process_manager_;
+  const int kBatchSize_;
+  const std::chrono::steady_clock::duration kJoinTimeout_;
+  RestartFunctor restart_functor_;
+  OnCompleteFunctor on_complete_;
+  Timer timer_;
+  boost::filesystem::path previous_executable_path_;
+  std::deque<NonEmptyString> pending_;
+  std::set<NonEmptyString> in_flight_;
+  std::vector<NonEmptyString> upgraded_;
+  boost::optional<maidsafe_error> rollback_error_;
+  int deferred_attempts_;
+  bool finished_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_ROLLING_UPGRADE_H_
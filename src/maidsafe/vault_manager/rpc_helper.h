@@ -74,10 +74,11 @@ struct PromiseAndTimer {
 }  // namespace detail
 
 template <typename ResultType, typename MessageType>
-std::future<ResultType> SetResponseCallback(std::function<void(MessageType&&)>& callback,
-                                            asio::io_service& io_service, std::mutex& mutex) {
+std::future<ResultType> SetResponseCallback(
+    std::function<void(MessageType&&)>& callback, asio::io_service& io_service, std::mutex& mutex,
+    const std::chrono::steady_clock::duration& timeout = kRpcTimeout) {
   auto promise_and_timer =
-      std::make_shared<detail::PromiseAndTimer<ResultType, MessageType>>(io_service);
+      std::make_shared<detail::PromiseAndTimer<ResultType, MessageType>>(io_service, timeout);
   {
     std::lock_guard<std::mutex> lock{mutex};
     auto callback_copy(callback);
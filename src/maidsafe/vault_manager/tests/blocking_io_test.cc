@@ -0,0 +1,160 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/blocking_io.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+// Returns the code of the error passed to 'on_complete', or a default-constructed one on success.
+std::error_code ErrorCode(std::future<std::exception_ptr> outcome) {
+  std::exception_ptr error{outcome.get()};
+  if (!error)
+    return std::error_code();
+  try {
+    std::rethrow_exception(error);
+  } catch (const maidsafe_error& e) {
+    return e.code();
+  } catch (const std::exception&) {
+  }
+  return MakeError(CommonErrors::unknown).code();
+}
+
+BlockingIo::OnComplete SetOutcome(std::shared_ptr<std::promise<std::exception_ptr>> outcome) {
+  return [outcome](std::exception_ptr error) { outcome->set_value(error); };
+}
+
+}  // unnamed namespace
+
+TEST(BlockingIoTest, BEH_Run) {
+  AsioService asio_service(1);
+  BlockingIo blocking_io(asio_service.service(), 2);
+
+  auto succeeded(std::make_shared<std::promise<std::exception_ptr>>());
+  std::thread::id task_thread, completion_thread;
+  blocking_io.Run([&] { task_thread = std::this_thread::get_id(); },
+                  [&, succeeded](std::exception_ptr error) {
+                    completion_thread = std::this_thread::get_id();
+                    succeeded->set_value(error);
+                  });
+  EXPECT_EQ(std::error_code(), ErrorCode(succeeded->get_future()));
+  // The task runs on the pool, and its outcome is reported via the completion service.
+  std::promise<std::thread::id> asio_thread;
+  asio_service.service().post([&] { asio_thread.set_value(std::this_thread::get_id()); });
+  EXPECT_EQ(asio_thread.get_future().get(), completion_thread);
+  EXPECT_NE(completion_thread, task_thread);
+
+  // Exceptions thrown by the task are passed to 'on_complete'.
+  auto failed(std::make_shared<std::promise<std::exception_ptr>>());
+  blocking_io.Run([] { BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error)); },
+                  SetOutcome(failed));
+  EXPECT_EQ(MakeError(CommonErrors::filesystem_io_error).code(), ErrorCode(failed->get_future()));
+}
+
+TEST(BlockingIoTest, BEH_RunInOrder) {
+  AsioService asio_service(1);
+  BlockingIo blocking_io(asio_service.service(), 4);
+  const int kTaskCount(50);
+  std::vector<int> order;
+  auto done(std::make_shared<std::promise<std::exception_ptr>>());
+  for (int i(0); i < kTaskCount; ++i) {
+    blocking_io.RunInOrder([&order, i] { order.push_back(i); },
+                           i == kTaskCount - 1 ? SetOutcome(done) : nullptr);
+  }
+  EXPECT_EQ(std::error_code(), ErrorCode(done->get_future()));
+  ASSERT_EQ(static_cast<std::size_t>(kTaskCount), order.size());
+  for (int i(0); i < kTaskCount; ++i)
+    EXPECT_EQ(i, order[i]);
+}
+
+TEST(BlockingIoTest, BEH_Timeout) {
+  AsioService asio_service(1);
+  BlockingIo blocking_io(asio_service.service(), 2);
+  const std::error_code kTimedOut(MakeError(VaultManagerErrors::timed_out).code());
+
+  // A task which runs for longer than its timeout is reported as having timed out.
+  std::promise<void> release;
+  std::shared_future<void> released{release.get_future().share()};
+  auto hung(std::make_shared<std::promise<std::exception_ptr>>());
+  blocking_io.RunInOrder([released] { released.wait(); }, SetOutcome(hung),
+                         std::chrono::milliseconds(100));
+
+  // A task queued behind it times out without being run.
+  auto queued(std::make_shared<std::promise<std::exception_ptr>>());
+  auto queued_ran(std::make_shared<std::atomic<bool>>(false));
+  blocking_io.RunInOrder([queued_ran] { *queued_ran = true; }, SetOutcome(queued),
+                         std::chrono::milliseconds(200));
+  EXPECT_EQ(kTimedOut, ErrorCode(hung->get_future()));
+  EXPECT_EQ(kTimedOut, ErrorCode(queued->get_future()));
+  release.set_value();
+
+  // The timeout is measured from when a task starts, so time spent queued isn't counted.
+  auto first(std::make_shared<std::promise<std::exception_ptr>>());
+  auto second(std::make_shared<std::promise<std::exception_ptr>>());
+  const std::chrono::milliseconds kTaskDuration(200);
+  blocking_io.RunInOrder([&] { std::this_thread::sleep_for(kTaskDuration); }, SetOutcome(first),
+                         kTaskDuration * 3);
+  blocking_io.RunInOrder([&] { std::this_thread::sleep_for(kTaskDuration); }, SetOutcome(second),
+                         kTaskDuration * 3 / 2);
+  EXPECT_EQ(std::error_code(), ErrorCode(first->get_future()));
+  EXPECT_EQ(std::error_code(), ErrorCode(second->get_future()));
+  EXPECT_FALSE(*queued_ran);
+}
+
+TEST(BlockingIoTest, BEH_ShutdownWithHungTask) {
+  AsioService asio_service(1);
+  std::promise<void> release;
+  std::shared_future<void> released{release.get_future().share()};
+  std::promise<void> started;
+  auto start(std::chrono::steady_clock::now());
+  {
+    BlockingIo blocking_io(asio_service.service(), 1, std::chrono::milliseconds(100));
+    blocking_io.Run(
+        [released, &started] {
+          started.set_value();
+          released.wait();
+        },
+        nullptr);
+    started.get_future().wait();
+  }
+  // The destructor gives up on the hung task rather than waiting for it.
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  release.set_value();
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,173 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/chunkstore_reclaimer.h"
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+// Creates 'file_count' files of 'file_size' bytes, spread over 'directory' and a subdirectory.
+void CreateChunkstore(const fs::path& directory, int file_count, std::size_t file_size) {
+  fs::create_directories(directory / "sub");
+  for (int i(0); i < file_count; ++i) {
+    fs::path file_path{(i % 2 == 0 ? directory : directory / "sub") / std::to_string(i)};
+    ASSERT_TRUE(WriteFile(file_path, RandomString(file_size)));
+  }
+}
+
+ChunkstoreReclaimer::GetProtectedPaths ProtectedPaths(std::vector<fs::path> paths) {
+  return [paths] {
+    std::promise<std::vector<fs::path>> promise;
+    promise.set_value(paths);
+    return promise.get_future();
+  };
+}
+
+VaultRemovalProgress Reclaim(ChunkstoreReclaimer& reclaimer, const fs::path& directory) {
+  std::promise<VaultRemovalProgress> finished;
+  reclaimer.Reclaim(NonEmptyString("label"), directory, [&](VaultRemovalProgress progress) {
+    if (progress.finished)
+      finished.set_value(progress);
+  });
+  return finished.get_future().get();
+}
+
+}  // unnamed namespace
+
+TEST(ChunkstoreReclaimerTest, BEH_Reclaim) {
+  maidsafe::test::TestPath test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestChunkstoreReclaimer")};
+  const int kFileCount(20), kUnlinksPerSecond(100);
+  const std::size_t kFileSize(100);
+  const fs::path kChunkstore(*test_path / "vault");
+  CreateChunkstore(kChunkstore, kFileCount, kFileSize);
+  MarkAsReclaimable(kChunkstore);
+
+  ChunkstoreReclaimer reclaimer(std::vector<fs::path>{*test_path},
+                                ProtectedPaths(std::vector<fs::path>{*test_path}),
+                                kUnlinksPerSecond, std::chrono::milliseconds(50));
+  std::promise<VaultRemovalProgress> finished;
+  int progress_count(0);
+  auto start(std::chrono::steady_clock::now());
+  reclaimer.Reclaim(NonEmptyString("label"), kChunkstore, [&](VaultRemovalProgress progress) {
+    ++progress_count;
+    if (progress.finished)
+      finished.set_value(progress);
+  });
+  EXPECT_TRUE(reclaimer.IsReclaiming(kChunkstore));
+  EXPECT_TRUE(reclaimer.IsReclaiming(*test_path / "vault" / "sub" / ".."));
+  EXPECT_FALSE(reclaimer.IsReclaiming(*test_path));
+  VaultRemovalProgress progress{finished.get_future().get()};
+
+  // Unlinks are throttled, so progress is reported along the way.
+  EXPECT_GE(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(kFileCount * 1000 / kUnlinksPerSecond));
+  EXPECT_GT(progress_count, 1);
+  EXPECT_EQ(NonEmptyString("label"), progress.label);
+  EXPECT_FALSE(progress.failed);
+  // The files plus the marker.
+  EXPECT_EQ(static_cast<uint64_t>(kFileCount + 1), progress.files_removed);
+  EXPECT_EQ(static_cast<uint64_t>(kFileCount * kFileSize), progress.bytes_removed);
+  EXPECT_FALSE(fs::exists(kChunkstore));
+  EXPECT_FALSE(reclaimer.IsReclaiming(kChunkstore));
+}
+
+TEST(ChunkstoreReclaimerTest, BEH_ProtectedPaths) {
+  maidsafe::test::TestPath test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestChunkstoreReclaimer")};
+  const fs::path kSharedDir(*test_path / "shared");
+  CreateChunkstore(kSharedDir / "other_vault", 2, 10);
+  CreateChunkstore(kSharedDir, 2, 10);
+  MarkAsReclaimable(kSharedDir);
+
+  {
+    ChunkstoreReclaimer reclaimer(std::vector<fs::path>{*test_path},
+                                  ProtectedPaths(std::vector<fs::path>{kSharedDir / "other_vault"}),
+                                  1000);
+    // A directory containing another vault's directory is left alone.
+    VaultRemovalProgress progress{Reclaim(reclaimer, kSharedDir)};
+    EXPECT_TRUE(progress.failed);
+    EXPECT_EQ(0U, progress.files_removed);
+    EXPECT_TRUE(fs::exists(kSharedDir / "other_vault" / "0"));
+
+    // A missing directory has nothing to delete.
+    progress = Reclaim(reclaimer, *test_path / "missing");
+    EXPECT_FALSE(progress.failed);
+    EXPECT_EQ(0U, progress.files_removed);
+  }
+
+  // The protected paths are fetched when deletion starts rather than when it's queued, so a vault
+  // started in the directory in the meantime is protected.
+  std::promise<std::vector<fs::path>> protected_paths;
+  std::shared_future<std::vector<fs::path>> protected_paths_future{
+      protected_paths.get_future().share()};
+  ChunkstoreReclaimer reclaimer(std::vector<fs::path>{*test_path}, [&] {
+    std::promise<std::vector<fs::path>> promise;
+    promise.set_value(protected_paths_future.get());
+    return promise.get_future();
+  }, 1000);
+  auto progress(std::async(std::launch::async, [&] { return Reclaim(reclaimer, kSharedDir); }));
+  protected_paths.set_value(std::vector<fs::path>{kSharedDir / "sub"});
+  EXPECT_TRUE(progress.get().failed);
+  EXPECT_TRUE(fs::exists(kSharedDir / "0"));
+}
+
+TEST(ChunkstoreReclaimerTest, BEH_UnmanagedDirectories) {
+  maidsafe::test::TestPath test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestChunkstoreReclaimer")};
+  const fs::path kVolume(*test_path / "volume");
+  const fs::path kUnmarked(kVolume / "unmarked"), kOutside(*test_path / "outside");
+  CreateChunkstore(kUnmarked, 2, 10);
+  CreateChunkstore(kOutside, 2, 10);
+  MarkAsReclaimable(kOutside);
+  MarkAsReclaimable(kVolume);
+
+  ChunkstoreReclaimer reclaimer(std::vector<fs::path>{kVolume},
+                                ProtectedPaths(std::vector<fs::path>()), 1000);
+  // Not created by the VaultManager.
+  EXPECT_TRUE(Reclaim(reclaimer, kUnmarked).failed);
+  EXPECT_TRUE(fs::exists(kUnmarked / "0"));
+  // Not within a managed root.
+  EXPECT_TRUE(Reclaim(reclaimer, kOutside).failed);
+  EXPECT_TRUE(fs::exists(kOutside / "0"));
+  EXPECT_TRUE(Reclaim(reclaimer, kVolume / "unmarked" / "..").failed);
+  EXPECT_TRUE(fs::exists(kVolume));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,278 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/client_connections.h"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/serialisation/serialisation.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/log_message.h"
+#include "maidsafe/vault_manager/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+// Runs 'functor' on 'strand' and waits for it to complete.
+void RunOnStrand(asio::io_service::strand& strand, std::function<void()> functor) {
+  std::promise<void> done;
+  strand.post([&] {
+    try {
+      functor();
+      done.set_value();
+    } catch (...) {
+      done.set_exception(std::current_exception());
+    }
+  });
+  done.get_future().get();
+}
+
+}  // unnamed namespace
+
+class ClientConnectionsTest : public testing::Test {
+ protected:
+  ClientConnectionsTest()
+      : asio_service_(1),
+        strand_(asio_service_.service()),
+        client_connections_(ClientConnections::MakeShared(asio_service_.service())),
+        mutex_(),
+        condition_(),
+        received_(),
+        local_connections_(),
+        accepted_() {}
+
+  void SetUp() override {
+    local_connections_.reset(new LocalConnections(strand_));
+    accepted_ = local_connections_->Connect([this](tcp::Message message) {
+      InputVectorStream binary_input_stream(std::move(message));
+      MessageTag tag(static_cast<MessageTag>(-1));
+      Parse(binary_input_stream, tag);
+      ASSERT_EQ(MessageTag::kLogMessage, tag);
+      std::lock_guard<std::mutex> lock(mutex_);
+      received_.emplace_back(Parse<LogMessage>(binary_input_stream).data);
+      condition_.notify_one();
+    });
+  }
+
+  void TearDown() override {
+    RunOnStrand(strand_, [&] {
+      client_connections_->Remove(accepted_);
+      client_connections_.reset();
+    });
+    local_connections_.reset();
+    asio_service_.Stop();
+  }
+
+  void Validate() {
+    auto maid(passport::CreateMaidAndSigner().first);
+    asymm::PlainText challenge(RandomString(100));
+    RunOnStrand(strand_, [&] {
+      client_connections_->Add(accepted_, challenge);
+      client_connections_->Validate(accepted_, passport::PublicMaid(maid),
+                                    asymm::Sign(challenge, maid.private_key()));
+    });
+  }
+
+  void SendDroppable(const std::string& data, const std::string& coalesce_key = std::string()) {
+    RunOnStrand(strand_, [&] {
+      client_connections_->SendDroppable(accepted_, LogMessage(data), coalesce_key);
+    });
+  }
+
+  void Ack(uint32_t message_count) {
+    RunOnStrand(strand_,
+                [&] { client_connections_->HandleFlowControlAck(accepted_, message_count); });
+  }
+
+  // Waits for 'count' messages in total to have been received, then a little longer to catch any
+  // extra ones which shouldn't have been sent.
+  std::vector<std::string> WaitForReceived(std::size_t count) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    EXPECT_TRUE(condition_.wait_for(lock, std::chrono::seconds(10),
+                                    [&] { return received_.size() >= count; }));
+    lock.unlock();
+    Sleep(std::chrono::milliseconds(200));
+    lock.lock();
+    return received_;
+  }
+
+  AsioService asio_service_;
+  asio::io_service::strand strand_;
+  std::shared_ptr<ClientConnections> client_connections_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<std::string> received_;
+  std::unique_ptr<LocalConnections> local_connections_;
+  tcp::ConnectionPtr accepted_;
+};
+
+TEST_F(ClientConnectionsTest, BEH_IgnoresUnvalidated) {
+  SendDroppable("unvalidated");
+  Ack(1);
+  EXPECT_TRUE(WaitForReceived(0).empty());
+}
+
+TEST_F(ClientConnectionsTest, BEH_DropAndAck) {
+  Validate();
+  const int kExtra(10);
+  for (int i(0); i < kMaxUnacknowledgedMessages + kExtra; ++i)
+    SendDroppable(std::to_string(i));
+
+  // Only the first window's worth should arrive.
+  auto received(WaitForReceived(kMaxUnacknowledgedMessages));
+  ASSERT_EQ(kMaxUnacknowledgedMessages, static_cast<int>(received.size()));
+  for (int i(0); i < kMaxUnacknowledgedMessages; ++i)
+    EXPECT_EQ(std::to_string(i), received[i]);
+
+  // Acknowledging them should report the drops, after which messages flow again.
+  Ack(kMaxUnacknowledgedMessages);
+  received = WaitForReceived(kMaxUnacknowledgedMessages + 1);
+  ASSERT_EQ(kMaxUnacknowledgedMessages + 1, static_cast<int>(received.size()));
+  EXPECT_NE(std::string::npos, received.back().find(std::to_string(kExtra) + " log messages"));
+
+  SendDroppable("after");
+  received = WaitForReceived(kMaxUnacknowledgedMessages + 2);
+  ASSERT_EQ(kMaxUnacknowledgedMessages + 2, static_cast<int>(received.size()));
+  EXPECT_EQ("after", received.back());
+}
+
+TEST_F(ClientConnectionsTest, BEH_Coalesce) {
+  Validate();
+  for (int i(0); i < kMaxUnacknowledgedMessages; ++i)
+    SendDroppable(std::to_string(i), "a");
+  auto received(WaitForReceived(kMaxUnacknowledgedMessages));
+  ASSERT_EQ(kMaxUnacknowledgedMessages, static_cast<int>(received.size()));
+
+  // With the window full, later messages for a key supersede earlier pending ones.
+  SendDroppable("b0", "b");
+  SendDroppable("a0", "a");
+  SendDroppable("b1", "b");
+  SendDroppable("dropped");
+  EXPECT_EQ(kMaxUnacknowledgedMessages, static_cast<int>(WaitForReceived(0).size()));
+
+  // A partial ack only opens the window for one of them.
+  Ack(1);
+  received = WaitForReceived(kMaxUnacknowledgedMessages + 1);
+  ASSERT_EQ(kMaxUnacknowledgedMessages + 1, static_cast<int>(received.size()));
+  EXPECT_EQ("a0", received.back());
+
+  // Acking more than were sent mustn't underflow the window.
+  Ack(2 * kMaxUnacknowledgedMessages);
+  received = WaitForReceived(kMaxUnacknowledgedMessages + 3);
+  ASSERT_EQ(kMaxUnacknowledgedMessages + 3, static_cast<int>(received.size()));
+  EXPECT_EQ("b1", received[kMaxUnacknowledgedMessages + 1]);
+  EXPECT_NE(std::string::npos, received.back().find("dropped 1 log messages"));
+
+  for (int i(0); i < kMaxUnacknowledgedMessages - 2; ++i)
+    SendDroppable("refill" + std::to_string(i));
+  SendDroppable("over");
+  received = WaitForReceived(2 * kMaxUnacknowledgedMessages + 1);
+  EXPECT_EQ(2 * kMaxUnacknowledgedMessages + 1, static_cast<int>(received.size()));
+  EXPECT_EQ("refill" + std::to_string(kMaxUnacknowledgedMessages - 3), received.back());
+}
+
+TEST_F(ClientConnectionsTest, BEH_VaultEventSubscriptions) {
+  RunOnStrand(strand_, [&] {
+    EXPECT_THROW(client_connections_->SetSubscribedToVaultEvents(accepted_, true), maidsafe_error);
+  });
+  Validate();
+  RunOnStrand(strand_, [&] {
+    EXPECT_FALSE(client_connections_->IsSubscribedToVaultEvents(accepted_));
+    client_connections_->SetSubscribedToVaultEvents(accepted_, true);
+    EXPECT_TRUE(client_connections_->IsSubscribedToVaultEvents(accepted_));
+    client_connections_->SetSubscribedToVaultEvents(accepted_, false);
+    EXPECT_FALSE(client_connections_->IsSubscribedToVaultEvents(accepted_));
+    client_connections_->SetSubscribedToVaultEvents(accepted_, true);
+    EXPECT_TRUE(client_connections_->Remove(accepted_));
+    EXPECT_FALSE(client_connections_->IsSubscribedToVaultEvents(accepted_));
+  });
+}
+
+TEST_F(ClientConnectionsTest, BEH_AdmissionLimits) {
+  std::vector<tcp::ConnectionPtr> connections;
+  for (int i(0); i < 4; ++i)
+    connections.push_back(local_connections_->Connect());
+  const maidsafe_error kLimitError(MakeError(CommonErrors::cannot_exceed_limit));
+  auto add([&](std::shared_ptr<ClientConnections> client_connections, int index) {
+    RunOnStrand(strand_, [&] { client_connections->Add(connections[index], RandomString(100)); });
+  });
+  auto expect_limited([&](std::shared_ptr<ClientConnections> client_connections, int index) {
+    try {
+      add(client_connections, index);
+      ADD_FAILURE() << "Connection " << index << " should have been refused.";
+    } catch (const maidsafe_error& error) {
+      EXPECT_EQ(kLimitError.code(), error.code());
+    }
+  });
+  auto remove_all([&](std::shared_ptr<ClientConnections> client_connections) {
+    RunOnStrand(strand_, [&] {
+      for (auto& connection : connections)
+        client_connections->Remove(connection);
+    });
+  });
+
+  // At most two clients awaiting validation; the rate limit is too high to matter.
+  auto bounded(ClientConnections::MakeShared(asio_service_.service(), 2, 1000, 1000));
+  add(bounded, 0);
+  add(bounded, 1);
+  expect_limited(bounded, 2);
+  RunOnStrand(strand_, [&] { EXPECT_TRUE(bounded->Remove(connections[0])); });
+  add(bounded, 2);
+  remove_all(bounded);
+
+  // Bursts of up to three requests to be validated, refilled at five per second.
+  auto rate_limited(ClientConnections::MakeShared(asio_service_.service(), 100, 5, 3));
+  add(rate_limited, 0);
+  add(rate_limited, 1);
+  add(rate_limited, 2);
+  expect_limited(rate_limited, 3);
+  Sleep(std::chrono::milliseconds(300));
+  add(rate_limited, 3);
+  remove_all(rate_limited);
+  RunOnStrand(strand_, [&] {
+    bounded.reset();
+    rate_limited.reset();
+  });
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -18,10 +18,16 @@
 
 #include "maidsafe/vault_manager/client_interface.h"
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <mutex>
+#include <vector>
 
+#include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/on_scope_exit.h"
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
@@ -32,8 +38,6 @@
 #include "maidsafe/vault_manager/vault_manager.h"
 #include "maidsafe/vault_manager/tests/test_utils.h"
 
-namespace fs = boost::filesystem;
-
 namespace maidsafe {
 
 namespace vault_manager {
@@ -41,19 +45,241 @@ namespace vault_manager {
 namespace test {
 
 TEST(ClientInterfaceTest, BEH_Basic) {
-  std::shared_ptr<fs::path> test_env_root_dir{
-      maidsafe::test::CreateTestPath("MaidSafe_TestClientInterface")};
-  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
-  SetEnvironment(tcp::Port{8888}, *test_env_root_dir, path_to_vault);
+  SetUpTestEnvironment();
 
   VaultManager vault_manager;
   static_cast<void>(vault_manager);
 
+  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  std::string first_ticket;
   {
-    passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
     ClientInterface client_interface{maid_and_signer.first};
+    // No vaults are running, so none have reported statistics.
+    HostStatistics host_statistics{client_interface.GetHostStatistics().get()};
+    EXPECT_TRUE(host_statistics.vaults.empty());
+    EXPECT_EQ(0U, host_statistics.vault_count);
+    EXPECT_EQ(0U, host_statistics.totals.chunks_stored);
+    VaultList vault_list{client_interface.ListVaults().get()};
+    EXPECT_TRUE(vault_list.vaults.empty());
+    EXPECT_TRUE(vault_list.next_page_token.empty());
+    EXPECT_THROW(client_interface.GetVaultStatus(NonEmptyString("label")).get(), maidsafe_error);
+    EXPECT_THROW(client_interface.RemoveVault(NonEmptyString("label")).get(), maidsafe_error);
+    first_ticket = client_interface.GetSessionTicket();
     LOG(kVerbose) << "Client stopping.";
   }
+  ASSERT_FALSE(first_ticket.empty());
+
+  // Resuming with the ticket yields a new one.
+  std::string second_ticket;
+  {
+    ClientInterface client_interface{maid_and_signer.first, first_ticket};
+    second_ticket = client_interface.GetSessionTicket();
+  }
+  EXPECT_FALSE(second_ticket.empty());
+  EXPECT_NE(first_ticket, second_ticket);
+
+  // Reused or tampered tickets are rejected, falling back to signing the challenge.
+  {
+    ClientInterface client_interface{maid_and_signer.first, first_ticket};
+    EXPECT_FALSE(client_interface.GetSessionTicket().empty());
+    EXPECT_NE(first_ticket, client_interface.GetSessionTicket());
+  }
+  second_ticket[0] ^= 1;
+  {
+    ClientInterface client_interface{maid_and_signer.first, second_ticket};
+    EXPECT_FALSE(client_interface.GetSessionTicket().empty());
+  }
+}
+
+TEST(ClientInterfaceTest, BEH_HostStatistics) {
+  SetUpTestEnvironment();
+  VaultManager vault_manager;
+  ClientInterface client_a{passport::CreateMaidAndSigner().first};
+  ClientInterface client_b{passport::CreateMaidAndSigner().first};
+  StartDummyVault(client_a).get();
+  StartDummyVault(client_b).get();
+  NonEmptyString label_a{client_a.ListVaults().get().vaults.at(0).label};
+  NonEmptyString label_b{client_b.ListVaults().get().vaults.at(0).label};
+
+  // The vaults report their statistics shortly after being configured.
+  HostStatistics statistics;
+  const auto kDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+  while (statistics.vault_count < 2U && std::chrono::steady_clock::now() < kDeadline) {
+    Sleep(std::chrono::milliseconds(100));
+    statistics = client_a.GetHostStatistics().get();
+  }
+  ASSERT_EQ(2U, statistics.vault_count);
+  EXPECT_EQ(2 * kDummyVaultChunksStored, statistics.totals.chunks_stored);
+  EXPECT_EQ(2 * kDummyVaultBytesUsed, statistics.totals.bytes_used);
+  EXPECT_EQ(0U, statistics.totals.routing_table_size);
+
+  // Each client only sees the breakdown for its own vaults, even with several requests in flight
+  // at once.
+  std::vector<std::future<HostStatistics>> futures_a, futures_b;
+  for (int i(0); i < 5; ++i) {
+    futures_a.push_back(client_a.GetHostStatistics());
+    futures_b.push_back(client_b.GetHostStatistics());
+  }
+  for (auto& future : futures_a) {
+    statistics = future.get();
+    EXPECT_EQ(2U, statistics.vault_count);
+    ASSERT_EQ(1U, statistics.vaults.size());
+    EXPECT_EQ(label_a, statistics.vaults.begin()->first);
+    EXPECT_EQ(kDummyVaultChunksStored, statistics.vaults.begin()->second.chunks_stored);
+  }
+  for (auto& future : futures_b) {
+    statistics = future.get();
+    EXPECT_EQ(2U, statistics.vault_count);
+    ASSERT_EQ(1U, statistics.vaults.size());
+    EXPECT_EQ(label_b, statistics.vaults.begin()->first);
+  }
+}
+
+TEST(ClientInterfaceTest, BEH_VaultEvents) {
+  SetUpTestEnvironment();
+  VaultManager vault_manager;
+  ClientInterface client_interface{passport::CreateMaidAndSigner().first};
+
+  NonEmptyString label;
+  {
+    VaultEventRecorder recorder{client_interface};
+    auto pmid_and_signer(StartDummyVault(client_interface).get());
+    ASSERT_TRUE(pmid_and_signer != nullptr);
+    VaultList vault_list{client_interface.ListVaults().get()};
+    ASSERT_EQ(1U, vault_list.vaults.size());
+    label = vault_list.vaults.front().label;
+    EXPECT_TRUE(recorder.WaitFor(label, VaultEventType::kSpawned));
+    EXPECT_TRUE(recorder.WaitFor(label, VaultEventType::kConnected));
+    for (const auto& event : recorder.Events())
+      EXPECT_EQ(label, event.label);
+
+    client_interface.RemoveVault(label).get();
+    EXPECT_TRUE(recorder.WaitFor(label, VaultEventType::kStopping));
+    EXPECT_TRUE(recorder.WaitFor(label, VaultEventType::kStopped));
+  }
+
+  // Once unsubscribed, no further events are delivered.
+  bool received_event{false};
+  std::mutex mutex;
+  client_interface.SubscribeToVaultEvents([&](VaultEvent) {
+    std::lock_guard<std::mutex> lock{mutex};
+    received_event = true;
+  });
+  client_interface.SubscribeToVaultEvents(nullptr);
+  StartDummyVault(client_interface).get();
+  Sleep(std::chrono::seconds(1));
+  std::lock_guard<std::mutex> lock{mutex};
+  EXPECT_FALSE(received_event);
+}
+
+TEST(ClientInterfaceTest, BEH_HungVaultRestarted) {
+  SetUpTestEnvironment();
+  VaultManager vault_manager;
+  ClientInterface client_interface{passport::CreateMaidAndSigner().first};
+  VaultEventRecorder recorder{client_interface};
+
+  // A healthy vault, whose heartbeats go through its (working) work loop.
+  StartDummyVault(client_interface).get();
+  NonEmptyString healthy_label{client_interface.ListVaults().get().vaults.at(0).label};
+
+  NonEmptyString hung_label;
+  {
+    ScopedEnvironmentVariable hang{kDummyVaultHangAfterVar, "500"};
+    StartDummyVault(client_interface).get();
+    for (const auto& vault : client_interface.ListVaults().get().vaults) {
+      if (!(vault.label == healthy_label))
+        hung_label = vault.label;
+    }
+  }
+  ASSERT_TRUE(hung_label.IsInitialised());
+
+  // The hung vault's process is still up and connected, but stops answering heartbeats, so should
+  // be timed out and restarted after kMaxMissedHeartbeats.
+  const auto kTimeout(kHeartbeatInterval * (kMaxMissedHeartbeats + 2));
+  EXPECT_TRUE(recorder.WaitFor(hung_label, VaultEventType::kTimedOut, kTimeout));
+  EXPECT_TRUE(recorder.WaitFor(hung_label, VaultEventType::kRestarting));
+  for (const auto& event : recorder.Events()) {
+    EXPECT_FALSE(event.label == healthy_label && event.type == VaultEventType::kTimedOut);
+    EXPECT_FALSE(event.label == healthy_label && event.type == VaultEventType::kRestarting);
+  }
+}
+
+TEST(ClientInterfaceTest, BEH_WaitForJoinedVaults) {
+  SetUpTestEnvironment();
+  VaultManager vault_manager;
+  ClientInterface client_interface{passport::CreateMaidAndSigner().first};
+  auto times_out([&](int vault_count, int min_network_health) {
+    try {
+      client_interface.WaitForJoinedVaults(vault_count, min_network_health,
+                                           std::chrono::milliseconds(200)).get();
+    } catch (const maidsafe_error& error) {
+      EXPECT_EQ(make_error_code(VaultManagerErrors::timed_out), error.code());
+      return true;
+    }
+    return false;
+  });
+
+  EXPECT_TRUE(times_out(1, 0));
+  StartDummyVault(client_interface).get();
+  EXPECT_NO_THROW(client_interface.WaitForJoinedVaults(1, 0, std::chrono::seconds(30)).get());
+  EXPECT_NO_THROW(client_interface.WaitForJoinedVaults(1, kDummyVaultNetworkHealth,
+                                                       std::chrono::seconds(30)).get());
+  EXPECT_TRUE(times_out(1, kDummyVaultNetworkHealth + 1));
+  EXPECT_TRUE(times_out(2, 0));
+
+  // An outstanding wait is satisfied by a vault which joins later.
+  auto joined(client_interface.WaitForJoinedVaults(2, 0, std::chrono::seconds(30)));
+  StartDummyVault(client_interface).get();
+  EXPECT_NO_THROW(joined.get());
+
+  // A vault whose process has exited is no longer counted.
+  client_interface.RemoveVault(client_interface.ListVaults().get().vaults.at(0).label).get();
+  bool still_counted(true);
+  for (int i(0); i < 50 && still_counted; ++i)
+    still_counted = !times_out(2, 0);
+  EXPECT_FALSE(still_counted);
+  EXPECT_NO_THROW(client_interface.WaitForJoinedVaults(1, 0, std::chrono::seconds(30)).get());
+}
+
+TEST(ClientInterfaceTest, BEH_UpgradeVaults) {
+  SetUpTestEnvironment();
+  // The new executable must be in the same directory as the current one.
+  const boost::filesystem::path kVaultPath{process::GetOtherExecutablePath("dummy_vault")};
+  const boost::filesystem::path kUpgradePath{
+      kVaultPath.parent_path() / ("dummy_vault_upgrade" + kVaultPath.extension().string())};
+  boost::filesystem::copy_file(kVaultPath, kUpgradePath,
+                               boost::filesystem::copy_option::overwrite_if_exists);
+  on_scope_exit remove_upgrade{[&] {
+    boost::system::error_code ignored_ec;
+    boost::filesystem::remove(kUpgradePath, ignored_ec);
+  }};
+  {
+    VaultManager vault_manager;
+    ClientInterface owner{passport::CreateMaidAndSigner().first};
+    ClientInterface other_client{passport::CreateMaidAndSigner().first};
+    std::vector<NonEmptyString> labels;
+    for (int i(0); i < 3; ++i)
+      StartDummyVault(owner).get();
+    for (const auto& vault : owner.ListVaults().get().vaults)
+      labels.push_back(vault.label);
+    ASSERT_EQ(3U, labels.size());
+
+    // Other clients' vaults can't be upgraded.
+    try {
+      other_client.UpgradeVaults(kUpgradePath, 2).get();
+      ADD_FAILURE() << "Upgrade by a client which doesn't own the vaults should fail.";
+    } catch (const maidsafe_error& error) {
+      EXPECT_EQ(make_error_code(CommonErrors::unable_to_handle_request), error.code());
+    }
+
+    // The dummy vaults rejoin as soon as they're restarted, so the batches all succeed.
+    std::vector<NonEmptyString> upgraded_labels;
+    ASSERT_NO_THROW(upgraded_labels = owner.UpgradeVaults(kUpgradePath, 2).get());
+    std::sort(std::begin(labels), std::end(labels));
+    std::sort(std::begin(upgraded_labels), std::end(upgraded_labels));
+    EXPECT_EQ(labels, upgraded_labels);
+    EXPECT_NO_THROW(owner.WaitForJoinedVaults(3, 0, std::chrono::seconds(30)).get());
+  }
 }
 
 }  // namespace test
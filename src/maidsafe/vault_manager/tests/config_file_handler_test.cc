@@ -0,0 +1,87 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/config_file_handler.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_info.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(ConfigFileHandlerTest, BEH_WriteAndRead) {
+  maidsafe::test::TestPath test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestConfigFileHandler")};
+  const fs::path kConfigPath(*test_path / "config");
+  std::vector<VaultInfoPtr> vaults;
+  for (int i(0); i < 3; ++i) {
+    VaultInfo vault;
+    vault.pmid_and_signer =
+        std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+    vault.vault_dir = *test_path / ("vault_" + std::to_string(i));
+    vault.max_disk_usage = DiskUsage{1000U * (i + 1)};
+    if (i != 0)  // The owner is optional.
+      vault.owner_name = Identity{passport::CreateMaidAndSigner().first.name().value};
+    vault.label = GenerateLabel();
+    vault.process_id = static_cast<process::ProcessId>(1000 + i);
+    vaults.push_back(std::make_shared<const VaultInfo>(std::move(vault)));
+  }
+  {
+    ConfigFileHandler config_file_handler(kConfigPath);
+    EXPECT_TRUE(config_file_handler.ReadConfigFile().empty());
+    config_file_handler.WriteConfigFile(vaults);
+  }
+
+  // A new handler reads back every vault, in order.
+  ConfigFileHandler config_file_handler(kConfigPath);
+  std::vector<VaultInfo> read_vaults(config_file_handler.ReadConfigFile());
+  ASSERT_EQ(vaults.size(), read_vaults.size());
+  for (std::size_t i(0); i < vaults.size(); ++i) {
+    EXPECT_EQ(vaults[i]->pmid_and_signer->first.name(),
+              read_vaults[i].pmid_and_signer->first.name());
+    EXPECT_EQ(vaults[i]->pmid_and_signer->second.name(),
+              read_vaults[i].pmid_and_signer->second.name());
+    EXPECT_EQ(vaults[i]->vault_dir, read_vaults[i].vault_dir);
+    EXPECT_EQ(vaults[i]->max_disk_usage, read_vaults[i].max_disk_usage);
+    EXPECT_EQ(vaults[i]->owner_name.IsInitialised(), read_vaults[i].owner_name.IsInitialised());
+    if (vaults[i]->owner_name.IsInitialised())
+      EXPECT_EQ(vaults[i]->owner_name, read_vaults[i].owner_name);
+    EXPECT_EQ(vaults[i]->label, read_vaults[i].label);
+    EXPECT_EQ(vaults[i]->process_id, read_vaults[i].process_id);
+  }
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,95 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/config_persister.h"
+
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/vault_manager/blocking_io.h"
+#include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/vault_info.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(ConfigPersisterTest, BEH_CoalesceAndFlush) {
+  maidsafe::test::TestPath test_path{
+      maidsafe::test::CreateTestPath("MaidSafe_TestConfigPersister")};
+  const fs::path kConfigPath(*test_path / "config");
+  ConfigFileHandler config_file_handler(kConfigPath);
+  AsioService asio_service(1);
+  BlockingIo blocking_io(asio_service.service(), 1);
+  int snapshot_count(0);
+  ConfigPersister config_persister(asio_service.service(), blocking_io, config_file_handler,
+                                   [&] {
+                                     ++snapshot_count;
+                                     return std::vector<VaultInfoPtr>{};
+                                   },
+                                   std::chrono::hours(1));
+
+  // Nothing is written until the window elapses, and all changes marked within it share a write.
+  std::promise<std::vector<std::shared_future<void>>> marked;
+  asio_service.service().post([&] {
+    std::vector<std::shared_future<void>> durable;
+    for (int i(0); i < 10; ++i)
+      durable.push_back(config_persister.MarkDirty());
+    marked.set_value(durable);
+  });
+  auto durable(marked.get_future().get());
+  for (const auto& future : durable)
+    EXPECT_EQ(std::future_status::timeout, future.wait_for(std::chrono::milliseconds(10)));
+
+  // Flush writes them without waiting for the window.
+  std::promise<std::shared_future<void>> flushed;
+  asio_service.service().post([&] { flushed.set_value(config_persister.Flush()); });
+  EXPECT_NO_THROW(flushed.get_future().get().get());
+  for (const auto& future : durable)
+    EXPECT_NO_THROW(future.get());
+  EXPECT_EQ(1, snapshot_count);
+  EXPECT_TRUE(config_file_handler.ReadConfigFile().empty());
+  fs::path temp_path{kConfigPath};
+  temp_path += ".tmp";
+  EXPECT_FALSE(fs::exists(temp_path));
+
+  // A further change is written separately.
+  std::promise<std::shared_future<void>> flushed_again;
+  asio_service.service().post([&] {
+    config_persister.MarkDirty();
+    flushed_again.set_value(config_persister.Flush());
+  });
+  EXPECT_NO_THROW(flushed_again.get_future().get().get());
+  EXPECT_EQ(2, snapshot_count);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
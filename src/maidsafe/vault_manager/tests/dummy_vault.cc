@@ -16,31 +16,282 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "asio/io_service_strand.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/common/tcp/connection.h"
 
+#include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/vault_config.h"
 #include "maidsafe/vault_manager/vault_interface.h"
+#include "maidsafe/vault_manager/vault_statistics.h"
+#include "maidsafe/vault_manager/tests/test_utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct LoadConfig {
+  int log_messages = 0;
+  int log_rate = 0;
+  int reconnects = 0;
+  std::chrono::milliseconds reconnect_interval{0};
+  std::chrono::milliseconds mean_crash_interval{0};
+  std::chrono::milliseconds hang_after{0};
+  fs::path report_dir;
+};
+
+int GetIntFromEnvironment(const char* name) {
+  const char* value{std::getenv(name)};
+  if (!value)
+    return 0;
+  int result{std::stoi(value)};
+  if (result < 0) {
+    LOG(kError) << name << " can't be negative.";
+    BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+  }
+  return result;
+}
+
+LoadConfig GetLoadConfig() {
+  namespace test = maidsafe::vault_manager::test;
+  LoadConfig config;
+  config.log_messages = GetIntFromEnvironment(test::kDummyVaultLogMessagesVar);
+  config.log_rate = GetIntFromEnvironment(test::kDummyVaultLogRateVar);
+  config.reconnects = GetIntFromEnvironment(test::kDummyVaultReconnectsVar);
+  config.reconnect_interval =
+      std::chrono::milliseconds{GetIntFromEnvironment(test::kDummyVaultReconnectIntervalVar)};
+  config.mean_crash_interval =
+      std::chrono::milliseconds{GetIntFromEnvironment(test::kDummyVaultMeanCrashIntervalVar)};
+  config.hang_after =
+      std::chrono::milliseconds{GetIntFromEnvironment(test::kDummyVaultHangAfterVar)};
+  const char* report_dir{std::getenv(test::kDummyVaultReportDirVar)};
+  if (report_dir)
+    config.report_dir = report_dir;
+  return config;
+}
+
+// Threadsafe.
+class Report {
+ public:
+  void Add(const std::string& metric, double value, const std::string& unit) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    rows_.push_back(metric + ',' + std::to_string(value) + ',' + unit);
+  }
+
+  void AddLatencies(const std::string& metric, std::vector<Clock::duration> latencies) {
+    if (latencies.empty())
+      return;
+    std::sort(std::begin(latencies), std::end(latencies));
+    auto to_us([](Clock::duration duration) {
+      return static_cast<double>(
+          std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+    });
+    Add(metric + "_p50", to_us(latencies[latencies.size() / 2]), "us");
+    Add(metric + "_p99", to_us(latencies[latencies.size() * 99 / 100]), "us");
+    Add(metric + "_max", to_us(latencies.back()), "us");
+  }
+
+  void Write(const fs::path& report_dir) const {
+    if (report_dir.empty())
+      return;
+    fs::path report_path{report_dir /
+                         ("dummy_vault_" + std::to_string(maidsafe::process::GetProcessId()) +
+                          ".csv")};
+    std::ofstream report_file{report_path.string()};
+    std::lock_guard<std::mutex> lock{mutex_};
+    report_file << "metric,value,unit\n";
+    for (const auto& row : rows_)
+      report_file << row << '\n';
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<std::string> rows_;
+};
+
+// Stands in for a real vault's main work loop, through which heartbeats are answered.  If
+// 'hang_after' is non-zero, the loop stops running tasks that long after starting, as though it
+// had deadlocked, until it's destroyed.
+class WorkLoop {
+ public:
+  explicit WorkLoop(std::chrono::milliseconds hang_after)
+      : kHangTime_(hang_after.count() == 0 ? Clock::time_point::max() : Clock::now() + hang_after),
+        mutex_(),
+        condition_(),
+        tasks_(),
+        stopped_(false),
+        thread_([this] { Run(); }) {}
+
+  ~WorkLoop() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stopped_ = true;
+    }
+    condition_.notify_one();
+    thread_.join();
+  }
+
+  void Post(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+  }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    while (!stopped_) {
+      if (Clock::now() >= kHangTime_) {
+        LOG(kWarning) << "Work loop hanging deliberately";
+        condition_.wait(lock, [this] { return stopped_; });
+        return;
+      }
+      if (tasks_.empty()) {
+        condition_.wait_until(lock, kHangTime_, [this] { return stopped_ || !tasks_.empty(); });
+        continue;
+      }
+      auto task(std::move(tasks_.front()));
+      tasks_.pop_front();
+      lock.unlock();
+      task();
+      lock.lock();
+    }
+  }
+
+  const Clock::time_point kHangTime_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::function<void()>> tasks_;
+  bool stopped_;
+  std::thread thread_;
+};
+
+// Kills the process with kDummyVaultCrashExitCode after an exponentially distributed interval, so
+// that the VaultManager sees an unexpected exit.
+void ScheduleCrash(std::chrono::milliseconds mean_crash_interval) {
+  std::mt19937 generator{static_cast<std::mt19937::result_type>(
+      maidsafe::process::GetProcessId() ^ Clock::now().time_since_epoch().count())};
+  std::exponential_distribution<double> distribution{1.0 / mean_crash_interval.count()};
+  std::chrono::milliseconds delay{static_cast<int64_t>(distribution(generator))};
+  std::thread([delay] {
+    std::this_thread::sleep_for(delay);
+    LOG(kWarning) << "Crashing deliberately after " << delay.count() << "ms";
+    std::_Exit(maidsafe::vault_manager::test::kDummyVaultCrashExitCode);
+  }).detach();
+}
+
+void SendLogMessages(maidsafe::vault_manager::VaultInterface& vault_interface,
+                     const LoadConfig& config, Report& report) {
+  auto start(Clock::now());
+  for (int i(0); i < config.log_messages; ++i) {
+    if (config.log_rate > 0) {
+      std::this_thread::sleep_until(
+          start + std::chrono::microseconds{static_cast<int64_t>(i) * 1000000 / config.log_rate});
+    }
+    vault_interface.SendLogMessage("Dummy vault log message " + std::to_string(i));
+  }
+  auto elapsed(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start));
+  report.Add("log_messages_sent", config.log_messages, "messages");
+  if (elapsed.count() > 0) {
+    report.Add("log_send_rate", config.log_messages * 1000000.0 / elapsed.count(),
+               "messages/s");
+  }
+}
+
+// Opens and immediately drops connections to the VaultManager, recording how long each takes to be
+// accepted.
+void ReconnectStorm(uint16_t port, const LoadConfig& config, Report& report) {
+  maidsafe::AsioService asio_service{1};
+  asio::io_service::strand strand{asio_service.service()};
+  std::vector<Clock::duration> latencies;
+  int failures{0};
+  for (int i(0); i < config.reconnects; ++i) {
+    if (i != 0)
+      std::this_thread::sleep_for(config.reconnect_interval);
+    auto start(Clock::now());
+    try {
+      auto connection(maidsafe::tcp::Connection::MakeShared(strand, port));
+      latencies.push_back(Clock::now() - start);
+      connection->Start([](maidsafe::tcp::Message) {}, [] {});
+      connection->Close();
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to connect: " << e.what();
+      ++failures;
+    }
+  }
+  asio_service.Stop();
+  report.AddLatencies("reconnect_connect", std::move(latencies));
+  report.Add("reconnect_failures", failures, "connections");
+}
+
+}  // unnamed namespace
 
 int main(int argc, char* argv[]) {
   using maidsafe::vault_manager::VaultConfig;
+  const auto kStartTime(Clock::now());
   bool connected_to_vault_manager{false}, should_hang{false};
   int exit_code{0};
+  LoadConfig load_config;
+  Report report;
   try {
     auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
-    if (unuseds.size() != 2U)
+    if (unuseds.size() != 2U && unuseds.size() != 3U)
       BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
     uint16_t port{static_cast<uint16_t>(std::stoi(std::string{&unuseds[1][0]}))};
-    maidsafe::vault_manager::VaultInterface vault_interface{port};
+    bool standby{unuseds.size() == 3U &&
+                 std::string{&unuseds[2][0]} == maidsafe::vault_manager::kStandbyVaultArg};
+    load_config = GetLoadConfig();
+    maidsafe::vault_manager::VaultInterface vault_interface{port, standby};
     connected_to_vault_manager = true;
+    // Shared with the executor, since that may still be in use as 'vault_interface' is destroyed.
+    auto work_loop(std::make_shared<WorkLoop>(load_config.hang_after));
+    vault_interface.SetHeartbeatExecutor(
+        [work_loop](std::function<void()> task) { work_loop->Post(std::move(task)); });
 
-    std::future<void> worker;
+    std::future<void> worker, reconnect_worker;
     VaultConfig config{vault_interface.GetConfiguration()};
+    maidsafe::vault_manager::VaultStatistics statistics;
+    statistics.chunks_stored = maidsafe::vault_manager::test::kDummyVaultChunksStored;
+    statistics.bytes_used = maidsafe::vault_manager::test::kDummyVaultBytesUsed;
+    vault_interface.SendStatistics(statistics);
+    vault_interface.SendJoined();
+    vault_interface.SendNetworkHealth(maidsafe::vault_manager::test::kDummyVaultNetworkHealth);
+    report.Add("start_to_configured",
+               static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                       Clock::now() - kStartTime).count()),
+               "us");
+    if (load_config.mean_crash_interval.count() > 0)
+      ScheduleCrash(load_config.mean_crash_interval);
+    if (load_config.reconnects > 0) {
+      reconnect_worker = std::async(std::launch::async,
+                                    [&] { ReconnectStorm(port, load_config, report); });
+    }
     switch (config.test_config.test_type) {
       case VaultConfig::TestType::kNone:
         break;
@@ -59,8 +310,14 @@ int main(int argc, char* argv[]) {
       default:
         BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
     }
+    if (load_config.log_messages > 0)
+      SendLogMessages(vault_interface, load_config, report);
+    if (reconnect_worker.valid())
+      reconnect_worker.get();
+    report.Write(load_config.report_dir);
     exit_code = vault_interface.WaitForExit();
-    worker.get();
+    if (worker.valid())
+      worker.get();
   } catch (const maidsafe::maidsafe_error& error) {
     if (connected_to_vault_manager)
       LOG(kError) << error.what();
@@ -0,0 +1,138 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/event_log.h"
+
+#include <cstdint>
+#include <fstream>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(EventLogTest, BEH_EncodeAndDecode) {
+  EventRecord record(EventType::kUnexpectedExit, RandomAlphaNumericString(10), 12345, -3,
+                     std::chrono::microseconds(987654321));
+  EventRecord decoded(EventRecord::Decode(record.Encode()));
+  EXPECT_EQ(record.timestamp, decoded.timestamp);
+  EXPECT_EQ(record.label, decoded.label);
+  EXPECT_EQ(record.process_id, decoded.process_id);
+  EXPECT_EQ(record.type, decoded.type);
+  EXPECT_EQ(record.exit_code, decoded.exit_code);
+  EXPECT_EQ(record.latency, decoded.latency);
+
+  // Overlong labels are truncated.
+  record.label = RandomAlphaNumericString(EventRecord::kLabelSize + 1);
+  EXPECT_EQ(record.label.substr(0, EventRecord::kLabelSize),
+            EventRecord::Decode(record.Encode()).label);
+
+  auto encoded(record.Encode());
+  encoded[28] = static_cast<char>(0xFF);
+  EXPECT_THROW(EventRecord::Decode(encoded), maidsafe_error);
+}
+
+TEST(EventLogTest, BEH_ConcurrentRecording) {
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestEventLog")};
+  const boost::filesystem::path kLogPath(*test_path / "events.dat");
+  const int kThreadCount(4), kRecordsPerThread(500);
+  std::uint64_t dropped_count(0);
+  {
+    EventLog event_log(kLogPath, 64);
+    std::vector<std::future<void>> recorders;
+    for (int i(0); i < kThreadCount; ++i) {
+      recorders.emplace_back(std::async(std::launch::async, [&, i] {
+        for (int j(0); j < kRecordsPerThread; ++j)
+          event_log.Record(EventType::kRunning, std::to_string(i), j);
+      }));
+    }
+    for (auto& recorder : recorders)
+      recorder.get();
+    dropped_count = event_log.DroppedCount();
+  }
+
+  // Records from each thread are written in the order they were recorded, and every record is
+  // either written or counted as dropped.
+  auto records(ReadEventLog(kLogPath));
+  EXPECT_EQ(static_cast<std::uint64_t>(kThreadCount * kRecordsPerThread),
+            records.size() + dropped_count);
+  std::map<std::string, std::uint64_t> next_process_ids;
+  for (const auto& record : records) {
+    EXPECT_EQ(EventType::kRunning, record.type);
+    EXPECT_LE(next_process_ids[record.label], record.process_id);
+    next_process_ids[record.label] = record.process_id + 1;
+  }
+
+  // A second log appends to the same file.
+  {
+    EventLog event_log(kLogPath);
+    event_log.Record(EventType::kExited, "appended", 1);
+  }
+  auto appended_records(ReadEventLog(kLogPath));
+  ASSERT_EQ(records.size() + 1, appended_records.size());
+  EXPECT_EQ("appended", appended_records.back().label);
+}
+
+TEST(EventLogTest, BEH_RecoverFromPartialWrite) {
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestEventLog")};
+  const boost::filesystem::path kLogPath(*test_path / "events.dat");
+  auto append_garbage([&](std::size_t size) {
+    std::ofstream file(kLogPath.string(), std::ios::out | std::ios::binary | std::ios::app);
+    file << RandomString(size);
+  });
+
+  // A crash part way through writing the header.
+  append_garbage(3);
+  {
+    EventLog event_log(kLogPath);
+    event_log.Record(EventType::kStarting, "first", 1);
+  }
+  auto records(ReadEventLog(kLogPath));
+  ASSERT_EQ(1U, records.size());
+  EXPECT_EQ("first", records.back().label);
+
+  // A crash part way through writing a record.  The partial record is ignored when reading, and
+  // records appended afterwards are still read correctly.
+  append_garbage(EventRecord::kSize / 2);
+  EXPECT_EQ(1U, ReadEventLog(kLogPath).size());
+  {
+    EventLog event_log(kLogPath);
+    event_log.Record(EventType::kExited, "second", 2, -1);
+  }
+  records = ReadEventLog(kLogPath);
+  ASSERT_EQ(2U, records.size());
+  EXPECT_EQ("first", records.front().label);
+  EXPECT_EQ("second", records.back().label);
+  EXPECT_EQ(EventType::kExited, records.back().type);
+  EXPECT_EQ(2U, records.back().process_id);
+  EXPECT_EQ(-1, records.back().exit_code);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,81 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/new_connections.h"
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "asio/io_service_strand.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/tcp/connection.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(NewConnectionsTest, BEH_PendingLimit) {
+  AsioService asio_service(1);
+  asio::io_service::strand strand(asio_service.service());
+  std::shared_ptr<NewConnections> new_connections{
+      NewConnections::MakeShared(asio_service.service(), 2)};
+  std::vector<tcp::ConnectionPtr> connections;
+  {
+    LocalConnections local_connections(strand);
+    for (int i(0); i < 3; ++i)
+      connections.push_back(local_connections.Connect());
+
+    std::promise<void> done;
+    strand.post([&] {
+      EXPECT_TRUE(new_connections->Add(connections[0]));
+      EXPECT_TRUE(new_connections->Add(connections[1]));
+      EXPECT_FALSE(new_connections->Add(connections[2]));
+      EXPECT_TRUE(new_connections->Remove(connections[0]));
+      EXPECT_FALSE(new_connections->Remove(connections[0]));
+      EXPECT_TRUE(new_connections->Add(connections[2]));
+
+      // Admission isn't rate limited, so vaults reconnecting in quick succession (as after a
+      // VaultManager is replaced) are never refused while there's room for them.
+      for (int i(0); i < 10 * kClientValidationBurst; ++i) {
+        EXPECT_TRUE(new_connections->Remove(connections[2]));
+        EXPECT_TRUE(new_connections->Add(connections[2]));
+      }
+
+      EXPECT_TRUE(new_connections->Remove(connections[1]));
+      EXPECT_TRUE(new_connections->Remove(connections[2]));
+      new_connections.reset();
+      done.set_value();
+    });
+    done.get_future().get();
+  }
+  asio_service.Stop();
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
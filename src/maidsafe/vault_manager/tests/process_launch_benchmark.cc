@@ -0,0 +1,116 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Measures how long it takes to launch a vault process via each LaunchMethod while this process
+// holds various amounts of resident memory.  Usage:
+//
+//   bench_process_launch [<iterations> [<rss_mb> ...]]
+//
+// Results are written to stdout as CSV: launch_method,rss_mb,iterations,mean_us,min_us,max_us
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+#include "boost/process/wait_for_exit.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
+
+#include "maidsafe/vault_manager/process_launcher.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+using maidsafe::vault_manager::LaunchMethod;
+
+const int kDefaultIterations(20);
+const std::vector<int> kDefaultRssSizesMb{0, 256, 1024};
+
+std::string ToString(LaunchMethod launch_method) {
+  return launch_method == LaunchMethod::kExecute ? "execute" : "posix_spawn";
+}
+
+void BenchmarkLaunch(LaunchMethod launch_method, int rss_mb, int iterations,
+                     const fs::path& path_to_vault, asio::io_service& io_service) {
+  // Port 0 is invalid, so the dummy vault exits as soon as it fails to connect.
+  const std::vector<std::string> kArgs{path_to_vault.string(), "0"};
+  std::vector<std::chrono::microseconds> durations;
+  for (int i(0); i < iterations; ++i) {
+    auto start(std::chrono::steady_clock::now());
+    auto child(maidsafe::vault_manager::LaunchProcess(launch_method, path_to_vault, kArgs,
+                                                      io_service));
+    durations.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start));
+    boost::system::error_code ignored_ec;
+    boost::process::wait_for_exit(child, ignored_ec);
+  }
+
+  std::chrono::microseconds total{0};
+  for (const auto& duration : durations)
+    total += duration;
+  std::cout << ToString(launch_method) << ',' << rss_mb << ',' << iterations << ','
+            << total.count() / iterations << ','
+            << std::min_element(std::begin(durations), std::end(durations))->count() << ','
+            << std::max_element(std::begin(durations), std::end(durations))->count() << '\n';
+}
+
+}  // unnamed namespace
+
+int main(int argc, char* argv[]) {
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    int iterations{kDefaultIterations};
+    std::vector<int> rss_sizes_mb;
+    if (unuseds.size() > 1U)
+      iterations = std::stoi(std::string{&unuseds[1][0]});
+    for (std::size_t i(2); i < unuseds.size(); ++i)
+      rss_sizes_mb.push_back(std::stoi(std::string{&unuseds[i][0]}));
+    if (rss_sizes_mb.empty())
+      rss_sizes_mb = kDefaultRssSizesMb;
+    if (iterations < 1)
+      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+
+    fs::path path_to_vault{maidsafe::process::GetOtherExecutablePath("dummy_vault")};
+    maidsafe::AsioService asio_service(1);
+    std::vector<LaunchMethod> launch_methods{LaunchMethod::kExecute};
+#ifndef MAIDSAFE_WIN32
+    launch_methods.push_back(LaunchMethod::kPosixSpawn);
+#endif
+
+    std::cout << "launch_method,rss_mb,iterations,mean_us,min_us,max_us\n";
+    for (int rss_mb : rss_sizes_mb) {
+      // Touch every byte so the memory is actually resident, and hence mapped in the page tables.
+      std::vector<char> ballast(static_cast<std::size_t>(rss_mb) * 1024 * 1024);
+      std::memset(ballast.data(), 1, ballast.size());
+      for (auto launch_method : launch_methods)
+        BenchmarkLaunch(launch_method, rss_mb, iterations, path_to_vault, asio_service.service());
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return -1;
+  }
+  return 0;
+}
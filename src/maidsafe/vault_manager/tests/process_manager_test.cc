@@ -18,6 +18,7 @@
 
 #include "maidsafe/vault_manager/process_manager.h"
 
+#include <limits>
 #include <thread>
 #include <string>
 #include <vector>
@@ -29,6 +30,7 @@
 #include "maidsafe/common/process.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
 
 #include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/utils.h"
@@ -52,6 +54,127 @@ TEST(ProcessManagerTest, BEH_Constructor) {
   asio_service.reset();
 }
 
+TEST(ProcessManagerTest, BEH_SetVaultExecutablePath) {
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  std::unique_ptr<AsioService> asio_service{maidsafe::make_unique<AsioService>(1)};
+  std::shared_ptr<ProcessManager> process_manager{
+      ProcessManager::MakeShared(asio_service->service(), path_to_vault, tcp::Port{7777})};
+  EXPECT_EQ(path_to_vault, process_manager->VaultExecutablePath());
+
+  // Non-existent file
+  EXPECT_THROW(process_manager->SetVaultExecutablePath(path_to_vault.parent_path() / "no_vault"),
+               maidsafe_error);
+  // Not in the same directory as the current executable
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestProcessManager")};
+  fs::path other_vault{*test_path / path_to_vault.filename()};
+  ASSERT_TRUE(WriteFile(other_vault, "Not a vault"));
+  EXPECT_THROW(process_manager->SetVaultExecutablePath(other_vault), maidsafe_error);
+  EXPECT_EQ(path_to_vault, process_manager->VaultExecutablePath());
+
+  EXPECT_NO_THROW(process_manager->SetVaultExecutablePath(path_to_vault));
+  EXPECT_EQ(path_to_vault, process_manager->VaultExecutablePath());
+  process_manager->StopAll();
+  asio_service.reset();
+}
+
+TEST(ProcessManagerTest, BEH_AdoptProcess) {
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  std::unique_ptr<AsioService> asio_service{maidsafe::make_unique<AsioService>(1)};
+  std::shared_ptr<ProcessManager> process_manager{
+      ProcessManager::MakeShared(asio_service->service(), path_to_vault, tcp::Port{7777})};
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestProcessManager")};
+
+  VaultInfo vault_info;
+  EXPECT_THROW(process_manager->AdoptProcess(vault_info), maidsafe_error);
+  vault_info.pmid_and_signer =
+      std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+  vault_info.vault_dir = *test_path;
+  vault_info.label = GenerateLabel();
+
+  // No process ID
+  EXPECT_FALSE(process_manager->AdoptProcess(vault_info));
+  // Process which isn't running
+  vault_info.process_id = std::numeric_limits<int32_t>::max();
+  EXPECT_FALSE(process_manager->AdoptProcess(vault_info));
+  EXPECT_TRUE(process_manager->GetAll().empty());
+  EXPECT_THROW(process_manager->FindAwaitingAdoption(vault_info.process_id), maidsafe_error);
+
+  process_manager->StopAll();
+  asio_service.reset();
+}
+
+TEST(ProcessManagerTest, BEH_ListVaults) {
+  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
+  std::unique_ptr<AsioService> asio_service{maidsafe::make_unique<AsioService>(1)};
+  std::shared_ptr<ProcessManager> process_manager{
+      ProcessManager::MakeShared(asio_service->service(), path_to_vault, tcp::Port{7777})};
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestProcessManager")};
+
+  // This test's own process stands in for the vaults, which are adopted rather than started so
+  // that they stay listed (as kStarting) until they'd be expected to reconnect.
+  const Identity kOwner{passport::CreateMaidAndSigner().first.name().value};
+  const Identity kOtherOwner{passport::CreateMaidAndSigner().first.name().value};
+  auto adopt([&](const std::string& label, const Identity& owner) {
+    VaultInfo vault_info;
+    vault_info.pmid_and_signer =
+        std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+    vault_info.vault_dir = *test_path / label;
+    vault_info.label = NonEmptyString{label};
+    vault_info.owner_name = owner;
+    vault_info.process_id = process::GetProcessId();
+    ASSERT_TRUE(process_manager->AdoptProcess(vault_info));
+  });
+  // Added out of order, since results are ordered by label.
+  for (const auto& label : {"beta_2", "alpha_3", "alpha_1", "beta_1", "alpha_2"})
+    adopt(label, kOwner);
+  adopt("alpha_0", kOtherOwner);
+
+  auto labels([](const VaultList& vault_list) {
+    std::vector<std::string> result;
+    for (const auto& vault : vault_list.vaults)
+      result.push_back(vault.label.string());
+    return result;
+  });
+
+  // Only the owner's vaults are listed.
+  VaultList vault_list{process_manager->ListVaults(kOwner, ListVaultsQuery())};
+  EXPECT_EQ((std::vector<std::string>{"alpha_1", "alpha_2", "alpha_3", "beta_1", "beta_2"}),
+            labels(vault_list));
+  EXPECT_TRUE(vault_list.next_page_token.empty());
+  EXPECT_EQ(static_cast<uint64_t>(process::GetProcessId()), vault_list.vaults.front().process_id);
+  EXPECT_EQ(ProcessStatus::kStarting, vault_list.vaults.front().status);
+  EXPECT_EQ(-1, vault_list.vaults.front().heartbeat_rtt_microseconds);
+  EXPECT_EQ((std::vector<std::string>{"alpha_0"}),
+            labels(process_manager->ListVaults(kOtherOwner, ListVaultsQuery())));
+
+  // Filtering by label prefix and status.
+  ListVaultsQuery query;
+  query.label_prefix = "alpha_";
+  EXPECT_EQ((std::vector<std::string>{"alpha_1", "alpha_2", "alpha_3"}),
+            labels(process_manager->ListVaults(kOwner, query)));
+  query.statuses = {ProcessStatus::kRunning, ProcessStatus::kStopping};
+  EXPECT_TRUE(process_manager->ListVaults(kOwner, query).vaults.empty());
+  query.statuses.push_back(ProcessStatus::kStarting);
+  EXPECT_EQ(3U, process_manager->ListVaults(kOwner, query).vaults.size());
+
+  // Paging through all of the owner's vaults.
+  query = ListVaultsQuery();
+  query.max_results = 2;
+  std::vector<std::vector<std::string>> pages;
+  do {
+    vault_list = process_manager->ListVaults(kOwner, query);
+    pages.push_back(labels(vault_list));
+    query.page_token = vault_list.next_page_token;
+  } while (!query.page_token.empty() && pages.size() < 5);
+  EXPECT_EQ((std::vector<std::vector<std::string>>{
+                {"alpha_1", "alpha_2"}, {"alpha_3", "beta_1"}, {"beta_2"}}),
+            pages);
+
+  // The adopted "vaults" are this process, so mustn't be stopped.
+  process_manager->ReleaseAll();
+  asio_service.reset();
+}
+
 }  // namespace test
 
 }  // namespace vault_manager
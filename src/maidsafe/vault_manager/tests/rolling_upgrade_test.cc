@@ -0,0 +1,242 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/rolling_upgrade.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/process_manager.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/tests/test_utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+// This test's own process stands in for the vaults, which are adopted and connected over local
+// connections, and the restart functor only records the vaults it's asked to restart.  The tests
+// report vaults as having joined, so control each batch.  They must finish well within
+// kHeartbeatInterval * kMaxMissedHeartbeats, since the stand-in vaults don't answer heartbeats.
+class RollingUpgradeTest : public testing::Test {
+ protected:
+  typedef std::pair<maidsafe_error, std::vector<NonEmptyString>> Result;
+
+  RollingUpgradeTest()
+      : kVaultPath_(process::GetOtherExecutablePath("dummy_vault")),
+        kUpgradePath_(kVaultPath_.parent_path() /
+                      ("dummy_vault_upgrade" + kVaultPath_.extension().string())),
+        test_path_(maidsafe::test::CreateTestPath("MaidSafe_TestRollingUpgrade")),
+        asio_service_(1),
+        strand_(asio_service_.service()),
+        local_connections_(strand_),
+        process_manager_(
+            ProcessManager::MakeShared(asio_service_.service(), kVaultPath_, tcp::Port{7777})),
+        labels_(),
+        mutex_(),
+        condition_(),
+        restarted_(),
+        result_() {}
+
+  void SetUp() override {
+    fs::copy_file(kVaultPath_, kUpgradePath_, fs::copy_option::overwrite_if_exists);
+    for (int i(0); i < 4; ++i) {
+      VaultInfo vault_info;
+      vault_info.pmid_and_signer =
+          std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+      vault_info.vault_dir = *test_path_ / std::to_string(i);
+      vault_info.label = GenerateLabel();
+      vault_info.process_id = process::GetProcessId();
+      ASSERT_TRUE(process_manager_->AdoptProcess(vault_info));
+      process_manager_->HandleVaultAdopted(local_connections_.Connect(), process::GetProcessId());
+      labels_.push_back(vault_info.label);
+    }
+  }
+
+  void TearDown() override {
+    // The adopted "vaults" are this process, so mustn't be stopped.
+    RunOnAsio([&] { process_manager_->ReleaseAll(); });
+    boost::system::error_code ignored_ec;
+    fs::remove(kUpgradePath_, ignored_ec);
+  }
+
+  std::shared_ptr<RollingUpgrade> MakeRollingUpgrade(
+      int batch_size, std::chrono::steady_clock::duration join_timeout) {
+    return RollingUpgrade::MakeShared(
+        asio_service_.service(), process_manager_, batch_size, join_timeout,
+        [this](VaultInfo vault_info) {
+          {
+            std::lock_guard<std::mutex> lock{mutex_};
+            restarted_.push_back(vault_info.label);
+          }
+          condition_.notify_all();
+        },
+        [this](maidsafe_error error, std::vector<NonEmptyString> upgraded_labels) {
+          result_.set_value(std::make_pair(error, std::move(upgraded_labels)));
+        });
+  }
+
+  // Runs 'functor' on the asio thread (as RollingUpgrade requires) and waits for it to finish,
+  // rethrowing anything it throws.
+  template <typename Functor>
+  void RunOnAsio(Functor functor) {
+    std::packaged_task<void()> task{functor};
+    auto done(task.get_future());
+    asio_service_.service().post([&] { task(); });
+    done.get();
+  }
+
+  std::vector<NonEmptyString> Restarted() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return restarted_;
+  }
+
+  bool WaitForRestarts(size_t count) {
+    std::unique_lock<std::mutex> lock{mutex_};
+    return condition_.wait_for(lock, std::chrono::seconds(10),
+                               [&] { return restarted_.size() >= count; });
+  }
+
+  Result WaitForResult() {
+    auto future(result_.get_future());
+    if (future.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+      BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::timed_out));
+    return future.get();
+  }
+
+  static std::vector<NonEmptyString> Sorted(std::vector<NonEmptyString> labels) {
+    std::sort(std::begin(labels), std::end(labels));
+    return labels;
+  }
+
+  const fs::path kVaultPath_, kUpgradePath_;
+  maidsafe::test::TestPath test_path_;
+  AsioService asio_service_;
+  asio::io_service::strand strand_;
+  LocalConnections local_connections_;
+  std::shared_ptr<ProcessManager> process_manager_;
+  std::vector<NonEmptyString> labels_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<NonEmptyString> restarted_;
+  std::promise<Result> result_;
+};
+
+TEST_F(RollingUpgradeTest, BEH_InvalidExecutable) {
+  auto rolling_upgrade(MakeRollingUpgrade(2, std::chrono::seconds(10)));
+  EXPECT_THROW(RunOnAsio([&] { rolling_upgrade->Start(*test_path_ / kVaultPath_.filename()); }),
+               maidsafe_error);
+  EXPECT_EQ(kVaultPath_, process_manager_->VaultExecutablePath());
+  EXPECT_TRUE(Restarted().empty());
+  EXPECT_THROW(MakeRollingUpgrade(0, std::chrono::seconds(10)), maidsafe_error);
+}
+
+TEST_F(RollingUpgradeTest, BEH_RestartsInBatches) {
+  auto rolling_upgrade(MakeRollingUpgrade(2, std::chrono::seconds(10)));
+  RunOnAsio([&] { rolling_upgrade->Start(kUpgradePath_); });
+  EXPECT_EQ(kUpgradePath_, process_manager_->VaultExecutablePath());
+  const std::vector<NonEmptyString> kFirstBatch{Restarted()};
+  ASSERT_EQ(2U, kFirstBatch.size());
+
+  // The next batch is only started once the whole of the current one has joined.
+  RunOnAsio([&] { rolling_upgrade->HandleJoinedNetwork(kFirstBatch[0]); });
+  EXPECT_EQ(2U, Restarted().size());
+  RunOnAsio([&] { rolling_upgrade->HandleJoinedNetwork(kFirstBatch[1]); });
+  const std::vector<NonEmptyString> kAllRestarted{Restarted()};
+  ASSERT_EQ(4U, kAllRestarted.size());
+  EXPECT_EQ(Sorted(labels_), Sorted(kAllRestarted));
+
+  RunOnAsio([&] {
+    rolling_upgrade->HandleJoinedNetwork(kAllRestarted[2]);
+    rolling_upgrade->HandleJoinedNetwork(kAllRestarted[3]);
+  });
+  Result result(WaitForResult());
+  EXPECT_EQ(make_error_code(CommonErrors::success), result.first.code());
+  EXPECT_EQ(Sorted(labels_), Sorted(result.second));
+  EXPECT_EQ(kUpgradePath_, process_manager_->VaultExecutablePath());
+  EXPECT_EQ(4U, Restarted().size());
+}
+
+TEST_F(RollingUpgradeTest, BEH_RollBackOnTimeout) {
+  auto rolling_upgrade(MakeRollingUpgrade(2, std::chrono::seconds(1)));
+  RunOnAsio([&] { rolling_upgrade->Start(kUpgradePath_); });
+  const std::vector<NonEmptyString> kFirstBatch{Restarted()};
+  ASSERT_EQ(2U, kFirstBatch.size());
+
+  // One vault of the batch never joins, so once the batch times out the previous executable is
+  // restored and both are restarted again, the one which failed first.  The vaults which were never
+  // upgraded aren't touched.
+  RunOnAsio([&] { rolling_upgrade->HandleJoinedNetwork(kFirstBatch[0]); });
+  ASSERT_TRUE(WaitForRestarts(4));
+  EXPECT_EQ(kVaultPath_, process_manager_->VaultExecutablePath());
+  const std::vector<NonEmptyString> kRestarted{Restarted()};
+  EXPECT_EQ(kFirstBatch[1], kRestarted[2]);
+  EXPECT_EQ(kFirstBatch[0], kRestarted[3]);
+
+  RunOnAsio([&] {
+    rolling_upgrade->HandleJoinedNetwork(kRestarted[2]);
+    rolling_upgrade->HandleJoinedNetwork(kRestarted[3]);
+  });
+  Result result(WaitForResult());
+  EXPECT_EQ(make_error_code(VaultManagerErrors::timed_out), result.first.code());
+  EXPECT_TRUE(result.second.empty());
+  EXPECT_EQ(4U, Restarted().size());
+}
+
+TEST_F(RollingUpgradeTest, BEH_RollBackTimesOut) {
+  auto rolling_upgrade(MakeRollingUpgrade(1, std::chrono::milliseconds(500)));
+  RunOnAsio([&] { rolling_upgrade->Start(kUpgradePath_); });
+  ASSERT_EQ(1U, Restarted().size());
+
+  // Neither the upgraded vault nor its rollback ever joins, so the upgrade gives up rather than
+  // waiting indefinitely.
+  Result result(WaitForResult());
+  EXPECT_EQ(make_error_code(VaultManagerErrors::timed_out), result.first.code());
+  EXPECT_TRUE(result.second.empty());
+  EXPECT_EQ(kVaultPath_, process_manager_->VaultExecutablePath());
+  const std::vector<NonEmptyString> kRestarted{Restarted()};
+  ASSERT_EQ(2U, kRestarted.size());
+  EXPECT_EQ(kRestarted[0], kRestarted[1]);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -18,18 +18,26 @@
 
 #include "maidsafe/vault_manager/tests/test_utils.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <memory>
 
 #include "boost/algorithm/string/find_iterator.hpp"
 #include "boost/algorithm/string/trim.hpp"
+#include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/config.h"
 #include "maidsafe/common/convert.h"
+#include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
 
+#include "maidsafe/vault_manager/client_interface.h"
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/utils.h"
 
 namespace fs = boost::filesystem;
 
@@ -73,6 +81,107 @@ int GetNumRunningProcesses(std::string process_name) {
   }
 }
 
+ScopedEnvironmentVariable::ScopedEnvironmentVariable(std::string name, const std::string& value)
+    : kName_(std::move(name)) {
+#ifdef MAIDSAFE_WIN32
+  _putenv_s(kName_.c_str(), value.c_str());
+#else
+  setenv(kName_.c_str(), value.c_str(), 1);
+#endif
+}
+
+ScopedEnvironmentVariable::~ScopedEnvironmentVariable() {
+#ifdef MAIDSAFE_WIN32
+  _putenv_s(kName_.c_str(), "");
+#else
+  unsetenv(kName_.c_str());
+#endif
+}
+
+fs::path SetUpTestEnvironment() {
+  static const std::shared_ptr<fs::path> kTestEnvRootDir{
+      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
+  SetEnvironment(tcp::Port{7777}, *kTestEnvRootDir,
+                 process::GetOtherExecutablePath("dummy_vault"));
+  boost::system::error_code ignored_ec;
+  fs::remove(*kTestEnvRootDir / kConfigFilename, ignored_ec);
+  return *kTestEnvRootDir;
+}
+
+std::future<std::unique_ptr<passport::PmidAndSigner>> StartDummyVault(
+    ClientInterface& client_interface) {
+#ifdef USE_VLOGGING
+  return client_interface.StartVault(fs::path(), DiskUsage(0), "");
+#else
+  return client_interface.StartVault(fs::path(), DiskUsage(0));
+#endif
+}
+
+LocalConnections::LocalConnections(asio::io_service::strand& strand)
+    : strand_(strand), mutex_(), condition_(), accepted_(), connections_(), listener_() {
+  listener_ = tcp::Listener::MakeShared(strand_, [this](tcp::ConnectionPtr connection) {
+    connection->Start([](tcp::Message) {}, [] {});
+    std::lock_guard<std::mutex> lock{mutex_};
+    accepted_.push_back(connection);
+    condition_.notify_one();
+  }, tcp::Port{9876});
+}
+
+LocalConnections::~LocalConnections() {
+  std::promise<void> stopped;
+  strand_.post([&] {
+    listener_->StopListening();
+    stopped.set_value();
+  });
+  stopped.get_future().get();
+  std::lock_guard<std::mutex> lock{mutex_};
+  for (auto& connection : connections_)
+    connection->Close();
+  for (auto& connection : accepted_)
+    connection->Close();
+}
+
+tcp::ConnectionPtr LocalConnections::Connect(tcp::MessageReceivedFunctor on_message) {
+  auto connection(tcp::Connection::MakeShared(strand_, listener_->ListeningPort()));
+  if (!on_message)
+    on_message = [](tcp::Message) {};
+  connection->Start(on_message, [] {});
+  std::unique_lock<std::mutex> lock{mutex_};
+  connections_.push_back(connection);
+  std::size_t expected_count{connections_.size()};
+  if (!condition_.wait_for(lock, std::chrono::seconds(10),
+                           [&] { return accepted_.size() >= expected_count; })) {
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::timed_out));
+  }
+  return accepted_.back();
+}
+
+VaultEventRecorder::VaultEventRecorder(ClientInterface& client_interface)
+    : client_interface_(client_interface), mutex_(), condition_(), events_() {
+  client_interface_.SubscribeToVaultEvents([this](VaultEvent event) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    events_.push_back(std::move(event));
+    condition_.notify_all();
+  });
+}
+
+VaultEventRecorder::~VaultEventRecorder() { client_interface_.SubscribeToVaultEvents(nullptr); }
+
+bool VaultEventRecorder::WaitFor(const NonEmptyString& label, VaultEventType type,
+                                 std::chrono::steady_clock::duration timeout) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  return condition_.wait_for(lock, timeout, [&] {
+    return std::any_of(std::begin(events_), std::end(events_), [&](const VaultEvent& event) {
+      return event.label == label && event.type == type;
+    });
+  });
+}
+
+std::vector<VaultEvent> VaultEventRecorder::Events() const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return events_;
+}
+
 }  // namespace test
 
 }  //  namespace vault_manager
@@ -19,16 +19,122 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_TESTS_TEST_UTILS_H_
 #define MAIDSAFE_VAULT_MANAGER_TESTS_TEST_UTILS_H_
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include "asio/io_service_strand.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/types.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/common/tcp/listener.h"
+#include "maidsafe/passport/types.h"
+
+#include "maidsafe/vault_manager/vault_event.h"
 
 namespace maidsafe {
 
 namespace vault_manager {
 
+class ClientInterface;
+
 namespace test {
 
+// Environment variables which turn dummy_vault into a load generator.  Since the VaultManager
+// starts the dummy vaults, these are the only means of configuring them; they're inherited from
+// the environment of the VaultManager.
+//
+// Number of LogMessages to send once configured.
+const char kDummyVaultLogMessagesVar[] = "MAIDSAFE_DUMMY_VAULT_LOG_MESSAGES";
+// Maximum rate of LogMessages per second (unlimited if unset or 0).
+const char kDummyVaultLogRateVar[] = "MAIDSAFE_DUMMY_VAULT_LOG_RATE";
+// Number of additional TCP connections to open and immediately drop, to simulate a storm of
+// reconnecting processes, and the interval in milliseconds between them.
+const char kDummyVaultReconnectsVar[] = "MAIDSAFE_DUMMY_VAULT_RECONNECTS";
+const char kDummyVaultReconnectIntervalVar[] = "MAIDSAFE_DUMMY_VAULT_RECONNECT_INTERVAL_MS";
+// Mean time in milliseconds before the vault crashes (exponentially distributed).  Unset or 0 means
+// the vault doesn't crash.
+const char kDummyVaultMeanCrashIntervalVar[] = "MAIDSAFE_DUMMY_VAULT_MEAN_CRASH_INTERVAL_MS";
+// Time in milliseconds after being configured at which the dummy vault's work loop hangs, so that
+// it stops answering heartbeats while the process stays up.  Unset or 0 means it doesn't hang.
+const char kDummyVaultHangAfterVar[] = "MAIDSAFE_DUMMY_VAULT_HANG_AFTER_MS";
+// Directory to which each dummy vault writes "dummy_vault_<pid>.csv", with rows of
+// metric,value,unit.
+const char kDummyVaultReportDirVar[] = "MAIDSAFE_DUMMY_VAULT_REPORT_DIR";
+// Exit code used by a dummy vault when it crashes deliberately.
+const int kDummyVaultCrashExitCode = 99;
+// Statistics reported by each dummy vault once configured; other fields are left as 0.
+const uint64_t kDummyVaultChunksStored = 3;
+const uint64_t kDummyVaultBytesUsed = 3072;
+// Each dummy vault also reports having joined the network, with this routing table health.
+const int kDummyVaultNetworkHealth = 100;
+
 int GetNumRunningProcesses(std::string process_name);
 
+// Sets an environment variable (e.g. one of the above) for the lifetime of this object.  Vaults
+// started by a VaultManager in this process meanwhile inherit it.
+class ScopedEnvironmentVariable {
+ public:
+  ScopedEnvironmentVariable(std::string name, const std::string& value);
+  ~ScopedEnvironmentVariable();
+
+ private:
+  const std::string kName_;
+};
+
+// Sets up the environment for tests which run a VaultManager, with dummy_vault as the vault
+// executable, and returns its root dir.  The environment can only be set once per process, so the
+// root dir is shared by all such tests and lasts until the process exits.  Any config left there by
+// an earlier test's VaultManager is removed so that its vaults aren't restarted.
+boost::filesystem::path SetUpTestEnvironment();
+
+// Starts a vault owned by 'client_interface', placed by the VaultManager.
+std::future<std::unique_ptr<passport::PmidAndSigner>> StartDummyVault(
+    ClientInterface& client_interface);
+
+// Listens on a local port so that tests can make connected pairs of tcp::Connections.  Mustn't be
+// used on 'strand'.
+class LocalConnections {
+ public:
+  explicit LocalConnections(asio::io_service::strand& strand);
+  // Closes all the connections made.
+  ~LocalConnections();
+  // Returns the accepted end of a new connection, started with no-op handlers.  The connecting end
+  // is started with 'on_message', if given.
+  tcp::ConnectionPtr Connect(tcp::MessageReceivedFunctor on_message = nullptr);
+
+ private:
+  asio::io_service::strand& strand_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<tcp::ConnectionPtr> accepted_, connections_;
+  std::shared_ptr<tcp::Listener> listener_;
+};
+
+// Subscribes to the vault events of a ClientInterface and records them.  Threadsafe.
+class VaultEventRecorder {
+ public:
+  explicit VaultEventRecorder(ClientInterface& client_interface);
+  ~VaultEventRecorder();
+  // Returns true once an event of 'type' has been recorded for the vault with 'label', or false if
+  // that doesn't happen within 'timeout'.
+  bool WaitFor(const NonEmptyString& label, VaultEventType type,
+               std::chrono::steady_clock::duration timeout = std::chrono::seconds(30));
+  std::vector<VaultEvent> Events() const;
+
+ private:
+  ClientInterface& client_interface_;
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::vector<VaultEvent> events_;
+};
+
 }  // namespace test
 
 }  // namespace vault_manager
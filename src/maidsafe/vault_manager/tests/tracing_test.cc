@@ -0,0 +1,51 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/tracing.h"
+
+#include <string>
+#include <thread>
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(TracingTest, BEH_ExportChromeTrace) {
+  // Spans are recorded directly, so this doesn't depend on USE_VAULT_MANAGER_TRACING.
+  { detail::TraceSpan span("TracingTest.MainThread"); }
+  std::thread([] {
+    for (int i(0); i < 10000; ++i)  // More than a thread's buffer holds.
+      detail::TraceSpan span("TracingTest.OtherThread");
+  }).join();
+
+  const std::string kTrace(ExportChromeTrace());
+  EXPECT_EQ(0U, kTrace.find(R"({"displayTimeUnit":"ms","traceEvents":[)"));
+  EXPECT_NE(std::string::npos, kTrace.find(R"({"name":"TracingTest.MainThread","ph":"X")"));
+  EXPECT_NE(std::string::npos, kTrace.find(R"({"name":"TracingTest.OtherThread","ph":"X")"));
+  EXPECT_EQ("]}\n", kTrace.substr(kTrace.size() - 3));
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,97 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/utils.h"
+
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/vault_info.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(UtilsTest, BEH_IsTestEnvironmentRootDir) {
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestUtils")};
+  const fs::path kRootDir(*test_path / "root");
+  EXPECT_FALSE(IsTestEnvironmentRootDir(kRootDir));
+  fs::create_directories(kRootDir / "vault_0");
+  EXPECT_FALSE(IsTestEnvironmentRootDir(kRootDir));
+  std::ofstream(fs::path(kRootDir / "notes.txt").string()) << "not a config file";
+  EXPECT_FALSE(IsTestEnvironmentRootDir(kRootDir));
+  { ConfigFileHandler config_file_handler(kRootDir / kConfigFilename); }
+  EXPECT_TRUE(IsTestEnvironmentRootDir(kRootDir));
+  EXPECT_FALSE(IsTestEnvironmentRootDir(kRootDir / kConfigFilename));
+}
+
+TEST(UtilsTest, BEH_RelocateTestEnvironment) {
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestUtils")};
+  const fs::path kOldRootDir(*test_path / "old"), kNewRootDir(*test_path / "new" / "root");
+  const fs::path kOutsideDir(*test_path / "outside");
+  fs::create_directories(kNewRootDir);
+  EXPECT_THROW(RelocateTestEnvironment(kOldRootDir, kNewRootDir), maidsafe_error);
+
+  // Write a config file as if copied from 'kOldRootDir', with one vault dir outside it.
+  std::vector<VaultInfoPtr> vaults;
+  for (const auto& vault_dir : {kOldRootDir / "vault_0", kOldRootDir / "a" / "vault_1",
+                                kOutsideDir / "vault_2"}) {
+    VaultInfo vault;
+    vault.pmid_and_signer =
+        std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
+    vault.vault_dir = vault_dir;
+    vault.label = GenerateLabel();
+    vault.process_id = 12345;
+    vaults.push_back(std::make_shared<const VaultInfo>(std::move(vault)));
+  }
+  {
+    ConfigFileHandler config_file_handler(kNewRootDir / kConfigFilename);
+    config_file_handler.WriteConfigFile(vaults);
+  }
+
+  // A trailing separator on the old root is ignored.
+  RelocateTestEnvironment(kOldRootDir.string() + "/", kNewRootDir);
+  ConfigFileHandler config_file_handler(kNewRootDir / kConfigFilename);
+  std::vector<VaultInfo> relocated(config_file_handler.ReadConfigFile());
+  ASSERT_EQ(vaults.size(), relocated.size());
+  EXPECT_EQ(kNewRootDir / "vault_0", relocated[0].vault_dir);
+  EXPECT_EQ(kNewRootDir / "a" / "vault_1", relocated[1].vault_dir);
+  EXPECT_EQ(kOutsideDir / "vault_2", relocated[2].vault_dir);
+  for (std::size_t i(0); i < vaults.size(); ++i) {
+    EXPECT_EQ(vaults[i]->label, relocated[i].label);
+    EXPECT_EQ(vaults[i]->pmid_and_signer->first.name(),
+              relocated[i].pmid_and_signer->first.name());
+    EXPECT_EQ(process::ProcessId{0}, relocated[i].process_id);
+  }
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
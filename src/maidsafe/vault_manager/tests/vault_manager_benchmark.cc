@@ -0,0 +1,396 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Measures the VaultManager control plane using dummy_vault processes.  Usage:
+//
+//   bench_vault_manager [<vault_count> ...]
+//
+// For each vault count (default 10, 100 and 1000) a fresh VaultManager is run in-process and driven
+// over its TCP interface by a client which timestamps each response.  Results are written to stdout
+// as CSV: metric,vault_count,value,unit
+//
+// The dummy vaults' load generator options (see tests/test_utils.h) are inherited from this
+// process's environment, so e.g. MAIDSAFE_DUMMY_VAULT_MEAN_CRASH_INTERVAL_MS can be set to measure
+// the VaultManager under churn.  The dummy vaults' own reports are averaged and included in the
+// results with a "dummy_vault_" prefix.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asio/io_service_strand.hpp"
+#include "boost/filesystem/operations.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/make_unique.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/rsa.h"
+#include "maidsafe/common/utils.h"
+#include "maidsafe/common/tcp/connection.h"
+#include "maidsafe/passport/passport.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/vault_manager.h"
+#include "maidsafe/vault_manager/messages/challenge.h"
+#include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/flow_control_ack.h"
+#include "maidsafe/vault_manager/messages/log_message.h"
+#include "maidsafe/vault_manager/messages/start_vault_request.h"
+#include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_running_response.h"
+#include "maidsafe/vault_manager/tests/test_utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+const std::vector<int> kDefaultVaultCounts{10, 100, 1000};
+const int kSequentialStarts(10);
+const int kLogMessagesPerVault(100);
+const int kConfigWriteIterations(20);
+const tcp::Port kBenchPort(7788);
+const std::chrono::seconds kStartVaultTimeout(60);
+const std::chrono::seconds kLogMessageTimeout(60);
+const std::chrono::seconds kShutdownTimeout(120);
+
+void Report(const std::string& metric, int vault_count, double value, const std::string& unit) {
+  std::cout << metric << ',' << vault_count << ',' << value << ',' << unit << std::endl;
+}
+
+double ToMicroseconds(Clock::duration duration) {
+  return static_cast<double>(
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+}
+
+double ToSeconds(Clock::duration duration) { return ToMicroseconds(duration) / 1000000.0; }
+
+void SetEnvironmentVariableIfUnset(const std::string& name, const std::string& value) {
+  if (std::getenv(name.c_str()))
+    return;
+#ifdef MAIDSAFE_WIN32
+  _putenv_s(name.c_str(), value.c_str());
+#else
+  setenv(name.c_str(), value.c_str(), 1);
+#endif
+}
+
+// Speaks the VaultManager's client protocol directly (rather than via ClientInterface) so that each
+// response can be timestamped as it arrives.
+class BenchClient {
+ public:
+  BenchClient()
+      : maid_and_signer_(passport::CreateMaidAndSigner()),
+        mutex_(),
+        on_challenge_(),
+        pending_starts_(),
+        log_message_count_(0),
+        first_log_message_(),
+        last_log_message_(),
+        unacknowledged_messages_(0),
+        asio_service_(1),
+        strand_(asio_service_.service()),
+        tcp_connection_(tcp::Connection::MakeShared(strand_, GetInitialListeningPort())) {
+    auto challenge_future(on_challenge_.get_future());
+    tcp_connection_->Start([this](tcp::Message message) { HandleMessage(std::move(message)); },
+                           [] {});
+    Send(tcp_connection_, ValidateConnectionRequest());
+    if (challenge_future.wait_for(kRpcTimeout) != std::future_status::ready)
+      BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::timed_out));
+    Send(tcp_connection_,
+         ChallengeResponse(passport::PublicMaid(maid_and_signer_.first),
+                           asymm::Sign(challenge_future.get(),
+                                       maid_and_signer_.first.private_key())));
+  }
+
+  ~BenchClient() {
+    tcp_connection_->Close();
+    asio_service_.Stop();
+  }
+
+  // The future holds the time from sending the request until the VaultManager reports the vault as
+  // running, which it does as soon as the new process has sent VaultStarted.
+  std::future<Clock::duration> StartVault(int pmid_list_index) {
+    NonEmptyString label{GenerateLabel()};
+    StartVaultRequest request(label, fs::path{}, DiskUsage{1 << 20});
+    request.pmid_list_index = pmid_list_index;
+    std::future<Clock::duration> future;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      auto& pending(pending_starts_[label]);
+      pending.first = Clock::now();
+      future = pending.second.get_future();
+    }
+    Send(tcp_connection_, std::move(request));
+    return future;
+  }
+
+  // Returns the number of LogMessages received and the time between the first and last of them.
+  std::pair<int, Clock::duration> LogMessageStats() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return std::make_pair(log_message_count_, last_log_message_ - first_log_message_);
+  }
+
+ private:
+  void HandleMessage(tcp::Message&& message) {
+    auto now(Clock::now());
+    try {
+      InputVectorStream binary_input_stream(std::move(message));
+      MessageTag tag(static_cast<MessageTag>(-1));
+      Parse(binary_input_stream, tag);
+      switch (tag) {
+        case MessageTag::kChallenge:
+          on_challenge_.set_value(Parse<Challenge>(binary_input_stream).plaintext);
+          break;
+        case MessageTag::kVaultRunningResponse:
+          HandleVaultRunningResponse(Parse<VaultRunningResponse>(binary_input_stream), now);
+          break;
+        case MessageTag::kVaultNetworkStatus:
+          AcknowledgeDroppableMessage();
+          break;
+        case MessageTag::kLogMessage: {
+          AcknowledgeDroppableMessage();
+          std::lock_guard<std::mutex> lock{mutex_};
+          if (log_message_count_++ == 0)
+            first_log_message_ = now;
+          last_log_message_ = now;
+          break;
+        }
+        default:
+          break;
+      }
+    } catch (const std::exception& e) {
+      LOG(kError) << "Failed to handle incoming message: " << boost::diagnostic_information(e);
+    }
+  }
+
+  // As ClientInterface does, since the VaultManager stops forwarding droppable messages once
+  // kMaxUnacknowledgedMessages are outstanding.
+  void AcknowledgeDroppableMessage() {
+    if (++unacknowledged_messages_ < kFlowControlAckBatch)
+      return;
+    Send(tcp_connection_, FlowControlAck(static_cast<uint32_t>(unacknowledged_messages_)));
+    unacknowledged_messages_ = 0;
+  }
+
+  void HandleVaultRunningResponse(VaultRunningResponse&& response, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto itr(pending_starts_.find(response.vault_label));
+    if (itr == std::end(pending_starts_))
+      return;
+    if (response.error)
+      itr->second.second.set_exception(std::make_exception_ptr(*response.error));
+    else
+      itr->second.second.set_value(now - itr->second.first);
+    pending_starts_.erase(itr);
+  }
+
+  passport::MaidAndSigner maid_and_signer_;
+  std::mutex mutex_;
+  std::promise<asymm::PlainText> on_challenge_;
+  std::map<NonEmptyString, std::pair<Clock::time_point, std::promise<Clock::duration>>>
+      pending_starts_;
+  int log_message_count_;
+  Clock::time_point first_log_message_, last_log_message_;
+  // Only accessed by the connection's message handler.
+  int unacknowledged_messages_;
+  AsioService asio_service_;
+  asio::io_service::strand strand_;
+  tcp::ConnectionPtr tcp_connection_;
+};
+
+// Throws rather than waiting indefinitely if the VaultManager never responds.
+Clock::duration GetStartLatency(std::future<Clock::duration>& future) {
+  if (future.wait_for(kStartVaultTimeout) != std::future_status::ready)
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::timed_out));
+  return future.get();
+}
+
+void ClearDirectory(const fs::path& dir) {
+  for (fs::directory_iterator itr(dir); itr != fs::directory_iterator(); ++itr)
+    fs::remove_all(itr->path());
+}
+
+// Averages each metric across the reports written by the dummy vaults.
+void ReportDummyVaultMetrics(int vault_count, const fs::path& report_dir) {
+  std::map<std::string, std::pair<double, int>> totals;
+  std::map<std::string, std::string> units;
+  int report_count{0};
+  for (fs::directory_iterator itr(report_dir); itr != fs::directory_iterator(); ++itr) {
+    ++report_count;
+    std::ifstream report_file{itr->path().string()};
+    std::string row;
+    std::getline(report_file, row);  // header
+    while (std::getline(report_file, row)) {
+      auto first_comma(row.find(',')), last_comma(row.rfind(','));
+      if (first_comma == std::string::npos || first_comma == last_comma)
+        continue;
+      std::string metric{row.substr(0, first_comma)};
+      auto& total(totals[metric]);
+      total.first += std::stod(row.substr(first_comma + 1, last_comma - first_comma - 1));
+      ++total.second;
+      units[metric] = row.substr(last_comma + 1);
+    }
+  }
+  Report("dummy_vault_reports", vault_count, report_count, "reports");
+  for (const auto& total : totals) {
+    Report("dummy_vault_" + total.first + "_mean", vault_count,
+           total.second.first / total.second.second, units[total.first]);
+  }
+}
+
+void BenchmarkConfigWrite(int vault_count, const fs::path& root_dir) {
+  ConfigFileHandler config_file_handler{root_dir / "bench_config.dat"};
+  std::vector<VaultInfoPtr> vaults;
+  for (int i(0); i < vault_count; ++i) {
+    VaultInfo vault;
+    vault.pmid_and_signer = std::make_shared<passport::PmidAndSigner>(GetPmidAndSigner(i));
+    vault.vault_dir = root_dir / std::to_string(i);
+    vault.label = GenerateLabel();
+    vault.max_disk_usage = DiskUsage{1 << 20};
+    vaults.push_back(std::make_shared<const VaultInfo>(std::move(vault)));
+  }
+  auto start(Clock::now());
+  for (int i(0); i < kConfigWriteIterations; ++i)
+    config_file_handler.WriteConfigFile(vaults);
+  Report("config_write_mean", vault_count,
+         ToMicroseconds(Clock::now() - start) / kConfigWriteIterations, "us");
+}
+
+void BenchmarkVaultManager(int vault_count, const fs::path& root_dir) {
+  ClearDirectory(root_dir);
+  const fs::path kReportDir{root_dir / "reports"};
+  fs::create_directories(kReportDir);
+  SetEnvironmentVariableIfUnset(kDummyVaultLogMessagesVar, std::to_string(kLogMessagesPerVault));
+  SetEnvironmentVariableIfUnset(kDummyVaultReportDirVar, kReportDir.string());
+  auto vault_manager(maidsafe::make_unique<VaultManager>());
+  auto client(maidsafe::make_unique<BenchClient>());
+
+  // Vaults started one at a time give the unloaded spawn-to-VaultStarted latency.
+  const int kSequentialCount{std::min(kSequentialStarts, vault_count)};
+  std::vector<Clock::duration> latencies;
+  for (int i(0); i < kSequentialCount; ++i) {
+    auto future(client->StartVault(i));
+    latencies.push_back(GetStartLatency(future));
+  }
+  std::sort(std::begin(latencies), std::end(latencies));
+  Report("spawn_to_vault_started_p50", vault_count, ToMicroseconds(latencies[latencies.size() / 2]),
+         "us");
+  Report("spawn_to_vault_started_max", vault_count, ToMicroseconds(latencies.back()), "us");
+
+  // The remainder are requested all at once to measure throughput.
+  if (vault_count > kSequentialCount) {
+    std::vector<std::future<Clock::duration>> futures;
+    auto start(Clock::now());
+    for (int i(kSequentialCount); i < vault_count; ++i)
+      futures.push_back(client->StartVault(i));
+    for (auto& future : futures)
+      GetStartLatency(future);
+    Report("start_vault_throughput", vault_count,
+           (vault_count - kSequentialCount) / ToSeconds(Clock::now() - start), "vaults/s");
+  }
+
+  const int kExpectedLogMessages{vault_count * std::stoi(std::getenv(kDummyVaultLogMessagesVar))};
+  auto deadline(Clock::now() + kLogMessageTimeout);
+  while (client->LogMessageStats().first < kExpectedLogMessages && Clock::now() < deadline)
+    Sleep(std::chrono::milliseconds(100));
+  auto log_message_stats(client->LogMessageStats());
+  Report("log_messages_forwarded", vault_count, log_message_stats.first, "messages");
+  if (log_message_stats.second > Clock::duration::zero()) {
+    Report("log_message_forwarding_rate", vault_count,
+           log_message_stats.first / ToSeconds(log_message_stats.second), "messages/s");
+  }
+
+  client.reset();
+  auto start(Clock::now());
+  vault_manager.reset();
+  deadline = Clock::now() + kShutdownTimeout;
+  while (GetNumRunningProcesses("dummy_vault") > 0 && Clock::now() < deadline)
+    Sleep(std::chrono::milliseconds(100));
+  Report("shutdown", vault_count, ToMicroseconds(Clock::now() - start) / 1000.0, "ms");
+  Report("vaults_left_running", vault_count, GetNumRunningProcesses("dummy_vault"), "processes");
+  ReportDummyVaultMetrics(vault_count, std::getenv(kDummyVaultReportDirVar));
+}
+
+}  // unnamed namespace
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+int main(int argc, char* argv[]) {
+  namespace test = maidsafe::vault_manager::test;
+  fs::path root_dir;
+  int result{0};
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    std::vector<int> vault_counts;
+    for (std::size_t i(1); i < unuseds.size(); ++i)
+      vault_counts.push_back(std::stoi(std::string{&unuseds[i][0]}));
+    if (vault_counts.empty())
+      vault_counts = test::kDefaultVaultCounts;
+    if (std::any_of(std::begin(vault_counts), std::end(vault_counts),
+                    [](int count) { return count < 1; })) {
+      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+    }
+
+    root_dir = fs::temp_directory_path() / fs::unique_path("MaidSafe_BenchVaultManager_%%%%-%%%%");
+    fs::create_directories(root_dir);
+    const int kMaxVaultCount{*std::max_element(std::begin(vault_counts), std::end(vault_counts))};
+    std::cerr << "Generating " << kMaxVaultCount << " Pmids; this may take a while..." << std::endl;
+    test::SetEnvironment(test::kBenchPort, root_dir,
+                         maidsafe::process::GetOtherExecutablePath("dummy_vault"), kMaxVaultCount);
+
+    std::cout << "metric,vault_count,value,unit" << std::endl;
+    for (int vault_count : vault_counts) {
+      test::BenchmarkConfigWrite(vault_count, root_dir);
+      test::BenchmarkVaultManager(vault_count, root_dir);
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << boost::diagnostic_information(e) << '\n';
+    result = -1;
+  }
+  boost::system::error_code ignored_ec;
+  if (!root_dir.empty())
+    fs::remove_all(root_dir, ignored_ec);
+  return result;
+}
@@ -18,20 +18,23 @@
 
 #include "maidsafe/vault_manager/vault_manager.h"
 
+#include <chrono>
 #include <memory>
+#include <thread>
+#include <vector>
 
-#include "boost/filesystem/path.hpp"
-
-#include "maidsafe/common/process.h"
+#include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/utils.h"
+#include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/client_interface.h"
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/config_file_handler.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/vault_info.h"
 #include "maidsafe/vault_manager/tests/test_utils.h"
 
-namespace fs = boost::filesystem;
-
 namespace maidsafe {
 
 namespace vault_manager {
@@ -39,16 +42,107 @@ namespace vault_manager {
 namespace test {
 
 TEST(VaultManagerTest, BEH_Basic) {
-  std::shared_ptr<fs::path> test_env_root_dir{
-      maidsafe::test::CreateTestPath("MaidSafe_TestVaultManager")};
-  fs::path path_to_vault{process::GetOtherExecutablePath("dummy_vault")};
-  SetEnvironment(tcp::Port{7777}, *test_env_root_dir, path_to_vault);
+  SetUpTestEnvironment();
 
   VaultManager vault_manager;
 
   std::this_thread::sleep_for(std::chrono::seconds(1));
 }
 
+namespace {
+
+// Waits for the client's only vault to be running, and returns its details.
+VaultSummary WaitForRunningVault(ClientInterface& client_interface) {
+  const auto kDeadline(std::chrono::steady_clock::now() + kVaultReconnectTimeout);
+  for (;;) {
+    VaultList vault_list{client_interface.ListVaults().get()};
+    if (vault_list.vaults.size() == 1U &&
+        vault_list.vaults.front().status == ProcessStatus::kRunning) {
+      return vault_list.vaults.front();
+    }
+    if (std::chrono::steady_clock::now() > kDeadline)
+      BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::timed_out));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+}  // unnamed namespace
+
+TEST(VaultManagerTest, BEH_Handover) {
+  SetUpTestEnvironment();
+  const passport::MaidAndSigner kMaidAndSigner{passport::CreateMaidAndSigner()};
+  VaultSummary original;
+  {
+    auto vault_manager(maidsafe::make_unique<VaultManager>());
+    ClientInterface client_interface{kMaidAndSigner.first};
+    StartDummyVault(client_interface).get();
+    ASSERT_NO_THROW(original = WaitForRunningVault(client_interface));
+    ASSERT_NE(0U, original.process_id);
+    vault_manager->TearDownForHandover();
+    vault_manager.reset();
+  }
+
+  // The vault keeps running and reconnects to the new VaultManager, which adopts it rather than
+  // starting a new process.
+  VaultManager vault_manager;
+  ClientInterface client_interface{kMaidAndSigner.first};
+  VaultSummary adopted;
+  ASSERT_NO_THROW(adopted = WaitForRunningVault(client_interface));
+  EXPECT_EQ(original.label, adopted.label);
+  EXPECT_EQ(original.vault_dir, adopted.vault_dir);
+  EXPECT_EQ(original.process_id, adopted.process_id);
+  EXPECT_EQ(0, adopted.restart_count);
+  EXPECT_NO_THROW(client_interface.RemoveVault(adopted.label).get());
+}
+
+TEST(VaultManagerTest, BEH_StopClearsProcessIds) {
+  SetUpTestEnvironment();
+  const passport::MaidAndSigner kMaidAndSigner{passport::CreateMaidAndSigner()};
+  {
+    VaultManager vault_manager;
+    ClientInterface client_interface{kMaidAndSigner.first};
+    StartDummyVault(client_interface).get();
+    ASSERT_NO_THROW(WaitForRunningVault(client_interface));
+  }
+
+  // The vault was stopped with the VaultManager, so the next one mustn't try to adopt it.
+  ConfigFileHandler config_file_handler{GetTestEnvironmentRootDir() / kConfigFilename};
+  std::vector<VaultInfo> vaults{config_file_handler.ReadConfigFile()};
+  ASSERT_EQ(1U, vaults.size());
+  EXPECT_EQ(process::ProcessId{0}, vaults.front().process_id);
+}
+
+TEST(VaultManagerTest, BEH_StandbyPool) {
+  SetUpTestEnvironment();
+  // Only takes effect once a vault is configured, so standby processes keep running until they're
+  // assigned a vault, but then soon crash.
+  ScopedEnvironmentVariable crash{kDummyVaultMeanCrashIntervalVar, "200"};
+  VaultManager vault_manager{2};
+  ClientInterface client_interface{passport::CreateMaidAndSigner().first};
+  VaultEventRecorder recorder{client_interface};
+
+  // Give the standby processes time to start and connect.
+  const auto kDeadline(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+  while (GetNumRunningProcesses("dummy_vault") < 2 && std::chrono::steady_clock::now() < kDeadline)
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  ASSERT_GE(GetNumRunningProcesses("dummy_vault"), 2);
+  std::this_thread::sleep_for(std::chrono::seconds(1));
+
+  // The new vault is assigned a standby process, so is connected without being spawned.
+  StartDummyVault(client_interface).get();
+  NonEmptyString label{client_interface.ListVaults().get().vaults.at(0).label};
+  ASSERT_TRUE(recorder.WaitFor(label, VaultEventType::kConnected));
+  for (const auto& event : recorder.Events()) {
+    if (event.label == label && event.type == VaultEventType::kConnected)
+      break;
+    EXPECT_FALSE(event.label == label && event.type == VaultEventType::kSpawned);
+  }
+
+  // The exit of a process which was a standby is still handled as the vault's.
+  EXPECT_TRUE(recorder.WaitFor(label, VaultEventType::kExited));
+  EXPECT_TRUE(recorder.WaitFor(label, VaultEventType::kRestarting));
+}
+
 }  // namespace test
 
 }  // namespace vault_manager
@@ -0,0 +1,113 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_placement.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace test {
+
+TEST(VaultPlacementTest, BEH_ChooseVolume) {
+  const std::uint64_t kGigabyte(1024 * 1024 * 1024);
+  std::vector<VolumeState> volumes;
+  volumes.push_back(VolumeState{"a", "8:1", 100 * kGigabyte, 0, 0.0});
+  volumes.push_back(VolumeState{"b", "8:17", 300 * kGigabyte, 0, 0.0});
+  volumes.push_back(VolumeState{"c", "8:33", 0, 0, 0.0});
+
+  // The most free space wins when all else is equal.
+  EXPECT_EQ(1U, ChooseVolume(volumes));
+  // Free space is shared between the vaults already on a device.
+  volumes[1].vault_count = 3;
+  EXPECT_EQ(0U, ChooseVolume(volumes));
+  // A busy device is avoided.
+  volumes[1].vault_count = 0;
+  volumes[1].io_load = 1.0;
+  volumes[0].vault_count = 0;
+  volumes[0].available = 200 * kGigabyte;
+  EXPECT_EQ(0U, ChooseVolume(volumes));
+
+  VolumeState volume{"a", "8:1", 100 * kGigabyte, 0, 0.0};
+  EXPECT_EQ(DiskUsage{90 * kGigabyte}, VaultShare(volume));
+  volume.vault_count = 2;
+  EXPECT_EQ(DiskUsage{30 * kGigabyte}, VaultShare(volume));
+
+  // Volumes with no space are never chosen.
+  volumes.erase(volumes.begin(), volumes.begin() + 2);
+  EXPECT_THROW(ChooseVolume(volumes), maidsafe_error);
+  EXPECT_THROW(ChooseVolume(std::vector<VolumeState>()), maidsafe_error);
+}
+
+TEST(VaultPlacementTest, BEH_ParseDiskStats) {
+  std::istringstream disk_stats(
+      "   8       0 sda 1 2 3 4 5 6 7 8 0 1234 5678\n"
+      "   8       1 sda1 1 2 3 4 5 6 7 8 0 99 5678 0 0 0 0 0 0\n"
+      " 253       0 dm-0 1 2 3\n"
+      "garbage\n");
+  auto io_ticks(ParseDiskStats(disk_stats));
+  ASSERT_EQ(2U, io_ticks.size());
+  EXPECT_EQ(1234U, io_ticks.at("8:0"));
+  EXPECT_EQ(99U, io_ticks.at("8:1"));
+}
+
+TEST(VaultPlacementTest, BEH_Place) {
+  maidsafe::test::TestPath test_path{maidsafe::test::CreateTestPath("MaidSafe_TestVaultPlacement")};
+  const fs::path kDefaultVolume(*test_path / "default");
+  {
+    VaultPlacer vault_placer(std::vector<fs::path>(), kDefaultVolume);
+    VaultPlacement placement{vault_placer.Place(std::vector<fs::path>(), "vault")};
+    EXPECT_EQ(kDefaultVolume / "vault", placement.vault_dir);
+    EXPECT_FALSE(fs::exists(placement.vault_dir));
+    EXPECT_NE(DiskUsage{0}, placement.max_disk_usage);
+  }
+
+  // Both volumes are on the same device, so every vault counts against each of them, and a vault
+  // placed earlier counts even before it's reported as existing.
+  std::vector<fs::path> volumes{*test_path / "a", *test_path / "b"};
+  VaultPlacer vault_placer(volumes, kDefaultVolume);
+  VaultPlacement first{vault_placer.Place(std::vector<fs::path>(), "first")};
+  VaultPlacement second{vault_placer.Place(std::vector<fs::path>(), "second")};
+  EXPECT_EQ("first", first.vault_dir.filename().string());
+  EXPECT_EQ("second", second.vault_dir.filename().string());
+  EXPECT_LT(second.max_disk_usage, first.max_disk_usage);
+  VaultPlacement third{vault_placer.Place(std::vector<fs::path>{first.vault_dir}, "third")};
+  EXPECT_LT(third.max_disk_usage, second.max_disk_usage);
+
+  // Vaults which failed to start no longer count once forgotten.
+  vault_placer.Forget(second.vault_dir);
+  vault_placer.Forget(third.vault_dir);
+  vault_placer.SampleIoLoad();
+  vault_placer.SampleIoLoad();
+  VaultPlacement fourth{vault_placer.Place(std::vector<fs::path>{first.vault_dir}, "fourth")};
+  EXPECT_GT(fourth.max_disk_usage, third.max_disk_usage);
+}
+
+}  // namespace test
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,245 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/tools/actions/snapshot_network.h"
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/property_tree/ini_parser.hpp"
+#include "boost/property_tree/ptree.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/make_unique.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/passport/passport.h"
+#include "maidsafe/routing/tests/zero_state_helpers.h"
+
+#include "maidsafe/vault_manager/client_interface.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/tools/local_network_controller.h"
+#include "maidsafe/vault_manager/tools/utils.h"
+#include "maidsafe/vault_manager/tools/actions/start_network.h"
+
+namespace fs = boost::filesystem;
+namespace pt = boost::property_tree;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace tools {
+
+namespace {
+
+// Layout of a snapshot directory.
+const char kRootDirName[] = "root";
+const char kBootstrapFileName[] = "local_network_bootstrap.dat";
+const char kKeysFileName[] = "keys.dat";
+const char kInfoFileName[] = "snapshot.ini";
+
+void ThrowInvalidSnapshot(const std::string& reason) {
+  TLOG(kRed) << "Invalid network snapshot: " << reason << '\n';
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+}
+
+// Creates the directory tree of 'from' under 'to', and appends the (source, target) pair of each
+// regular file to 'files'.
+void ListFiles(const fs::path& from, const fs::path& to,
+               std::vector<std::pair<fs::path, fs::path>>& files) {
+  fs::create_directories(to);
+  for (fs::directory_iterator itr(from), end; itr != end; ++itr) {
+    if (fs::is_directory(itr->status()))
+      ListFiles(itr->path(), to / itr->path().filename(), files);
+    else if (fs::is_regular_file(itr->status()))
+      files.emplace_back(itr->path(), to / itr->path().filename());
+  }
+}
+
+// A network's directories hold many small chunk files, so these are copied by several threads.
+void CopyDirectory(const fs::path& from, const fs::path& to) {
+  std::vector<std::pair<fs::path, fs::path>> files;
+  ListFiles(from, to, files);
+  std::atomic<size_t> next_index{0};
+  std::vector<std::future<void>> workers;
+  const int kWorkerCount(std::max(
+      1, std::min(static_cast<int>(files.size()),
+                  static_cast<int>(std::thread::hardware_concurrency()) * 2)));
+  for (int i(0); i < kWorkerCount; ++i) {
+    workers.emplace_back(std::async(std::launch::async, [&] {
+      for (size_t index(next_index++); index < files.size(); index = next_index++) {
+        fs::copy_file(files[index].first, files[index].second,
+                      fs::copy_option::overwrite_if_exists);
+      }
+    }));
+  }
+  for (auto& worker : workers)
+    worker.get();
+  LOG(kInfo) << "Copied " << files.size() << " files from " << from << " to " << to;
+}
+
+// Returns true if 'path' is 'dir' or is inside it.  Both must exist.
+bool IsWithin(const fs::path& path, const fs::path& dir) {
+  const fs::path kDir(fs::canonical(dir));
+  for (fs::path parent(fs::canonical(path)); !parent.empty(); parent = parent.parent_path()) {
+    if (parent == kDir)
+      return true;
+  }
+  return false;
+}
+
+void PrepareRestoreDir(const fs::path& snapshot_dir, const fs::path& test_env_root_dir) {
+  if (!fs::exists(test_env_root_dir)) {
+    fs::create_directories(test_env_root_dir);
+    return;
+  }
+  if (!fs::is_directory(test_env_root_dir))
+    ThrowInvalidSnapshot(test_env_root_dir.string() + " is not a directory.");
+  if (fs::is_empty(test_env_root_dir))
+    return;
+  if (!test::IsTestEnvironmentRootDir(test_env_root_dir)) {
+    ThrowInvalidSnapshot(test_env_root_dir.string() +
+                         " is not empty and is not the root dir of an earlier test network.");
+  }
+  if (IsWithin(snapshot_dir, test_env_root_dir))
+    ThrowInvalidSnapshot("can't restore over the directory holding the snapshot.");
+  TLOG(kDefaultColour) << "Removing earlier test network in " << test_env_root_dir << '\n';
+  fs::remove_all(test_env_root_dir);
+  fs::create_directories(test_env_root_dir);
+}
+
+void WriteKeys(const LocalNetworkController* local_network_controller, const fs::path& path) {
+  // Each entry holds the client's Maid and one Pmid of the test environment's list.
+  std::vector<passport::detail::AnmaidToPmid> key_chains;
+  const passport::MaidAndSigner& kMaidAndSigner(*local_network_controller->maid_and_signer);
+  for (int i(0); i < local_network_controller->vault_count + 2; ++i) {
+    passport::PmidAndSigner pmid_and_signer(GetPmidAndSigner(i));
+    key_chains.emplace_back(kMaidAndSigner.second, kMaidAndSigner.first, pmid_and_signer.second,
+                            pmid_and_signer.first);
+  }
+  if (!passport::detail::WriteKeyChainList(path, key_chains))
+    ThrowInvalidSnapshot("failed to write " + path.string());
+}
+
+// The test_env_root_dir is only recorded so that the vault dirs (held in the VaultManager config
+// file as absolute paths) can be relocated on restore.
+void WriteInfo(const LocalNetworkController* local_network_controller, const fs::path& path) {
+  pt::ptree tree;
+  tree.put("network.test_env_root_dir", local_network_controller->test_env_root_dir.string());
+  tree.put("network.path_to_vault", local_network_controller->path_to_vault.string());
+  tree.put("network.vault_manager_port", local_network_controller->vault_manager_port);
+  tree.put("network.vault_count", local_network_controller->vault_count);
+  pt::write_ini(path.string(), tree);
+}
+
+}  // unnamed namespace
+
+void SnapshotNetwork(LocalNetworkController* local_network_controller,
+                     const fs::path& snapshot_dir) {
+  if (!local_network_controller->client_interface || !local_network_controller->maid_and_signer)
+    ThrowInvalidSnapshot("there is no running network to snapshot.");
+  if (fs::exists(snapshot_dir) &&
+      !(fs::is_directory(snapshot_dir) && fs::is_empty(snapshot_dir))) {
+    ThrowInvalidSnapshot(snapshot_dir.string() + " is not an empty directory.");
+  }
+
+  TLOG(kDefaultColour) << "Stopping network to snapshot it to " << snapshot_dir << '\n';
+  local_network_controller->client_interface.reset();
+  local_network_controller->vault_manager.reset();
+
+  CopyDirectory(local_network_controller->test_env_root_dir, snapshot_dir / kRootDirName);
+  fs::copy_file(routing::test::LocalNetworkBootstrapFile(), snapshot_dir / kBootstrapFileName,
+                fs::copy_option::overwrite_if_exists);
+  WriteKeys(local_network_controller, snapshot_dir / kKeysFileName);
+  WriteInfo(local_network_controller, snapshot_dir / kInfoFileName);
+
+  // The VaultManager restarts the vaults from its config file.
+  StartVaultManagerAndClientInterface(local_network_controller);
+  WaitForNetworkToStabilise(local_network_controller);
+  local_network_controller->client_interface->MarkNetworkAsStable();
+  TLOG(kGreen) << "Snapshot of " << local_network_controller->vault_count
+               << " Vaults saved and network restarted.\n";
+}
+
+void RestoreNetwork(LocalNetworkController* local_network_controller,
+                    const fs::path& snapshot_dir, const fs::path& test_env_root_dir) {
+  if (!fs::is_directory(snapshot_dir / kRootDirName) ||
+      !fs::is_regular_file(snapshot_dir / kBootstrapFileName) ||
+      !fs::is_regular_file(snapshot_dir / kKeysFileName) ||
+      !fs::is_regular_file(snapshot_dir / kInfoFileName)) {
+    ThrowInvalidSnapshot(snapshot_dir.string() + " is incomplete or not a snapshot.");
+  }
+  pt::ptree tree;
+  fs::path snapshot_test_env_root_dir;
+  std::vector<passport::detail::AnmaidToPmid> key_chains;
+  try {
+    pt::read_ini((snapshot_dir / kInfoFileName).string(), tree);
+    snapshot_test_env_root_dir = tree.get<std::string>("network.test_env_root_dir");
+    local_network_controller->path_to_vault = tree.get<std::string>("network.path_to_vault");
+    local_network_controller->vault_manager_port = tree.get<int>("network.vault_manager_port");
+    local_network_controller->vault_count = tree.get<int>("network.vault_count");
+    key_chains = passport::detail::ReadKeyChainList(snapshot_dir / kKeysFileName);
+  } catch (const std::exception& e) {
+    ThrowInvalidSnapshot(e.what());
+  }
+  if (static_cast<int>(key_chains.size()) != local_network_controller->vault_count + 2)
+    ThrowInvalidSnapshot("the number of keys doesn't match the number of vaults.");
+
+  PrepareRestoreDir(snapshot_dir, test_env_root_dir);
+  TLOG(kDefaultColour) << "Restoring " << local_network_controller->vault_count
+                       << " Vaults from " << snapshot_dir << " to " << test_env_root_dir << '\n';
+  local_network_controller->new_network = false;
+  local_network_controller->test_env_root_dir = test_env_root_dir;
+  CopyDirectory(snapshot_dir / kRootDirName, test_env_root_dir);
+  test::RelocateTestEnvironment(snapshot_test_env_root_dir, test_env_root_dir);
+  fs::copy_file(snapshot_dir / kBootstrapFileName, routing::test::LocalNetworkBootstrapFile(),
+                fs::copy_option::overwrite_if_exists);
+  maidsafe::test::PrepareBootstrapFile(routing::test::LocalNetworkBootstrapFile());
+
+  std::vector<passport::PmidAndSigner> pmids_and_signers;
+  for (auto& key_chain : key_chains)
+    pmids_and_signers.emplace_back(std::move(key_chain.pmid), std::move(key_chain.anpmid));
+  ClientInterface::SetTestEnvironment(
+      static_cast<tcp::Port>(local_network_controller->vault_manager_port),
+      local_network_controller->test_env_root_dir, local_network_controller->path_to_vault,
+      std::move(pmids_and_signers));
+  // The vaults are owned by the Maid which created them.
+  local_network_controller->maid_and_signer = maidsafe::make_unique<passport::MaidAndSigner>(
+      std::move(key_chains.front().maid), std::move(key_chains.front().anmaid));
+
+  // The VaultManager restarts the vaults from its restored config file.
+  StartVaultManagerAndClientInterface(local_network_controller);
+  WaitForNetworkToStabilise(local_network_controller);
+  local_network_controller->client_interface->MarkNetworkAsStable();
+  TLOG(kGreen)
+      << "Network restored successfully.\n"
+      << "To keep the network alive or stay connected to VaultManager, do not exit this tool.\n";
+}
+
+}  // namespace tools
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,53 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TOOLS_ACTIONS_SNAPSHOT_NETWORK_H_
+#define MAIDSAFE_VAULT_MANAGER_TOOLS_ACTIONS_SNAPSHOT_NETWORK_H_
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace tools {
+
+struct LocalNetworkController;
+
+// Captures the running network's VaultManager config, vault directories (including chunkstores),
+// routing bootstrap file and keys into 'snapshot_dir', which must be empty or not exist.  The
+// vaults are stopped while being copied so that their chunkstores are consistent, then restarted.
+void SnapshotNetwork(LocalNetworkController* local_network_controller,
+                     const boost::filesystem::path& snapshot_dir);
+
+// Recreates the network captured in 'snapshot_dir' in 'test_env_root_dir', and waits for it to
+// stabilise.  'test_env_root_dir' needn't be the one from which the snapshot was taken, but must be
+// empty, not exist, or be the root dir of an earlier test environment (which is replaced).  Unlike
+// StartNetwork, this doesn't need zero-state nodes or to store the PublicPmids, since these are
+// already held by the vaults.
+void RestoreNetwork(LocalNetworkController* local_network_controller,
+                    const boost::filesystem::path& snapshot_dir,
+                    const boost::filesystem::path& test_env_root_dir);
+
+}  // namespace tools
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TOOLS_ACTIONS_SNAPSHOT_NETWORK_H_
@@ -18,8 +18,14 @@
 
 #include "maidsafe/vault_manager/tools/actions/start_network.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -37,16 +43,20 @@
 #include "maidsafe/passport/passport.h"
 #include "maidsafe/routing/routing_api.h"
 #include "maidsafe/routing/node_info.h"
+#include "maidsafe/routing/parameters.h"
 #include "maidsafe/routing/tests/zero_state_helpers.h"
 #include "maidsafe/nfs/utils.h"
 #include "maidsafe/nfs/client/data_getter.h"
 #include "maidsafe/nfs/client/maid_client.h"
 
 #include "maidsafe/vault_manager/client_interface.h"
+#include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/vault_manager.h"
 #include "maidsafe/vault_manager/tools/local_network_controller.h"
 #include "maidsafe/vault_manager/tools/utils.h"
+#include "maidsafe/vault_manager/tools/actions/snapshot_network.h"
+#include "maidsafe/vault_manager/tools/commands/choose_test.h"
 
 
 namespace fs = boost::filesystem;
@@ -155,53 +165,121 @@ std::future<std::unique_ptr<passport::PmidAndSigner>> StartVault(
 #endif
 }
 
-void StartFirstTwoVaults(LocalNetworkController* local_network_controller, DiskUsage max_usage) {
-  TLOG(kDefaultColour) << "Starting vault 1\n";  // index 2 in pmid list
-  std::string vault_dir_name{DebugId(GetPmidAndSigner(2).first.name().value)};
+std::future<std::unique_ptr<passport::PmidAndSigner>> StartVault(
+    LocalNetworkController* local_network_controller, DiskUsage max_usage, int pmid_list_index) {
+  std::string vault_dir_name{DebugId(GetPmidAndSigner(pmid_list_index).first.name().value)};
   fs::create_directories(local_network_controller->test_env_root_dir / vault_dir_name);
-  auto first_vault_future(StartVault(local_network_controller,
-                                     local_network_controller->test_env_root_dir / vault_dir_name,
-                                     max_usage, 2));
-  try {
-    first_vault_future.get();
-  } catch (const std::exception& e) {
-    LOG(kWarning) << boost::diagnostic_information(e);
-  }
-  Sleep(std::chrono::seconds(3));
+  return StartVault(local_network_controller,
+                    local_network_controller->test_env_root_dir / vault_dir_name, max_usage,
+                    pmid_list_index);
+}
 
-  TLOG(kDefaultColour) << "Starting vault 2\n";  // index 3 in pmid list
-  vault_dir_name = DebugId(GetPmidAndSigner(3).first.name().value);
-  fs::create_directories(local_network_controller->test_env_root_dir / vault_dir_name);
-  auto second_vault_future(StartVault(local_network_controller,
-                                      local_network_controller->test_env_root_dir / vault_dir_name,
-                                      max_usage, 3));
-  try {
-    second_vault_future.get();
-  } catch (const std::exception& e) {
-    LOG(kWarning) << boost::diagnostic_information(e);
+// Returns true if any of the client's vaults has reported its routing table health.  Vaults aren't
+// required to do so.
+bool VaultsReportNetworkHealth(LocalNetworkController* local_network_controller) {
+  VaultList vault_list{local_network_controller->client_interface->ListVaults().get()};
+  return std::any_of(std::begin(vault_list.vaults), std::end(vault_list.vaults),
+                     [](const VaultSummary& vault) { return vault.network_health >= 0; });
+}
+
+// Routing reports health as the percentage of its routing table which is filled.  Once the network
+// is stable, each vault should have all the others in its routing table, up to its capacity.
+int ExpectedNetworkHealth(int vault_count) {
+  const int kMaxRoutingTableSize(static_cast<int>(routing::Parameters::max_routing_table_size));
+  return (100 * std::min(vault_count - 1, kMaxRoutingTableSize)) / kMaxRoutingTableSize;
+}
+
+void StartFirstTwoVaults(LocalNetworkController* local_network_controller, DiskUsage max_usage) {
+  for (int i(2); i < 4; ++i) {
+    TLOG(kDefaultColour) << "Starting vault " << i - 1 << '\n';  // index i in pmid list
+    auto vault_future(StartVault(local_network_controller, max_usage, i));
+    try {
+      vault_future.get();
+    } catch (const std::exception& e) {
+      LOG(kWarning) << boost::diagnostic_information(e);
+    }
+    // Each of these must have joined via the zero state nodes before the next one is started.
+    try {
+      local_network_controller->client_interface->WaitForJoinedVaults(
+          i - 1, 0, local_network_controller->join_timeout).get();
+    } catch (const std::exception& e) {
+      TLOG(kRed) << "Vault " << i - 1 << " failed to join the network within "
+                 << local_network_controller->join_timeout.count() << "s: " << e.what() << '\n';
+      throw;
+    }
   }
-  Sleep(std::chrono::seconds(3));
 }
 
 void StartRemainingVaults(LocalNetworkController* local_network_controller, DiskUsage max_usage) {
   const int kRemainingIndex(local_network_controller->vault_count + 2);
+  const int kParallelism(local_network_controller->start_parallelism);
+  std::vector<std::future<std::unique_ptr<passport::PmidAndSigner>>> vault_futures;
   for (int i(4); i < kRemainingIndex; ++i) {
+    // Before starting vault 'i - 1', wait until fewer than 'kParallelism' vaults are still joining.
+    const int kRequiredJoinedCount(i - 1 - kParallelism);
+    if (kRequiredJoinedCount > 2) {
+      local_network_controller->client_interface->WaitForJoinedVaults(
+          kRequiredJoinedCount, 0, local_network_controller->join_timeout).get();
+    }
+    // Fail early if the VaultManager has refused to start any vault.
+    for (auto& vault_future : vault_futures) {
+      if (vault_future.valid() &&
+          vault_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        vault_future.get();
+      }
+    }
     TLOG(kDefaultColour) << "Starting vault " << i - 1 << '\n';  // index i in pmid list
-    std::string vault_dir_name{DebugId(GetPmidAndSigner(i).first.name().value)};
-    fs::create_directories(local_network_controller->test_env_root_dir / vault_dir_name);
-    auto vault_future(StartVault(local_network_controller,
-                                 local_network_controller->test_env_root_dir / vault_dir_name,
-                                 max_usage, i));
-    vault_future.get();
-    Sleep(std::chrono::milliseconds(500));
+    vault_futures.emplace_back(StartVault(local_network_controller, max_usage, i));
+  }
+  for (auto& vault_future : vault_futures) {
+    if (vault_future.valid())
+      vault_future.get();
   }
 }
 
 }  // unnamed namespace
 
+void WaitForNetworkToStabilise(LocalNetworkController* local_network_controller) {
+  const int kVaultCount(local_network_controller->vault_count);
+  local_network_controller->client_interface->WaitForJoinedVaults(
+      kVaultCount, 0, local_network_controller->join_timeout).get();
+  if (!VaultsReportNetworkHealth(local_network_controller)) {
+    TLOG(kYellow) << "All " << kVaultCount << " Vaults have joined - not waiting for routing "
+                  << "table health since none of them reports it\n";
+    return;
+  }
+  const int kExpectedNetworkHealth(local_network_controller->min_network_health < 0
+                                       ? ExpectedNetworkHealth(kVaultCount)
+                                       : local_network_controller->min_network_health);
+  const std::chrono::seconds kStabiliseTimeout(
+      local_network_controller->stabilise_timeout.count() == 0
+          ? std::chrono::seconds(kVaultCount * 10)
+          : local_network_controller->stabilise_timeout);
+  TLOG(kDefaultColour) << "All " << kVaultCount << " Vaults have joined - waiting for routing "
+                       << "table health of " << kExpectedNetworkHealth << "%\n";
+  try {
+    local_network_controller->client_interface->WaitForJoinedVaults(
+        kVaultCount, kExpectedNetworkHealth, kStabiliseTimeout).get();
+  } catch (const maidsafe_error& error) {
+    if (error.code() != make_error_code(VaultManagerErrors::timed_out))
+      throw;
+    TLOG(kYellow) << "Not all Vaults reported the expected routing table health - continuing\n";
+  }
+}
+
+// Stores and verifies the PublicPmids of the test environment, with up to 'max_in_flight'
+// Put-then-Get sequences in progress at once.  Each failed sequence is retried up to
+// 'max_attempts' times in total, with the delay doubling after each attempt.  A retry after a
+// successful Put only repeats the Get.
 class PublicPmidStorer {
  public:
-  PublicPmidStorer() : client_nfs_() {
+  PublicPmidStorer(int max_in_flight, int max_attempts, std::chrono::milliseconds initial_backoff)
+      : kMaxInFlight_(std::max(1, max_in_flight)),
+        kMaxAttempts_(std::max(1, max_attempts)),
+        kInitialBackoff_(initial_backoff),
+        client_nfs_(),
+        mutex_(),
+        failures_() {
     const passport::MaidAndSigner kMaidAndSigner{passport::CreateMaidAndSigner()};
     client_nfs_ = nfs_client::MaidClient::MakeSharedZeroState(kMaidAndSigner, GetPublicPmids());
     TLOG(kDefaultColour) << "Account created for Maid " << DebugId(kMaidAndSigner.first.name())
@@ -211,48 +289,96 @@ class PublicPmidStorer {
   ~PublicPmidStorer() { client_nfs_->Stop(); }
 
   void Store() {
-    size_t failures(0);
-    std::vector<passport::PublicPmid> public_pmids{GetPublicPmids()};  // From test environment
-    for (const auto& public_pmid : public_pmids) {
+    // From test environment
+    const std::vector<passport::PublicPmid> kPublicPmids{GetPublicPmids()};
+    std::atomic<size_t> next_index{0};
+    std::vector<std::future<void>> workers;
+    const int kWorkerCount(std::min(kMaxInFlight_, static_cast<int>(kPublicPmids.size())));
+    for (int i(0); i < kWorkerCount; ++i) {
+      workers.emplace_back(std::async(std::launch::async, [&] {
+        for (size_t index(next_index++); index < kPublicPmids.size(); index = next_index++)
+          StoreWithRetries(kPublicPmids[index]);
+      }));
+    }
+    for (auto& worker : workers)
+      worker.get();
+
+    if (!failures_.empty())
+      ReportFailures(kPublicPmids.size());
+  }
+
+ private:
+  void StoreWithRetries(const passport::PublicPmid& public_pmid) {
+    std::chrono::milliseconds backoff(kInitialBackoff_);
+    bool put_succeeded(false);
+    for (int attempt(1);; ++attempt) {
       try {
-        client_nfs_->Put(public_pmid).get();
+        if (!put_succeeded) {
+          client_nfs_->Put(public_pmid).get();
+          put_succeeded = true;
+        }
         auto pmid_future(client_nfs_->Get(public_pmid.name()));
         if (!EqualKeys(public_pmid, pmid_future.get()))
           BOOST_THROW_EXCEPTION(MakeError(AsymmErrors::invalid_public_key));
         LOG(kInfo) << "Pmid " << DebugId(public_pmid.name()) << " public key stored & verified";
+        return;
       } catch (const std::exception& e) {
-        TLOG(kRed) << "Failed storing public key of Pmid " << DebugId(public_pmid.name()) << ": "
-                   << boost::diagnostic_information(e) << '\n';
-        ++failures;
+        if (attempt == kMaxAttempts_) {
+          std::lock_guard<std::mutex> lock{mutex_};
+          failures_[e.what()].push_back(DebugId(public_pmid.name()));
+          return;
+        }
+        LOG(kWarning) << "Attempt " << attempt << " to " << (put_succeeded ? "verify" : "store")
+                      << " public key of Pmid " << DebugId(public_pmid.name()) << " failed: "
+                      << e.what() << "  Retrying in " << backoff.count() << "ms";
       }
+      Sleep(backoff);
+      backoff *= 2;
     }
-    if (failures) {
-      TLOG(kRed) << "Could not store " << std::to_string(failures) << " out of "
-                 << std::to_string(public_pmids.size()) << '\n';
-      BOOST_THROW_EXCEPTION(MakeError(VaultErrors::failed_to_handle_request));
+  }
+
+  // Groups the failed Pmids by error, so that a systemic problem produces one line rather than one
+  // per Pmid.
+  void ReportFailures(size_t total) const {
+    size_t failure_count(0);
+    for (const auto& failure : failures_) {
+      failure_count += failure.second.size();
+      TLOG(kRed) << failure.second.size() << " x \"" << failure.first << "\" (e.g. Pmid "
+                 << failure.second.front() << ")\n";
     }
+    TLOG(kRed) << "Could not store " << std::to_string(failure_count) << " out of "
+               << std::to_string(total) << " after " << kMaxAttempts_ << " attempts each\n";
+    BOOST_THROW_EXCEPTION(MakeError(VaultErrors::failed_to_handle_request));
   }
 
- private:
   bool EqualKeys(const passport::PublicPmid& lhs, const passport::PublicPmid& rhs) const {
     return lhs.name() == rhs.name() && asymm::MatchingKeys(lhs.public_key(), rhs.public_key());
   }
 
+  const int kMaxInFlight_, kMaxAttempts_;
+  const std::chrono::milliseconds kInitialBackoff_;
   std::shared_ptr<nfs_client::MaidClient> client_nfs_;
+  std::mutex mutex_;
+  // Keyed by error message, values are the IDs of the Pmids which failed with that error.
+  std::map<std::string, std::vector<std::string>> failures_;
 };
 
 
 
 void StartNetwork(LocalNetworkController* local_network_controller) {
-  TLOG(kDefaultColour) << "\nCreating " << local_network_controller->vault_count
-                       << " sets of Pmid keys (this may take a while)\n";
+  TLOG(kDefaultColour) << "\nLoading " << local_network_controller->vault_count
+                       << " sets of Pmid keys (creating them may take a while on the first run)\n";
   ClientInterface::SetTestEnvironment(
       static_cast<tcp::Port>(local_network_controller->vault_manager_port),
       local_network_controller->test_env_root_dir, local_network_controller->path_to_vault,
       local_network_controller->vault_count + 2);
 
   auto space_info(fs::space(local_network_controller->test_env_root_dir));
-  DiskUsage max_usage{(9 * space_info.available) / (10 * local_network_controller->vault_count)};
+  DiskUsage max_usage{local_network_controller->max_disk_usage};
+  if (max_usage == 0U) {
+    max_usage =
+        DiskUsage{(9 * space_info.available) / (10 * local_network_controller->vault_count)};
+  }
   std::promise<void> zero_state_nodes_started, finished_with_zero_state_nodes;
   std::thread zero_state_launcher;
   try {
@@ -282,11 +408,13 @@ void StartNetwork(LocalNetworkController* local_network_controller) {
   StartRemainingVaults(local_network_controller, max_usage);
   TLOG(kDefaultColour) << "Started Network of " << local_network_controller->vault_count
                        << " Vaults - waiting for network to stabilise\n";
-  Sleep(std::chrono::seconds(local_network_controller->vault_count * 10));
+  WaitForNetworkToStabilise(local_network_controller);
 
   TLOG(kDefaultColour) << "Storing PublicPmid keys (this may take a while)\n";
   {
-    PublicPmidStorer public_pmid_storer;
+    PublicPmidStorer public_pmid_storer(local_network_controller->pmid_store_parallelism,
+                                        local_network_controller->pmid_store_attempts,
+                                        local_network_controller->pmid_store_backoff);
     public_pmid_storer.Store();
   }
 
@@ -298,6 +426,52 @@ void StartNetwork(LocalNetworkController* local_network_controller) {
       << "To keep the network alive or stay connected to VaultManager, do not exit this tool.\n";
 }
 
+void StartNetwork(LocalNetworkController* local_network_controller, const NetworkSpec& spec) {
+  if (!spec.restore_from.empty()) {
+    local_network_controller->join_timeout = spec.join_timeout;
+    local_network_controller->stabilise_timeout = spec.stabilise_timeout;
+    local_network_controller->entered_commands.push_back("### Network snapshot.\n" +
+                                                         spec.restore_from.string());
+    RestoreNetwork(local_network_controller, spec.restore_from, spec.test_env_root_dir);
+    if (!spec.save_to.empty())
+      SnapshotNetwork(local_network_controller, spec.save_to);
+    local_network_controller->current_command =
+        maidsafe::make_unique<ChooseTest>(local_network_controller);
+    return;
+  }
+
+  PrepareTestRootDir(spec);
+  local_network_controller->new_network = true;
+  local_network_controller->test_env_root_dir = spec.test_env_root_dir;
+  local_network_controller->path_to_vault = spec.path_to_vault;
+  local_network_controller->vault_manager_port = spec.vault_manager_port;
+  local_network_controller->vault_count = spec.vault_count;
+  local_network_controller->start_parallelism = spec.start_parallelism;
+  local_network_controller->max_disk_usage = spec.max_disk_usage;
+  local_network_controller->min_network_health = spec.min_network_health;
+  local_network_controller->join_timeout = spec.join_timeout;
+  local_network_controller->stabilise_timeout = spec.stabilise_timeout;
+  local_network_controller->pmid_store_parallelism = spec.pmid_store_parallelism;
+  local_network_controller->pmid_store_attempts = spec.pmid_store_attempts;
+  local_network_controller->pmid_store_backoff = spec.pmid_store_backoff;
+#ifdef USE_VLOGGING
+  local_network_controller->vlog_session_id =
+      maidsafe::make_unique<std::string>(spec.vlog_session_id);
+  local_network_controller->send_hostname_to_visualiser_server = maidsafe::make_unique<bool>(
+      !spec.vlog_session_id.empty() && spec.send_hostname_to_visualiser_server);
+#endif
+  local_network_controller->entered_commands.push_back(
+      "### Network spec.\n" + std::to_string(spec.vault_count) + " Vaults in " +
+      spec.test_env_root_dir.string() + ", VaultManager port " +
+      std::to_string(spec.vault_manager_port));
+
+  StartNetwork(local_network_controller);
+  if (!spec.save_to.empty())
+    SnapshotNetwork(local_network_controller, spec.save_to);
+  local_network_controller->current_command =
+      maidsafe::make_unique<ChooseTest>(local_network_controller);
+}
+
 }  // namespace tools
 
 }  // namespace vault_manager
@@ -23,6 +23,7 @@
 
 #include "maidsafe/common/types.h"
 
+#include "maidsafe/vault_manager/tools/network_spec.h"
 #include "maidsafe/vault_manager/tools/commands/commands.h"
 
 namespace maidsafe {
@@ -35,6 +36,15 @@ struct LocalNetworkController;
 
 void StartNetwork(LocalNetworkController* local_network_controller);
 
+// Starts the network described by 'spec' and leaves 'local_network_controller' awaiting the usual
+// test options (e.g. to quit).
+void StartNetwork(LocalNetworkController* local_network_controller, const NetworkSpec& spec);
+
+// Waits for all vaults to join, then for their routing tables to fill.  The latter is skipped if no
+// vault has reported its routing table health by the time all have joined, and only produces a
+// warning if it times out, since vaults aren't required to report their health.
+void WaitForNetworkToStabilise(LocalNetworkController* local_network_controller);
+
 }  // namespace tools
 
 }  // namespace vault_manager
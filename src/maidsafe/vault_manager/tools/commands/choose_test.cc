@@ -22,6 +22,7 @@
 #include "maidsafe/common/make_unique.h"
 
 #include "maidsafe/vault_manager/tools/local_network_controller.h"
+#include "maidsafe/vault_manager/tools/actions/snapshot_network.h"
 
 namespace maidsafe {
 
@@ -32,13 +33,14 @@ namespace tools {
 ChooseTest::ChooseTest(LocalNetworkController* local_network_controller)
     : Command(local_network_controller, "Test options.",
               "\nUnimplemented as yet. "
-              "(type 100 for quit or 101 for tear down vaults with interval)\n",
+              "(type 100 for quit, 101 for tear down vaults with interval or 102 to snapshot "
+              "the network)\n",
               "Main Test Choices"),
       choice_(0) {}
 
 void ChooseTest::GetChoice() {
   TLOG(kYellow) << kInstructions_;
-  while (!DoGetChoice(choice_, static_cast<int*>(nullptr), 100, 101)) {
+  while (!DoGetChoice(choice_, static_cast<int*>(nullptr), 100, 102)) {
     TLOG(kDefaultColour) << '\n' << kInstructions_;
   }
 }
@@ -51,6 +53,15 @@ void ChooseTest::HandleChoice() {
     BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::timed_out));
   if (choice_ == 100)
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::success));
+  if (choice_ == 102) {
+    const boost::filesystem::path kSnapshotDir(
+        local_network_controller_->test_env_root_dir.string() + "_snapshot");
+    try {
+      SnapshotNetwork(local_network_controller_, kSnapshotDir);
+    } catch (const std::exception& e) {
+      TLOG(kRed) << "Failed to snapshot network to " << kSnapshotDir << ": " << e.what() << '\n';
+    }
+  }
 }
 
 }  // namespace tools
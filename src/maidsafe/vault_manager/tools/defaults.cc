@@ -0,0 +1,79 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/tools/defaults.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace tools {
+
+namespace {
+
+// Can be overridden via the environment, e.g. set to 1 to start vaults one at a time.
+int DefaultStartParallelism() {
+  const char* const kStartParallelism{std::getenv("MAIDSAFE_LOCAL_NETWORK_START_PARALLELISM")};
+  if (kStartParallelism) {
+    try {
+      return std::max(1, std::stoi(kStartParallelism));
+    } catch (const std::exception&) {
+      TLOG(kRed) << "Ignoring invalid MAIDSAFE_LOCAL_NETWORK_START_PARALLELISM value \""
+                 << kStartParallelism << "\"\n";
+    }
+  }
+  return std::max(4, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+}  // unnamed namespace
+
+Default::Default()
+    : kTestEnvRootDir(boost::filesystem::temp_directory_path() / "MaidSafe_TestNetwork"),
+      kPathToVault(process::GetOtherExecutablePath(boost::filesystem::path{"vault"})),
+      kPathToBootstrap(boost::filesystem::temp_directory_path() / "bootstrap.dat"),
+      kVaultManagerPort(44444),
+      kVaultCountNewNetwork(16),
+      kVaultCount(1),
+      kStartParallelism(DefaultStartParallelism()),
+      kPmidStoreParallelism(16),
+      kPmidStoreAttempts(3),
+      kPmidStoreBackoff(std::chrono::seconds(1)),
+      kCreateTestRootDir(true),
+      kClearTestRootDir(true),
+      kSendHostnameToVisualiserServer(false) {}
+
+const Default& GetDefault() {
+  static Default the_defaults;
+  return the_defaults;
+}
+
+}  // namespace tools
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
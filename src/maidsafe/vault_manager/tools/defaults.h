@@ -0,0 +1,58 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TOOLS_DEFAULTS_H_
+#define MAIDSAFE_VAULT_MANAGER_TOOLS_DEFAULTS_H_
+
+#include <chrono>
+
+#include "boost/filesystem/path.hpp"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace tools {
+
+// Defaults offered by the interactive prompts, and used for entries missing from a network spec.
+struct Default {
+  Default();
+  const boost::filesystem::path kTestEnvRootDir;
+  const boost::filesystem::path kPathToVault;
+  const boost::filesystem::path kPathToBootstrap;
+  const int kVaultManagerPort;
+  const int kVaultCountNewNetwork;
+  const int kVaultCount;
+  const int kStartParallelism;
+  const int kPmidStoreParallelism;
+  const int kPmidStoreAttempts;
+  const std::chrono::milliseconds kPmidStoreBackoff;
+  const bool kCreateTestRootDir;
+  const bool kClearTestRootDir;
+  const bool kSendHostnameToVisualiserServer;
+};
+
+const Default& GetDefault();
+
+}  // namespace tools
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TOOLS_DEFAULTS_H_
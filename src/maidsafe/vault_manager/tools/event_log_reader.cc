@@ -0,0 +1,193 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+// Summarises a VaultManager event log (see event_log.h).  Usage:
+//
+//   event_log_reader <path to vault_manager_events.dat> [--dump]
+//
+// Prints histograms of the time taken by vaults to start (i.e. connect to the VaultManager) and to
+// join the network, then per vault: start and restart counts, restart rate, unexpected exits and
+// MTBF (mean running time between unexpected exits).  '--dump' also prints every record.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/vault_manager/event_log.h"
+
+namespace {
+
+using maidsafe::vault_manager::EventRecord;
+using maidsafe::vault_manager::EventType;
+
+typedef std::chrono::duration<double> Seconds;
+
+struct VaultSummary {
+  VaultSummary()
+      : first_event(0), last_event(0), start_count(0), restart_count(0), unexpected_exits(0),
+        time_running(0) {}
+  std::chrono::microseconds first_event, last_event;
+  int start_count, restart_count, unexpected_exits;
+  std::chrono::microseconds time_running;
+  std::vector<std::chrono::microseconds> start_latencies, join_latencies;
+};
+
+// Buckets are powers of two milliseconds: [0, 1), [1, 2), [2, 4), ...
+void PrintHistogram(const std::string& title, std::vector<std::chrono::microseconds> latencies) {
+  std::cout << title << " (" << latencies.size() << " samples)\n";
+  if (latencies.empty())
+    return;
+  std::sort(std::begin(latencies), std::end(latencies));
+  std::map<int, int> buckets;
+  for (const auto& latency : latencies) {
+    int bucket(0);
+    for (auto ms(latency.count() / 1000); ms > 0; ms >>= 1)
+      ++bucket;
+    ++buckets[bucket];
+  }
+  const int kMaxCount(std::max_element(std::begin(buckets), std::end(buckets),
+                                        [](const std::pair<const int, int>& lhs,
+                                           const std::pair<const int, int>& rhs) {
+                        return lhs.second < rhs.second;
+                      })->second);
+  for (const auto& bucket : buckets) {
+    const std::int64_t kLower(bucket.first == 0 ? 0 : (1LL << (bucket.first - 1)));
+    const std::int64_t kUpper(1LL << bucket.first);
+    std::cout << "  " << std::setw(8) << kLower << " - " << std::setw(8) << kUpper << " ms "
+              << std::setw(6) << bucket.second << ' '
+              << std::string((40 * bucket.second + kMaxCount - 1) / kMaxCount, '#') << '\n';
+  }
+  auto percentile([&](double fraction) {
+    return latencies[static_cast<std::size_t>(fraction * (latencies.size() - 1))].count() / 1000;
+  });
+  std::cout << "  p50 " << percentile(0.5) << " ms, p90 " << percentile(0.9) << " ms, p99 "
+            << percentile(0.99) << " ms, max " << latencies.back().count() / 1000 << " ms\n\n";
+}
+
+std::map<std::string, VaultSummary> Summarise(const std::vector<EventRecord>& records) {
+  std::map<std::string, VaultSummary> summaries;
+  for (const auto& record : records) {
+    VaultSummary& summary(summaries[record.label]);
+    if (summary.first_event.count() == 0)
+      summary.first_event = record.timestamp;
+    summary.last_event = std::max(summary.last_event, record.timestamp);
+    switch (record.type) {
+      case EventType::kStarting:
+        ++summary.start_count;
+        break;
+      case EventType::kRunning:
+        if (record.latency.count() != 0)
+          summary.start_latencies.push_back(record.latency);
+        break;
+      case EventType::kJoinedNetwork:
+        summary.join_latencies.push_back(record.latency);
+        break;
+      case EventType::kRestarting:
+        ++summary.restart_count;
+        break;
+      case EventType::kUnexpectedExit:
+        ++summary.unexpected_exits;
+        summary.time_running += record.latency;
+        break;
+      case EventType::kExited:
+        summary.time_running += record.latency;
+        break;
+      default:
+        break;
+    }
+  }
+  return summaries;
+}
+
+void PrintSummaries(const std::map<std::string, VaultSummary>& summaries) {
+  std::vector<std::chrono::microseconds> start_latencies, join_latencies;
+  for (const auto& summary : summaries) {
+    start_latencies.insert(std::end(start_latencies), std::begin(summary.second.start_latencies),
+                           std::end(summary.second.start_latencies));
+    join_latencies.insert(std::end(join_latencies), std::begin(summary.second.join_latencies),
+                          std::end(summary.second.join_latencies));
+  }
+  PrintHistogram("Time from process start to vault running", start_latencies);
+  PrintHistogram("Time from process start to joining network", join_latencies);
+
+  std::cout << std::left << std::setw(34) << "vault" << std::right << std::setw(8) << "starts"
+            << std::setw(10) << "restarts" << std::setw(12) << "restarts/h" << std::setw(8)
+            << "crashes" << std::setw(14) << "MTBF (s)" << '\n';
+  std::cout << std::fixed << std::setprecision(2);
+  for (const auto& summary : summaries) {
+    const VaultSummary& vault(summary.second);
+    const double kHours(
+        std::chrono::duration_cast<Seconds>(vault.last_event - vault.first_event).count() / 3600);
+    std::cout << std::left << std::setw(34) << summary.first << std::right << std::setw(8)
+              << vault.start_count << std::setw(10) << vault.restart_count << std::setw(12);
+    if (kHours > 0)
+      std::cout << vault.restart_count / kHours;
+    else
+      std::cout << '-';
+    std::cout << std::setw(8) << vault.unexpected_exits << std::setw(14);
+    if (vault.unexpected_exits > 0) {
+      std::cout << std::chrono::duration_cast<Seconds>(vault.time_running).count() /
+                       vault.unexpected_exits;
+    } else {
+      std::cout << '-';
+    }
+    std::cout << '\n';
+  }
+}
+
+}  // unnamed namespace
+
+int main(int argc, char* argv[]) {
+  try {
+    auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
+    const bool kDump(unuseds.size() == 3U && std::string{&unuseds[2][0]} == "--dump");
+    if (unuseds.size() != 2U && !kDump) {
+      std::cerr << "Usage: event_log_reader <event log path> [--dump]\n";
+      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+    }
+    const std::vector<EventRecord> kRecords(maidsafe::vault_manager::ReadEventLog(
+        boost::filesystem::path{std::string{&unuseds[1][0]}}));
+    if (kDump) {
+      for (const auto& record : kRecords) {
+        std::cout << record.timestamp.count() << ' ' << record.label << ' ' << record.process_id
+                  << ' ' << record.type << ' ' << record.exit_code << ' '
+                  << record.latency.count() << '\n';
+      }
+      std::cout << '\n';
+    }
+    std::cout << kRecords.size() << " events\n\n";
+    PrintSummaries(Summarise(kRecords));
+    return 0;
+  } catch (const maidsafe::maidsafe_error& error) {
+    std::cerr << boost::diagnostic_information(error) << '\n';
+    return maidsafe::ErrorToInt(error);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << '\n';
+    return maidsafe::ErrorToInt(maidsafe::MakeError(maidsafe::CommonErrors::unknown));
+  }
+}
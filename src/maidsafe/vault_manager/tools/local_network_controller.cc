@@ -19,15 +19,17 @@
 #include "maidsafe/vault_manager/tools/local_network_controller.h"
 
 #include <fstream>
+#include <string>
 
 #include "boost/filesystem/operations.hpp"
 
 #include "maidsafe/common/error.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
-#include "maidsafe/common/process.h"
 #include "maidsafe/routing/tests/zero_state_helpers.h"
 
+#include "maidsafe/vault_manager/config.h"
+
 #include "maidsafe/vault_manager/tools/commands/commands.h"
 #include "maidsafe/vault_manager/tools/commands/begin.h"
 
@@ -37,33 +39,26 @@ namespace vault_manager {
 
 namespace tools {
 
-Default::Default()
-    : kTestEnvRootDir(boost::filesystem::temp_directory_path() / "MaidSafe_TestNetwork"),
-      kPathToVault(process::GetOtherExecutablePath(boost::filesystem::path{"vault"})),
-      kPathToBootstrap(boost::filesystem::temp_directory_path() / "bootstrap.dat"),
-      kVaultManagerPort(44444),
-      kVaultCountNewNetwork(16),
-      kVaultCount(1),
-      kCreateTestRootDir(true),
-      kClearTestRootDir(true),
-      kSendHostnameToVisualiserServer(false) {}
-
-const Default& GetDefault() {
-  static Default the_defaults;
-  return the_defaults;
-}
-
 LocalNetworkController::LocalNetworkController(const boost::filesystem::path& script_path)
     : script_commands(),
       entered_commands(1, {"### Commands begin."}),
       current_command(),
       client_interface(),
+      maid_and_signer(),
       vault_manager(),
       test_env_root_dir(),
       path_to_vault(),
       path_to_bootstrap_file(),
       vault_manager_port(0),
       vault_count(0),
+      start_parallelism(GetDefault().kStartParallelism),
+      max_disk_usage(0),
+      min_network_health(-1),
+      join_timeout(kVaultJoinTimeout),
+      stabilise_timeout(0),
+      pmid_store_parallelism(GetDefault().kPmidStoreParallelism),
+      pmid_store_attempts(GetDefault().kPmidStoreAttempts),
+      pmid_store_backoff(GetDefault().kPmidStoreBackoff),
       new_network(false),
       vlog_session_id(),
       send_hostname_to_visualiser_server() {
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_TOOLS_LOCAL_NETWORK_CONTROLLER_H_
 #define MAIDSAFE_VAULT_MANAGER_TOOLS_LOCAL_NETWORK_CONTROLLER_H_
 
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <string>
@@ -26,10 +27,12 @@
 
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/types.h"
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/vault_manager/client_interface.h"
 #include "maidsafe/vault_manager/vault_manager.h"
+#include "maidsafe/vault_manager/tools/defaults.h"
 
 namespace maidsafe {
 
@@ -39,21 +42,6 @@ namespace tools {
 
 class Command;
 
-struct Default {
-  Default();
-  const boost::filesystem::path kTestEnvRootDir;
-  const boost::filesystem::path kPathToVault;
-  const boost::filesystem::path kPathToBootstrap;
-  const int kVaultManagerPort;
-  const int kVaultCountNewNetwork;
-  const int kVaultCount;
-  const bool kCreateTestRootDir;
-  const bool kClearTestRootDir;
-  const bool kSendHostnameToVisualiserServer;
-};
-
-const Default& GetDefault();
-
 struct LocalNetworkController {
   explicit LocalNetworkController(const boost::filesystem::path& script_path);
   ~LocalNetworkController();
@@ -61,9 +49,23 @@ struct LocalNetworkController {
   std::vector<std::string> entered_commands;
   std::unique_ptr<Command> current_command;
   std::unique_ptr<ClientInterface> client_interface;
+  // The client_interface's keys; kept so that a restarted client is still the vaults' owner.
+  std::unique_ptr<passport::MaidAndSigner> maid_and_signer;
   std::unique_ptr<VaultManager> vault_manager;
   boost::filesystem::path test_env_root_dir, path_to_vault, path_to_bootstrap_file;
   int vault_manager_port, vault_count;
+  // Maximum number of vaults which may be joining a new network at the same time.
+  int start_parallelism;
+  // Readiness criteria and quotas for a new network.  Zero (or -1 for 'min_network_health') means
+  // the value is derived from the number of vaults and the available disk space.
+  DiskUsage max_disk_usage;
+  int min_network_health;
+  std::chrono::seconds join_timeout, stabilise_timeout;
+  // Limits for storing the PublicPmids of a new network: the maximum number of Put-then-Get
+  // sequences in progress at once, the attempts allowed for each and the delay before the first
+  // retry (doubled after each further failure).
+  int pmid_store_parallelism, pmid_store_attempts;
+  std::chrono::milliseconds pmid_store_backoff;
   bool new_network;
   std::unique_ptr<std::string> vlog_session_id;
   std::unique_ptr<bool> send_hostname_to_visualiser_server;
@@ -16,6 +16,8 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <string>
+
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/error.h"
@@ -23,18 +25,27 @@
 
 #include "maidsafe/vault_manager/tools/commands/commands.h"
 #include "maidsafe/vault_manager/tools/local_network_controller.h"
+#include "maidsafe/vault_manager/tools/network_spec.h"
+#include "maidsafe/vault_manager/tools/actions/start_network.h"
 
 int main(int argc, char* argv[]) {
   try {
-    boost::filesystem::path script_path;
+    boost::filesystem::path script_path, spec_path;
     // TODO(Fraser#5#): 2014-05-19 - Use program options to input script_path and help
     auto unuseds(maidsafe::log::Logging::Instance().Initialise(argc, argv));
-    if (unuseds.size() == 2U)
+    if (unuseds.size() == 3U && std::string{&unuseds[1][0]} == "--network_spec")
+      spec_path = boost::filesystem::path{std::string{&unuseds[2][0]}};
+    else if (unuseds.size() == 2U)
       script_path = boost::filesystem::path{std::string{&unuseds[1][0]}};
     else if (unuseds.size() != 1U)
       BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
 
     maidsafe::vault_manager::tools::LocalNetworkController local_network_controller{script_path};
+    // A network spec replaces the interactive commands up to the point the network has started.
+    if (!spec_path.empty()) {
+      maidsafe::vault_manager::tools::StartNetwork(
+          &local_network_controller, maidsafe::vault_manager::tools::ReadNetworkSpec(spec_path));
+    }
     for (;;) {
       local_network_controller.current_command->PrintTitle();
       local_network_controller.current_command->GetChoice();
@@ -0,0 +1,189 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/tools/network_spec.h"
+
+#include <cstdint>
+#include <set>
+
+#include "boost/filesystem/operations.hpp"
+#include "boost/property_tree/ini_parser.hpp"
+#include "boost/property_tree/ptree.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/tools/defaults.h"
+
+namespace fs = boost::filesystem;
+namespace pt = boost::property_tree;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace tools {
+
+namespace {
+
+void ThrowInvalidSpec(const std::string& reason) {
+  TLOG(kRed) << "Invalid network spec: " << reason << '\n';
+  BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+}
+
+void CheckKeys(const pt::ptree& tree) {
+  const std::set<std::string> kKnownKeys{
+      "network.test_env_root_dir", "network.clear_test_env_root_dir", "network.path_to_vault",
+      "network.vault_manager_port", "network.vault_count", "network.max_disk_usage",
+      "network.start_parallelism", "readiness.min_network_health", "readiness.join_timeout",
+      "readiness.stabilise_timeout", "public_pmids.store_parallelism",
+      "public_pmids.store_attempts", "public_pmids.store_backoff", "vlog.session_id",
+      "vlog.send_hostname_to_visualiser_server", "snapshot.restore_from", "snapshot.save_to"};
+  for (const auto& section : tree) {
+    if (section.second.empty())
+      ThrowInvalidSpec("\"" + section.first + "\" is not in a section.");
+    for (const auto& entry : section.second) {
+      if (kKnownKeys.count(section.first + "." + entry.first) == 0U)
+        ThrowInvalidSpec("unknown entry \"" + entry.first + "\" in [" + section.first + "].");
+    }
+  }
+}
+
+template <typename T>
+T Get(const pt::ptree& tree, const std::string& key, const T& default_value) {
+  try {
+    return tree.get<T>(key, default_value);
+  } catch (const pt::ptree_bad_data&) {
+    ThrowInvalidSpec("bad value for " + key + '.');
+  }
+  return default_value;
+}
+
+// An empty value means the default should be used.
+fs::path GetPath(const pt::ptree& tree, const std::string& key, const fs::path& default_value) {
+  std::string value(Get<std::string>(tree, key, std::string()));
+  return value.empty() ? default_value : fs::path(value);
+}
+
+}  // unnamed namespace
+
+NetworkSpec::NetworkSpec()
+    : test_env_root_dir(GetDefault().kTestEnvRootDir),
+      path_to_vault(GetDefault().kPathToVault),
+      clear_test_env_root_dir(false),
+      vault_manager_port(GetDefault().kVaultManagerPort),
+      vault_count(GetDefault().kVaultCountNewNetwork),
+      start_parallelism(GetDefault().kStartParallelism),
+      max_disk_usage(0),
+      min_network_health(-1),
+      join_timeout(kVaultJoinTimeout),
+      stabilise_timeout(0),
+      pmid_store_parallelism(GetDefault().kPmidStoreParallelism),
+      pmid_store_attempts(GetDefault().kPmidStoreAttempts),
+      pmid_store_backoff(GetDefault().kPmidStoreBackoff),
+      vlog_session_id(),
+      send_hostname_to_visualiser_server(GetDefault().kSendHostnameToVisualiserServer),
+      restore_from(),
+      save_to() {}
+
+NetworkSpec ReadNetworkSpec(const fs::path& spec_path) {
+  if (!fs::exists(spec_path) || !fs::is_regular_file(spec_path))
+    ThrowInvalidSpec(spec_path.string() + " doesn't exist or is not a regular file.");
+  pt::ptree tree;
+  try {
+    pt::read_ini(spec_path.string(), tree);
+  } catch (const pt::ini_parser_error& error) {
+    ThrowInvalidSpec(error.what());
+  }
+  CheckKeys(tree);
+
+  NetworkSpec spec;
+  spec.test_env_root_dir = GetPath(tree, "network.test_env_root_dir", spec.test_env_root_dir);
+  spec.clear_test_env_root_dir =
+      Get(tree, "network.clear_test_env_root_dir", spec.clear_test_env_root_dir);
+  spec.path_to_vault = GetPath(tree, "network.path_to_vault", spec.path_to_vault);
+  spec.vault_manager_port = Get(tree, "network.vault_manager_port", spec.vault_manager_port);
+  spec.vault_count = Get(tree, "network.vault_count", spec.vault_count);
+  spec.max_disk_usage = DiskUsage{Get<uint64_t>(tree, "network.max_disk_usage", 0)};
+  spec.start_parallelism = Get(tree, "network.start_parallelism", spec.start_parallelism);
+  spec.min_network_health = Get(tree, "readiness.min_network_health", spec.min_network_health);
+  spec.join_timeout = std::chrono::seconds{
+      Get<int>(tree, "readiness.join_timeout", static_cast<int>(spec.join_timeout.count()))};
+  spec.stabilise_timeout = std::chrono::seconds{Get<int>(tree, "readiness.stabilise_timeout", 0)};
+  spec.pmid_store_parallelism =
+      Get(tree, "public_pmids.store_parallelism", spec.pmid_store_parallelism);
+  spec.pmid_store_attempts = Get(tree, "public_pmids.store_attempts", spec.pmid_store_attempts);
+  spec.pmid_store_backoff = std::chrono::milliseconds{Get<int>(
+      tree, "public_pmids.store_backoff", static_cast<int>(spec.pmid_store_backoff.count()))};
+  spec.vlog_session_id = Get<std::string>(tree, "vlog.session_id", std::string());
+  spec.send_hostname_to_visualiser_server = Get(tree, "vlog.send_hostname_to_visualiser_server",
+                                                spec.send_hostname_to_visualiser_server);
+  spec.restore_from = GetPath(tree, "snapshot.restore_from", fs::path());
+  spec.save_to = GetPath(tree, "snapshot.save_to", fs::path());
+
+  // Apply the same limits as the interactive prompts.
+  if (!fs::exists(spec.path_to_vault))
+    ThrowInvalidSpec(spec.path_to_vault.string() + " doesn't exist.");
+  if (spec.vault_manager_port < 1025 || spec.vault_manager_port > 65535)
+    ThrowInvalidSpec("vault_manager_port must be in the range [1025, 65535].");
+  if (spec.vault_count < GetDefault().kVaultCountNewNetwork) {
+    ThrowInvalidSpec("vault_count must be at least " +
+                     std::to_string(GetDefault().kVaultCountNewNetwork) + '.');
+  }
+  if (spec.start_parallelism < 1)
+    ThrowInvalidSpec("start_parallelism must be at least 1.");
+  if (spec.min_network_health > 100)
+    ThrowInvalidSpec("min_network_health must be at most 100.");
+  if (spec.join_timeout.count() <= 0 || spec.stabilise_timeout.count() < 0)
+    ThrowInvalidSpec("timeouts must not be negative, and join_timeout must be non-zero.");
+  if (spec.pmid_store_parallelism < 1 || spec.pmid_store_attempts < 1)
+    ThrowInvalidSpec("store_parallelism and store_attempts must be at least 1.");
+  if (spec.pmid_store_backoff.count() < 0)
+    ThrowInvalidSpec("store_backoff must not be negative.");
+  if (!spec.restore_from.empty() && !fs::is_directory(spec.restore_from))
+    ThrowInvalidSpec(spec.restore_from.string() + " is not a directory.");
+  return spec;
+}
+
+void PrepareTestRootDir(const NetworkSpec& spec) {
+  if (!fs::exists(spec.test_env_root_dir)) {
+    fs::create_directories(spec.test_env_root_dir);
+  } else if (!fs::is_directory(spec.test_env_root_dir)) {
+    ThrowInvalidSpec(spec.test_env_root_dir.string() + " is not a directory.");
+  } else if (!fs::is_empty(spec.test_env_root_dir)) {
+    if (!spec.clear_test_env_root_dir) {
+      ThrowInvalidSpec(spec.test_env_root_dir.string() +
+                       " is not empty and clear_test_env_root_dir is not set.");
+    }
+    if (!test::IsTestEnvironmentRootDir(spec.test_env_root_dir)) {
+      ThrowInvalidSpec(spec.test_env_root_dir.string() +
+                       " is not the root dir of an earlier test network, so won't be cleared.");
+    }
+    TLOG(kDefaultColour) << "Removing earlier test network in " << spec.test_env_root_dir << '\n';
+    fs::remove_all(spec.test_env_root_dir);
+    fs::create_directories(spec.test_env_root_dir);
+  }
+}
+
+}  // namespace tools
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -0,0 +1,102 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TOOLS_NETWORK_SPEC_H_
+#define MAIDSAFE_VAULT_MANAGER_TOOLS_NETWORK_SPEC_H_
+
+#include <chrono>
+#include <string>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace tools {
+
+// Describes a new local network so that it can be started without any interactive prompts.  The
+// spec file is in INI format (';' starts a comment); every entry is optional:
+//
+//   [network]
+//   test_env_root_dir = /tmp/MaidSafe_TestNetwork  ; created if missing
+//   clear_test_env_root_dir = false                 ; see PrepareTestRootDir
+//   path_to_vault = /path/to/vault
+//   vault_manager_port = 44444
+//   vault_count = 16
+//   max_disk_usage = 0                              ; bytes per vault, 0 for 90% of free space
+//   start_parallelism = 4                           ; max vaults joining at once
+//
+//   [readiness]
+//   min_network_health = -1                         ; percent, -1 to derive from vault_count
+//   join_timeout = 300                              ; seconds
+//   stabilise_timeout = 0                           ; seconds, 0 for 10 per vault
+//
+//   [public_pmids]
+//   store_parallelism = 16                          ; max Put-then-Get sequences at once
+//   store_attempts = 3                              ; per PublicPmid
+//   store_backoff = 1000                            ; ms before first retry, doubled after each
+//
+//   [vlog]                                          ; only with USE_VLOGGING
+//   session_id =
+//   send_hostname_to_visualiser_server = false
+//
+//   [snapshot]
+//   restore_from =                                  ; restore this snapshot instead of starting
+//   save_to =                                       ; snapshot the started network to here
+//
+// With 'restore_from', the snapshot is restored to 'test_env_root_dir', which must be empty, not
+// exist, or hold an earlier test network (which is replaced regardless of
+// 'clear_test_env_root_dir').  The other [network] and [readiness] entries, except the timeouts,
+// are ignored and those recorded in the snapshot are used instead.
+// Unspecified entries take the same defaults as the interactive prompts.  Unknown entries are
+// rejected so that typos don't silently change the network.
+struct NetworkSpec {
+  NetworkSpec();
+
+  boost::filesystem::path test_env_root_dir, path_to_vault;
+  bool clear_test_env_root_dir;
+  int vault_manager_port, vault_count, start_parallelism;
+  DiskUsage max_disk_usage;
+  int min_network_health;
+  std::chrono::seconds join_timeout, stabilise_timeout;
+  int pmid_store_parallelism, pmid_store_attempts;
+  std::chrono::milliseconds pmid_store_backoff;
+  std::string vlog_session_id;
+  bool send_hostname_to_visualiser_server;
+  boost::filesystem::path restore_from, save_to;
+};
+
+// Throws CommonErrors::invalid_argument if the file is missing or invalid.
+NetworkSpec ReadNetworkSpec(const boost::filesystem::path& spec_path);
+
+// Creates spec.test_env_root_dir if it doesn't exist.  A non-empty dir is only cleared if
+// spec.clear_test_env_root_dir is set and it holds an earlier test network (i.e. a VaultManager
+// config file), since the spec isn't confirmed interactively; otherwise this throws
+// CommonErrors::invalid_argument.
+void PrepareTestRootDir(const NetworkSpec& spec);
+
+}  // namespace tools
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TOOLS_NETWORK_SPEC_H_
@@ -48,32 +48,13 @@ void StartNetwork() {
     BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::no_such_element));
   }
 
-  fs::path script_path{maidsafe::ThisExecutableDir() / "network_test_helper.script"};
-  if (!fs::exists(script_path)) {
-    LOG(kError) << script_path << " doesn't exist.  Ensure 'network_test_helper' is built.";
+  fs::path spec_path{maidsafe::ThisExecutableDir() / "network_test_helper.spec"};
+  if (!fs::exists(spec_path)) {
+    LOG(kError) << spec_path << " doesn't exist.  Ensure 'network_test_helper' is built.";
     BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::no_such_element));
   }
 
-  // We need to improve the scripting to handle optional commands.  In this case, (starting a
-  // network), we have an optional command which offers to create or clear the VaultManager root
-  // directory.  However, if this folder already exists and is empty, the optional command will not
-  // be shown, and the script will fall out of sync.  Until this is handled better, as a workaround
-  // we'll create a dummy file in the default root directory so the optional command is always
-  // triggered.
-  fs::path test_env_root_dir{fs::temp_directory_path() / "MaidSafe_TestNetwork"};
-  if (!fs::exists(test_env_root_dir)) {
-    if (!fs::create_directories(test_env_root_dir))
-      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::filesystem_io_error));
-  } else if (!fs::is_directory(test_env_root_dir)) {
-    BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::filesystem_io_error));
-  }
-
-  if (fs::is_empty(test_env_root_dir)) {
-    if (!fs::create_directory(test_env_root_dir / "script_workaround"))
-      BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::filesystem_io_error));
-  }
-
-  std::vector<std::string> args{tool_path.string(), script_path.string()};
+  std::vector<std::string> args{tool_path.string(), "--network_spec", spec_path.string()};
   bp::execute(bp::initializers::run_exe(tool_path),
               bp::initializers::set_cmd_line(maidsafe::process::ConstructCommandLine(args)),
               bp::initializers::throw_on_error());
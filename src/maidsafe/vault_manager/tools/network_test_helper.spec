@@ -0,0 +1,4 @@
+; Local test network started by network_test_helper.  See network_spec.h for all options.
+[network]
+clear_test_env_root_dir = true
+vault_manager_port = 5583
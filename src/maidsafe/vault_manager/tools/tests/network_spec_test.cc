@@ -0,0 +1,228 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/tools/network_spec.h"
+
+#include <fstream>
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/tools/defaults.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace tools {
+
+namespace test {
+
+class NetworkSpecTest : public testing::Test {
+ protected:
+  NetworkSpecTest()
+      : test_path_(maidsafe::test::CreateTestPath("MaidSafe_TestNetworkSpec")),
+        kSpecPath_(*test_path_ / "network.spec"),
+        kPathToVault_(*test_path_ / "vault") {
+    std::ofstream(kPathToVault_.string()) << "vault";
+  }
+
+  // Writes a spec with the given entries, plus 'path_to_vault' (which must exist) in [network].
+  void WriteSpec(const std::string& network_entries, const std::string& other_sections = "") {
+    std::ofstream spec(kSpecPath_.string(), std::ios::trunc);
+    spec << "[network]\npath_to_vault = " << kPathToVault_.string() << '\n' << network_entries
+         << other_sections;
+  }
+
+  void ExpectInvalid() {
+    try {
+      ReadNetworkSpec(kSpecPath_);
+      ADD_FAILURE() << "Expected an exception";
+    } catch (const maidsafe_error& error) {
+      EXPECT_EQ(make_error_code(CommonErrors::invalid_argument), error.code());
+    }
+  }
+
+  maidsafe::test::TestPath test_path_;
+  const fs::path kSpecPath_, kPathToVault_;
+};
+
+TEST_F(NetworkSpecTest, BEH_ValidSpec) {
+  WriteSpec(
+      "test_env_root_dir = " + (*test_path_ / "root").string() + "\n"
+      "clear_test_env_root_dir = true\n"
+      "vault_manager_port = 5583\n"
+      "vault_count = 20\n"
+      "max_disk_usage = 1000000\n"
+      "start_parallelism = 2\n",
+      "[readiness]\n"
+      "min_network_health = 75\n"
+      "join_timeout = 60\n"
+      "stabilise_timeout = 120\n"
+      "[public_pmids]\n"
+      "store_parallelism = 4\n"
+      "store_attempts = 5\n"
+      "store_backoff = 250\n"
+      "[vlog]\n"
+      "session_id = session\n"
+      "send_hostname_to_visualiser_server = true\n"
+      "[snapshot]\n"
+      "save_to = " + (*test_path_ / "snapshot").string() + "\n");
+  NetworkSpec spec(ReadNetworkSpec(kSpecPath_));
+  EXPECT_EQ(*test_path_ / "root", spec.test_env_root_dir);
+  EXPECT_TRUE(spec.clear_test_env_root_dir);
+  EXPECT_EQ(kPathToVault_, spec.path_to_vault);
+  EXPECT_EQ(5583, spec.vault_manager_port);
+  EXPECT_EQ(20, spec.vault_count);
+  EXPECT_EQ(DiskUsage{1000000}, spec.max_disk_usage);
+  EXPECT_EQ(2, spec.start_parallelism);
+  EXPECT_EQ(75, spec.min_network_health);
+  EXPECT_EQ(std::chrono::seconds(60), spec.join_timeout);
+  EXPECT_EQ(std::chrono::seconds(120), spec.stabilise_timeout);
+  EXPECT_EQ(4, spec.pmid_store_parallelism);
+  EXPECT_EQ(5, spec.pmid_store_attempts);
+  EXPECT_EQ(std::chrono::milliseconds(250), spec.pmid_store_backoff);
+  EXPECT_EQ("session", spec.vlog_session_id);
+  EXPECT_TRUE(spec.send_hostname_to_visualiser_server);
+  EXPECT_TRUE(spec.restore_from.empty());
+  EXPECT_EQ(*test_path_ / "snapshot", spec.save_to);
+}
+
+TEST_F(NetworkSpecTest, BEH_MissingEntriesTakeDefaults) {
+  // Empty values are treated as missing.
+  WriteSpec("test_env_root_dir =\n");
+  NetworkSpec spec(ReadNetworkSpec(kSpecPath_));
+  EXPECT_EQ(GetDefault().kTestEnvRootDir, spec.test_env_root_dir);
+  EXPECT_FALSE(spec.clear_test_env_root_dir);
+  EXPECT_EQ(GetDefault().kVaultManagerPort, spec.vault_manager_port);
+  EXPECT_EQ(GetDefault().kVaultCountNewNetwork, spec.vault_count);
+  EXPECT_EQ(DiskUsage{0}, spec.max_disk_usage);
+  EXPECT_EQ(GetDefault().kStartParallelism, spec.start_parallelism);
+  EXPECT_EQ(-1, spec.min_network_health);
+  EXPECT_EQ(kVaultJoinTimeout, spec.join_timeout);
+  EXPECT_EQ(std::chrono::seconds(0), spec.stabilise_timeout);
+  EXPECT_EQ(GetDefault().kPmidStoreParallelism, spec.pmid_store_parallelism);
+  EXPECT_EQ(GetDefault().kPmidStoreAttempts, spec.pmid_store_attempts);
+  EXPECT_EQ(GetDefault().kPmidStoreBackoff, spec.pmid_store_backoff);
+  EXPECT_TRUE(spec.vlog_session_id.empty());
+  EXPECT_TRUE(spec.restore_from.empty());
+  EXPECT_TRUE(spec.save_to.empty());
+}
+
+TEST_F(NetworkSpecTest, BEH_InvalidSpec) {
+  // Missing file.
+  ExpectInvalid();
+  fs::create_directories(kSpecPath_);
+  ExpectInvalid();
+  fs::remove(kSpecPath_);
+
+  // Unknown or misplaced entries.
+  WriteSpec("vault_cuont = 20\n");
+  ExpectInvalid();
+  WriteSpec("", "[readiness]\nvault_count = 20\n");
+  ExpectInvalid();
+  WriteSpec("", "[unknown]\nvault_count = 20\n");
+  ExpectInvalid();
+  {
+    std::ofstream spec(kSpecPath_.string(), std::ios::trunc);
+    spec << "vault_count = 20\n";
+  }
+  ExpectInvalid();
+
+  // Malformed or out-of-range values.
+  WriteSpec("vault_count = many\n");
+  ExpectInvalid();
+  WriteSpec("clear_test_env_root_dir = maybe\n");
+  ExpectInvalid();
+  WriteSpec("", "[readiness]\njoin_timeout = soon\n");
+  ExpectInvalid();
+  WriteSpec("vault_manager_port = 1024\n");
+  ExpectInvalid();
+  WriteSpec("vault_manager_port = 65536\n");
+  ExpectInvalid();
+  WriteSpec("vault_count = " + std::to_string(GetDefault().kVaultCountNewNetwork - 1) + "\n");
+  ExpectInvalid();
+  WriteSpec("start_parallelism = 0\n");
+  ExpectInvalid();
+  WriteSpec("", "[readiness]\nmin_network_health = 101\n");
+  ExpectInvalid();
+  WriteSpec("", "[readiness]\njoin_timeout = 0\n");
+  ExpectInvalid();
+  WriteSpec("", "[readiness]\nstabilise_timeout = -1\n");
+  ExpectInvalid();
+  WriteSpec("", "[public_pmids]\nstore_parallelism = 0\n");
+  ExpectInvalid();
+  WriteSpec("", "[public_pmids]\nstore_attempts = 0\n");
+  ExpectInvalid();
+  WriteSpec("", "[public_pmids]\nstore_backoff = -1\n");
+  ExpectInvalid();
+  WriteSpec("", "[snapshot]\nrestore_from = " + (*test_path_ / "missing").string() + "\n");
+  ExpectInvalid();
+  {
+    std::ofstream spec(kSpecPath_.string(), std::ios::trunc);
+    spec << "[network]\npath_to_vault = " << (*test_path_ / "missing").string() << '\n';
+  }
+  ExpectInvalid();
+}
+
+TEST_F(NetworkSpecTest, BEH_PrepareTestRootDir) {
+  NetworkSpec spec;
+  spec.test_env_root_dir = *test_path_ / "root";
+
+  // A missing dir is created, and an empty one is used as is.
+  EXPECT_NO_THROW(PrepareTestRootDir(spec));
+  EXPECT_TRUE(fs::is_directory(spec.test_env_root_dir));
+  EXPECT_NO_THROW(PrepareTestRootDir(spec));
+
+  // A non-empty dir is never cleared unless requested, nor if it doesn't hold an earlier network.
+  const fs::path kOtherFile(spec.test_env_root_dir / "other");
+  std::ofstream(kOtherFile.string()) << "other";
+  EXPECT_THROW(PrepareTestRootDir(spec), maidsafe_error);
+  spec.clear_test_env_root_dir = true;
+  EXPECT_THROW(PrepareTestRootDir(spec), maidsafe_error);
+  EXPECT_TRUE(fs::exists(kOtherFile));
+
+  { ConfigFileHandler config_file_handler(spec.test_env_root_dir / kConfigFilename); }
+  spec.clear_test_env_root_dir = false;
+  EXPECT_THROW(PrepareTestRootDir(spec), maidsafe_error);
+  EXPECT_TRUE(fs::exists(kOtherFile));
+  spec.clear_test_env_root_dir = true;
+  EXPECT_NO_THROW(PrepareTestRootDir(spec));
+  EXPECT_TRUE(fs::is_directory(spec.test_env_root_dir));
+  EXPECT_TRUE(fs::is_empty(spec.test_env_root_dir));
+
+  // Nor is a file replaced.
+  fs::remove(spec.test_env_root_dir);
+  std::ofstream(spec.test_env_root_dir.string()) << "file";
+  EXPECT_THROW(PrepareTestRootDir(spec), maidsafe_error);
+  EXPECT_TRUE(fs::is_regular_file(spec.test_env_root_dir));
+}
+
+}  // namespace test
+
+}  // namespace tools
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
@@ -30,9 +30,12 @@ namespace tools {
 void StartVaultManagerAndClientInterface(LocalNetworkController* local_network_controller) {
   TLOG(kDefaultColour) << "Creating VaultManager and ClientInterface\n";
   local_network_controller->vault_manager = maidsafe::make_unique<VaultManager>();
-  passport::MaidAndSigner maid_and_signer{passport::CreateMaidAndSigner()};
+  if (!local_network_controller->maid_and_signer) {
+    local_network_controller->maid_and_signer =
+        maidsafe::make_unique<passport::MaidAndSigner>(passport::CreateMaidAndSigner());
+  }
   local_network_controller->client_interface =
-      maidsafe::make_unique<ClientInterface>(maid_and_signer.first);
+      maidsafe::make_unique<ClientInterface>(local_network_controller->maid_and_signer->first);
 }
 
 }  // namespace tools
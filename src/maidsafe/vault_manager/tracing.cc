@@ -0,0 +1,177 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+const std::size_t kSpansPerThread(8192);
+
+// The fields are atomic only so that exporting can safely read a buffer while its thread is still
+// writing to it; relaxed accesses cost nothing extra on common platforms.
+struct Span {
+  std::atomic<const char*> name;
+  std::atomic<std::int64_t> start_us, duration_us;
+};
+
+struct ThreadBuffer {
+  explicit ThreadBuffer(std::uint64_t id)
+      : thread_id(id), next_position(0), spans(new Span[kSpansPerThread]) {}
+  const std::uint64_t thread_id;
+  // Only incremented by the owning thread, after writing the span at 'next_position'.
+  std::atomic<std::size_t> next_position;
+  std::unique_ptr<Span[]> spans;
+};
+
+struct Registry {
+  std::mutex mutex;
+  // Buffers are never removed, so that spans from exited threads can still be exported.
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+ThreadBuffer& GetThreadBuffer() {
+  static thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    Registry& registry(GetRegistry());
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    buffer = std::make_shared<ThreadBuffer>(registry.buffers.size() + 1);
+    registry.buffers.push_back(buffer);
+  }
+  return *buffer;
+}
+
+std::int64_t ToMicroseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void AppendSpans(const ThreadBuffer& buffer, std::uint64_t process_id, bool& first,
+                 std::ostringstream& json) {
+  const std::size_t kEnd(buffer.next_position.load(std::memory_order_acquire));
+  std::size_t begin(kEnd > kSpansPerThread ? kEnd - kSpansPerThread : 0);
+  std::vector<std::size_t> positions;
+  std::vector<const char*> names;
+  std::vector<std::int64_t> starts, durations;
+  for (std::size_t position(begin); position < kEnd; ++position) {
+    const Span& span(buffer.spans[position % kSpansPerThread]);
+    positions.push_back(position);
+    names.push_back(span.name.load(std::memory_order_relaxed));
+    starts.push_back(span.start_us.load(std::memory_order_relaxed));
+    durations.push_back(span.duration_us.load(std::memory_order_relaxed));
+  }
+  // Discard any spans which the owning thread may have overwritten while they were being read (the
+  // slot of 'kNewEnd' may be part-way through being overwritten).
+  std::atomic_thread_fence(std::memory_order_acquire);
+  const std::size_t kNewEnd(buffer.next_position.load(std::memory_order_relaxed));
+  if (kNewEnd >= kSpansPerThread)
+    begin = std::max(begin, kNewEnd - kSpansPerThread + 1);
+
+  for (std::size_t i(0); i < positions.size(); ++i) {
+    if (positions[i] < begin || !names[i])
+      continue;
+    json << (first ? "\n" : ",\n") << R"({"name":")";
+    for (const char* c(names[i]); *c; ++c) {
+      if (*c == '"' || *c == '\\')
+        json << '\\';
+      json << *c;
+    }
+    json << R"(","ph":"X","ts":)" << starts[i] << R"(,"dur":)" << durations[i]
+         << R"(,"pid":)" << process_id << R"(,"tid":)" << buffer.thread_id << '}';
+    first = false;
+  }
+}
+
+}  // unnamed namespace
+
+namespace detail {
+
+TraceSpan::TraceSpan(const char* name) : kName_(name), kStart_(std::chrono::steady_clock::now()) {}
+
+TraceSpan::~TraceSpan() {
+  const auto kEnd(std::chrono::steady_clock::now());
+  ThreadBuffer& buffer(GetThreadBuffer());
+  const std::size_t kPosition(buffer.next_position.load(std::memory_order_relaxed));
+  Span& span(buffer.spans[kPosition % kSpansPerThread]);
+  // Pairs with the fence in AppendSpans: an exporter which sees any of the new values is then
+  // guaranteed to see that the span previously in this slot is being overwritten.
+  std::atomic_thread_fence(std::memory_order_release);
+  span.name.store(kName_, std::memory_order_relaxed);
+  span.start_us.store(ToMicroseconds(kStart_.time_since_epoch()), std::memory_order_relaxed);
+  span.duration_us.store(ToMicroseconds(kEnd - kStart_), std::memory_order_relaxed);
+  buffer.next_position.store(kPosition + 1, std::memory_order_release);
+}
+
+}  // namespace detail
+
+bool TracingEnabled() {
+#ifdef USE_VAULT_MANAGER_TRACING
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::string ExportChromeTrace() {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    Registry& registry(GetRegistry());
+    std::lock_guard<std::mutex> lock{registry.mutex};
+    buffers = registry.buffers;
+  }
+  const std::uint64_t kProcessId(process::GetProcessId());
+  std::ostringstream json;
+  json << R"({"displayTimeUnit":"ms","traceEvents":[)";
+  bool first(true);
+  for (const auto& buffer : buffers)
+    AppendSpans(*buffer, kProcessId, first, json);
+  json << "\n]}\n";
+  return json.str();
+}
+
+void WriteChromeTrace(const boost::filesystem::path& path) {
+  if (!WriteFile(path, ExportChromeTrace())) {
+    LOG(kError) << "Failed to write trace to " << path;
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  LOG(kInfo) << "Wrote trace to " << path;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
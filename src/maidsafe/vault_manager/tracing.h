@@ -0,0 +1,85 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_TRACING_H_
+#define MAIDSAFE_VAULT_MANAGER_TRACING_H_
+
+#include <chrono>
+#include <string>
+
+#include "boost/filesystem/path.hpp"
+
+// Tracing spans for profiling the VaultManager's message handling.  They are only compiled in if
+// USE_VAULT_MANAGER_TRACING is defined (CMake option VAULT_MANAGER_TRACING); otherwise
+// VAULT_MANAGER_TRACE_SPAN expands to nothing.  Usage, with 'name' a string literal:
+//
+//   void Foo() {
+//     VAULT_MANAGER_TRACE_SPAN("Foo");
+//     ...
+//   }
+//
+// Each completed span is written to a fixed-size ring buffer owned by the current thread, so
+// recording takes no locks.  The most recent spans of all threads can be exported in Chrome's trace
+// event format, for viewing in chrome://tracing or Perfetto.
+
+#ifdef USE_VAULT_MANAGER_TRACING
+#define VAULT_MANAGER_TRACE_CONCAT_IMPL(a, b) a##b
+#define VAULT_MANAGER_TRACE_CONCAT(a, b) VAULT_MANAGER_TRACE_CONCAT_IMPL(a, b)
+#define VAULT_MANAGER_TRACE_SPAN(name)                                                    \
+  ::maidsafe::vault_manager::detail::TraceSpan VAULT_MANAGER_TRACE_CONCAT(trace_span_, \
+                                                                          __LINE__)(name)
+#else
+#define VAULT_MANAGER_TRACE_SPAN(name) static_cast<void>(0)
+#endif
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace detail {
+
+class TraceSpan {
+ public:
+  // 'name' must outlive the process (e.g. a string literal).
+  explicit TraceSpan(const char* name);
+  ~TraceSpan();
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan(TraceSpan&&) = delete;
+  TraceSpan& operator=(TraceSpan) = delete;
+
+ private:
+  const char* const kName_;
+  const std::chrono::steady_clock::time_point kStart_;
+};
+
+}  // namespace detail
+
+// Whether this build records tracing spans.
+bool TracingEnabled();
+
+// Returns the spans still held in all threads' buffers as a Chrome trace JSON document.
+std::string ExportChromeTrace();
+
+// Writes ExportChromeTrace() to 'path'.  Throws CommonErrors::filesystem_io_error on failure.
+void WriteChromeTrace(const boost::filesystem::path& path);
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_TRACING_H_
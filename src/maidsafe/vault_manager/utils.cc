@@ -20,11 +20,17 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdlib>
+#include <fstream>
 #include <functional>
+#include <future>
 #include <iterator>
 #include <limits>
 #include <mutex>
+#include <string>
+#include <thread>
 
+#include "boost/exception/diagnostic_information.hpp"
 #include "boost/filesystem/operations.hpp"
 
 #include "maidsafe/common/error.h"
@@ -34,16 +40,38 @@
 #include "maidsafe/common/serialisation/serialisation.h"
 #include "maidsafe/passport/passport.h"
 
+#include "maidsafe/vault_manager/config_file_handler.h"
 #include "maidsafe/vault_manager/vault_info.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/flow_control_ack.h"
+#include "maidsafe/vault_manager/messages/heartbeat_request.h"
+#include "maidsafe/vault_manager/messages/heartbeat_response.h"
+#include "maidsafe/vault_manager/messages/list_vaults_request.h"
+#include "maidsafe/vault_manager/messages/list_vaults_response.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+#include "maidsafe/vault_manager/messages/network_health_update.h"
+#include "maidsafe/vault_manager/messages/remove_vault_progress.h"
+#include "maidsafe/vault_manager/messages/remove_vault_request.h"
+#include "maidsafe/vault_manager/messages/remove_vault_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/upgrade_vaults_request.h"
+#include "maidsafe/vault_manager/messages/upgrade_vaults_response.h"
+#include "maidsafe/vault_manager/messages/vault_challenge_response.h"
+#include "maidsafe/vault_manager/messages/vault_events_subscription.h"
+#include "maidsafe/vault_manager/messages/vault_lifecycle_event.h"
+#include "maidsafe/vault_manager/messages/vault_network_status.h"
+#include "maidsafe/vault_manager/messages/vault_reconnect_request.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/messages/vault_started_response.h"
+#include "maidsafe/vault_manager/messages/vault_stats.h"
+#include "maidsafe/vault_manager/messages/vault_stats_request.h"
+#include "maidsafe/vault_manager/messages/vault_stats_response.h"
 
 namespace fs = boost::filesystem;
 
@@ -54,13 +82,34 @@ namespace vault_manager {
 #if !defined(_MSC_VER) || _MSC_VER >= 1900
 const MessageTag Challenge::tag;
 const MessageTag ChallengeResponse::tag;
+const MessageTag FlowControlAck::tag;
+const MessageTag HeartbeatRequest::tag;
+const MessageTag HeartbeatResponse::tag;
+const MessageTag ListVaultsRequest::tag;
+const MessageTag ListVaultsResponse::tag;
 const MessageTag LogMessage::tag;
 const MessageTag MaxDiskUsageUpdate::tag;
+const MessageTag NetworkHealthUpdate::tag;
+const MessageTag RemoveVaultProgress::tag;
+const MessageTag RemoveVaultRequest::tag;
+const MessageTag RemoveVaultResponse::tag;
+const MessageTag ResumeSessionRequest::tag;
+const MessageTag SessionTicket::tag;
 const MessageTag StartVaultRequest::tag;
 const MessageTag TakeOwnershipRequest::tag;
+const MessageTag UpgradeVaultsRequest::tag;
+const MessageTag UpgradeVaultsResponse::tag;
+const MessageTag VaultChallengeResponse::tag;
+const MessageTag VaultEventsSubscription::tag;
+const MessageTag VaultLifecycleEvent::tag;
+const MessageTag VaultNetworkStatus::tag;
+const MessageTag VaultReconnectRequest::tag;
 const MessageTag VaultRunningResponse::tag;
 const MessageTag VaultStarted::tag;
 const MessageTag VaultStartedResponse::tag;
+const MessageTag VaultStats::tag;
+const MessageTag VaultStatsRequest::tag;
+const MessageTag VaultStatsResponse::tag;
 #endif
 
 namespace {
@@ -72,6 +121,111 @@ fs::path g_test_env_root_dir, g_path_to_vault;
 bool g_using_default_environment(true);
 std::vector<passport::PmidAndSigner> g_pmids_and_signers;
 std::vector<passport::PublicPmid> g_public_pmids;
+
+// Generating test keys dominates the start-up time of test networks, so they can be cached.  Since
+// the cache holds private keys, this is opt-in and the file is only accessible by its owner.
+bool UseKeyChainCache() {
+  const char* const kCacheTestKeys{std::getenv("MAIDSAFE_VAULT_MANAGER_CACHE_TEST_KEYS")};
+  return kCacheTestKeys && std::string(kCacheTestKeys) == "1";
+}
+
+fs::path KeyChainCachePath() { return GetUserAppDir() / "test_keys.dat"; }
+
+const fs::perms kOwnerOnly(fs::owner_read | fs::owner_write);
+
+std::vector<passport::PmidAndSigner> ReadKeyChainCache(size_t max_count) {
+  std::vector<passport::PmidAndSigner> pmids_and_signers;
+  boost::system::error_code ec;
+  const fs::file_status kStatus(fs::status(KeyChainCachePath(), ec));
+  if (ec || !fs::is_regular_file(kStatus))
+    return pmids_and_signers;
+  if ((kStatus.permissions() & ~kOwnerOnly) != fs::no_perms) {
+    LOG(kWarning) << "Ignoring key chain cache " << KeyChainCachePath()
+                  << " as it is accessible by other users.";
+    return pmids_and_signers;
+  }
+  try {
+    std::vector<passport::detail::AnmaidToPmid> key_chains(
+        passport::detail::ReadKeyChainList(KeyChainCachePath()));
+    for (auto& key_chain : key_chains) {
+      if (pmids_and_signers.size() == max_count)
+        break;
+      pmids_and_signers.emplace_back(std::move(key_chain.pmid), std::move(key_chain.anpmid));
+    }
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Ignoring unreadable key chain cache " << KeyChainCachePath() << ": "
+                  << boost::diagnostic_information(e);
+    pmids_and_signers.clear();
+  }
+  return pmids_and_signers;
+}
+
+// The cache is written to a temporary file and renamed, so concurrent test processes never see a
+// partially-written cache.  The temporary file's permissions are restricted before the keys are
+// written to it.  Failure is only logged since the cache is an optimisation.
+void WriteKeyChainCache(const std::vector<passport::PmidAndSigner>& pmids_and_signers) {
+  try {
+    // The file format requires a Maid for each Pmid, but only the Pmids are used.
+    const passport::MaidAndSigner kMaidAndSigner{passport::CreateMaidAndSigner()};
+    std::vector<passport::detail::AnmaidToPmid> key_chains;
+    for (const auto& pmid_and_signer : pmids_and_signers) {
+      key_chains.emplace_back(kMaidAndSigner.second, kMaidAndSigner.first,
+                              pmid_and_signer.second, pmid_and_signer.first);
+    }
+    fs::create_directories(KeyChainCachePath().parent_path());
+    fs::path temp_path{KeyChainCachePath().string() + "." + RandomAlphaNumericString(8)};
+    if (!std::ofstream(temp_path.string(), std::ios::out | std::ios::binary))
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+    fs::permissions(temp_path, kOwnerOnly);
+    if (!passport::detail::WriteKeyChainList(temp_path, key_chains))
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+    fs::rename(temp_path, KeyChainCachePath());
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to write key chain cache " << KeyChainCachePath() << ": "
+                  << boost::diagnostic_information(e);
+  }
+}
+
+std::vector<passport::PmidAndSigner> CreatePmidsAndSigners(int count) {
+  const int kThreadCount(
+      std::max(1, std::min(count, static_cast<int>(std::thread::hardware_concurrency()))));
+  std::vector<std::future<std::vector<passport::PmidAndSigner>>> futures;
+  for (int i(0); i < kThreadCount; ++i) {
+    const int kShare((count / kThreadCount) + (i < count % kThreadCount ? 1 : 0));
+    futures.emplace_back(std::async(std::launch::async, [kShare] {
+      std::vector<passport::PmidAndSigner> pmids_and_signers;
+      for (int j(0); j < kShare; ++j)
+        pmids_and_signers.emplace_back(passport::CreatePmidAndSigner());
+      return pmids_and_signers;
+    }));
+  }
+  std::vector<passport::PmidAndSigner> pmids_and_signers;
+  for (auto& future : futures) {
+    auto share(future.get());
+    std::move(std::begin(share), std::end(share), std::back_inserter(pmids_and_signers));
+  }
+  return pmids_and_signers;
+}
+
+// If the cache is enabled, loads as many keys as possible from it, then generates the remainder
+// across all cores and adds them to the cache.
+std::vector<passport::PmidAndSigner> GetTestPmidsAndSigners(int count) {
+  if (count <= 0)
+    return std::vector<passport::PmidAndSigner>{};
+  if (!UseKeyChainCache())
+    return CreatePmidsAndSigners(count);
+  std::vector<passport::PmidAndSigner> pmids_and_signers(
+      ReadKeyChainCache(static_cast<size_t>(count)));
+  const int kCachedCount(static_cast<int>(pmids_and_signers.size()));
+  if (kCachedCount == count)
+    return pmids_and_signers;
+  auto created(CreatePmidsAndSigners(count - kCachedCount));
+  std::move(std::begin(created), std::end(created), std::back_inserter(pmids_and_signers));
+  LOG(kInfo) << "Loaded " << kCachedCount << " and generated " << count - kCachedCount
+             << " test Pmids.";
+  WriteKeyChainCache(pmids_and_signers);
+  return pmids_and_signers;
+}
 #endif
 
 }  // unnamed namespace
@@ -100,6 +254,26 @@ std::unique_ptr<VaultConfig> GetValue(const VaultStartedResponse& vault_started_
   return vault_config;
 }
 
+std::vector<NonEmptyString> GetValue(const UpgradeVaultsResponse& upgrade_vaults_response) {
+  if (upgrade_vaults_response.error)
+    BOOST_THROW_EXCEPTION(*upgrade_vaults_response.error);
+  return upgrade_vaults_response.upgraded_labels;
+}
+
+HostStatistics GetValue(const VaultStatsResponse& vault_stats_response) {
+  if (vault_stats_response.error)
+    BOOST_THROW_EXCEPTION(*vault_stats_response.error);
+  return vault_stats_response.host_statistics;
+}
+
+std::string GetValue(const SessionTicket& session_ticket) { return session_ticket.ticket; }
+
+VaultList GetValue(const ListVaultsResponse& list_vaults_response) {
+  if (list_vaults_response.error)
+    BOOST_THROW_EXCEPTION(*list_vaults_response.error);
+  return list_vaults_response.vault_list;
+}
+
 }  // namespace detail
 
 NonEmptyString GenerateLabel() {
@@ -122,24 +296,88 @@ tcp::Port GetInitialListeningPort() {
 #ifdef TESTING
 namespace test {
 
+namespace {
+
+void InitialiseEnvironment(
+    tcp::Port test_vault_manager_port, const fs::path& test_env_root_dir,
+    const fs::path& path_to_vault,
+    std::function<std::vector<passport::PmidAndSigner>()> get_pmids_and_signers) {
+  if (!fs::exists(test_env_root_dir) || !fs::is_directory(test_env_root_dir)) {
+    LOG(kError) << test_env_root_dir << " doesn't exist or is not a directory.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::not_a_directory));
+  }
+  g_test_vault_manager_port = test_vault_manager_port;
+  g_test_env_root_dir = test_env_root_dir;
+  g_path_to_vault = path_to_vault;
+  g_pmids_and_signers = get_pmids_and_signers();
+  for (const auto& pmid_and_signer : g_pmids_and_signers)
+    g_public_pmids.emplace_back(passport::PublicPmid{pmid_and_signer.first});
+  g_using_default_environment = false;
+}
+
+// Returns 'path' moved from under 'old_base' to under 'new_base', or an empty path if it isn't
+// under 'old_base'.
+fs::path Rebase(const fs::path& path, const fs::path& old_base, const fs::path& new_base) {
+  auto path_itr(path.begin());
+  for (const auto& element : old_base) {
+    if (element == ".")  // i.e. a trailing separator
+      continue;
+    if (path_itr == path.end() || *path_itr != element)
+      return fs::path();
+    ++path_itr;
+  }
+  fs::path rebased(new_base);
+  for (; path_itr != path.end(); ++path_itr)
+    rebased /= *path_itr;
+  return rebased;
+}
+
+}  // unnamed namespace
+
 void SetEnvironment(tcp::Port test_vault_manager_port, const fs::path& test_env_root_dir,
                     const fs::path& path_to_vault, int pmid_list_size) {
   std::call_once(test_env_flag, [=] {
-    if (!fs::exists(test_env_root_dir) || !fs::is_directory(test_env_root_dir)) {
-      LOG(kError) << test_env_root_dir << " doesn't exist or is not a directory.";
-      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::not_a_directory));
-    }
-    g_test_vault_manager_port = test_vault_manager_port;
-    g_test_env_root_dir = test_env_root_dir;
-    g_path_to_vault = path_to_vault;
-    for (int i(0); i < pmid_list_size; ++i) {
-      g_pmids_and_signers.emplace_back(passport::CreatePmidAndSigner());
-      g_public_pmids.emplace_back(passport::PublicPmid{g_pmids_and_signers.back().first});
-    }
-    g_using_default_environment = false;
+    InitialiseEnvironment(test_vault_manager_port, test_env_root_dir, path_to_vault,
+                          [pmid_list_size] { return GetTestPmidsAndSigners(pmid_list_size); });
+  });
+}
+
+void SetEnvironment(tcp::Port test_vault_manager_port, const fs::path& test_env_root_dir,
+                    const fs::path& path_to_vault,
+                    std::vector<passport::PmidAndSigner> pmids_and_signers) {
+  std::call_once(test_env_flag, [&] {
+    InitialiseEnvironment(test_vault_manager_port, test_env_root_dir, path_to_vault,
+                          [&] { return std::move(pmids_and_signers); });
   });
 }
 
+bool IsTestEnvironmentRootDir(const fs::path& dir) {
+  boost::system::error_code ec;
+  return fs::is_directory(dir, ec) && fs::is_regular_file(dir / kConfigFilename, ec);
+}
+
+void RelocateTestEnvironment(const fs::path& old_test_env_root_dir,
+                             const fs::path& test_env_root_dir) {
+  if (!IsTestEnvironmentRootDir(test_env_root_dir)) {
+    LOG(kError) << test_env_root_dir << " doesn't hold a VaultManager config file.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_argument));
+  }
+  ConfigFileHandler config_file_handler(test_env_root_dir / kConfigFilename);
+  std::vector<VaultInfoPtr> vaults;
+  for (auto& vault : config_file_handler.ReadConfigFile()) {
+    fs::path vault_dir(Rebase(vault.vault_dir, old_test_env_root_dir, test_env_root_dir));
+    if (vault_dir.empty()) {
+      LOG(kWarning) << "Vault dir " << vault.vault_dir << " is outside " << old_test_env_root_dir
+                    << " so is left unchanged.";
+    } else {
+      vault.vault_dir = vault_dir;
+    }
+    vault.process_id = 0;
+    vaults.push_back(std::make_shared<const VaultInfo>(std::move(vault)));
+  }
+  config_file_handler.WriteConfigFile(std::move(vaults));
+}
+
 }  // namespace test
 
 tcp::Port GetTestVaultManagerPort() { return g_test_vault_manager_port; }
@@ -34,7 +34,10 @@
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/vault_manager/config.h"
+#include "maidsafe/vault_manager/tracing.h"
 #include "maidsafe/vault_manager/vault_config.h"
+#include "maidsafe/vault_manager/vault_statistics.h"
+#include "maidsafe/vault_manager/vault_summary.h"
 
 
 namespace maidsafe {
@@ -42,7 +45,11 @@ namespace maidsafe {
 namespace vault_manager {
 
 struct Challenge;
+struct ListVaultsResponse;
+struct SessionTicket;
+struct UpgradeVaultsResponse;
 struct VaultStartedResponse;
+struct VaultStatsResponse;
 
 namespace detail {
 
@@ -50,10 +57,19 @@ std::unique_ptr<asymm::PlainText> GetValue(const Challenge& challenge);
 
 std::unique_ptr<VaultConfig> GetValue(const VaultStartedResponse& vault_started_response);
 
+std::vector<NonEmptyString> GetValue(const UpgradeVaultsResponse& upgrade_vaults_response);
+
+HostStatistics GetValue(const VaultStatsResponse& vault_stats_response);
+
+std::string GetValue(const SessionTicket& session_ticket);
+
+VaultList GetValue(const ListVaultsResponse& list_vaults_response);
+
 }  // namespace detail
 
 template <typename T>
 void Send(tcp::ConnectionPtr connection, T message) {
+  VAULT_MANAGER_TRACE_SPAN("Send");
   connection->Send(Serialise(T::tag, std::move(message)));
 }
 
@@ -68,6 +84,23 @@ void SetEnvironment(tcp::Port test_vault_manager_port,
                     const boost::filesystem::path& test_env_root_dir,
                     const boost::filesystem::path& path_to_vault, int pmid_list_size = 0);
 
+// As above, but using the given Pmids rather than cached or newly-generated ones (e.g. to restore a
+// snapshot of a test network).
+void SetEnvironment(tcp::Port test_vault_manager_port,
+                    const boost::filesystem::path& test_env_root_dir,
+                    const boost::filesystem::path& path_to_vault,
+                    std::vector<passport::PmidAndSigner> pmids_and_signers);
+
+// Returns true if 'dir' is the root dir of an earlier test environment, i.e. it holds a
+// VaultManager config file.  Only such dirs (or empty ones) should be cleared for a new network.
+bool IsTestEnvironmentRootDir(const boost::filesystem::path& dir);
+
+// For a test environment copied from 'old_test_env_root_dir' to 'test_env_root_dir' (e.g. from a
+// network snapshot), rewrites the vault dirs held in its VaultManager config file to be under the
+// new root.  The recorded process IDs are cleared, since they belong to the original environment.
+void RelocateTestEnvironment(const boost::filesystem::path& old_test_env_root_dir,
+                             const boost::filesystem::path& test_env_root_dir);
+
 }  // namespace test
 
 tcp::Port GetTestVaultManagerPort();
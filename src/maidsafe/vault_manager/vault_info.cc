@@ -34,6 +34,9 @@ VaultInfo::VaultInfo()
       vlog_session_id(),
       send_hostname_to_visualiser_server(false),
 #endif
+      process_id(0),
+      joined_network(false),
+      network_health(-1),
       tcp_connection() {
 }
 
@@ -47,6 +50,9 @@ VaultInfo::VaultInfo(const VaultInfo& other)
       vlog_session_id(other.vlog_session_id),
       send_hostname_to_visualiser_server(other.send_hostname_to_visualiser_server),
 #endif
+      process_id(other.process_id),
+      joined_network(other.joined_network),
+      network_health(other.network_health),
       tcp_connection(other.tcp_connection) {
 }
 
@@ -60,6 +66,9 @@ VaultInfo::VaultInfo(VaultInfo&& other)
       vlog_session_id(std::move(other.vlog_session_id)),
       send_hostname_to_visualiser_server(std::move(other.send_hostname_to_visualiser_server)),
 #endif
+      process_id(std::move(other.process_id)),
+      joined_network(std::move(other.joined_network)),
+      network_health(std::move(other.network_health)),
       tcp_connection(std::move(other.tcp_connection)) {
 }
 
@@ -79,6 +88,9 @@ void swap(VaultInfo& lhs, VaultInfo& rhs) {
   swap(lhs.vlog_session_id, rhs.vlog_session_id);
   swap(lhs.send_hostname_to_visualiser_server, rhs.send_hostname_to_visualiser_server);
 #endif
+  swap(lhs.process_id, rhs.process_id);
+  swap(lhs.joined_network, rhs.joined_network);
+  swap(lhs.network_health, rhs.network_health);
   swap(lhs.tcp_connection, rhs.tcp_connection);
 }
 
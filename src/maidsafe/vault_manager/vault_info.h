@@ -27,6 +27,7 @@
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/identity.h"
+#include "maidsafe/common/process.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/passport.h"
 
@@ -51,11 +52,23 @@ struct VaultInfo {
   std::string vlog_session_id;
   bool send_hostname_to_visualiser_server;
 #endif
+  // The ID of the vault's process once it has connected, or 0.  Persisted so that a restarted
+  // VaultManager can adopt vaults left running by its predecessor.
+  process::ProcessId process_id;
+  // As last reported by the running vault process; not persisted.  'network_health' is -1 until the
+  // vault reports its routing table health.
+  bool joined_network;
+  int network_health;
   tcp::ConnectionPtr tcp_connection;
 };
 
 void swap(VaultInfo& lhs, VaultInfo& rhs);
 
+// An immutable snapshot of a vault's details.  ProcessManager publishes a new snapshot whenever a
+// vault's details change, so holders of an earlier one can keep reading it without locking or
+// copying.
+typedef std::shared_ptr<const VaultInfo> VaultInfoPtr;
+
 }  // namespace vault_manager
 
 }  // namespace maidsafe
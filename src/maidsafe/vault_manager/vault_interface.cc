@@ -26,9 +26,17 @@
 
 #include "maidsafe/vault_manager/rpc_helper.h"
 #include "maidsafe/vault_manager/utils.h"
+#include "maidsafe/vault_manager/messages/challenge.h"
+#include "maidsafe/vault_manager/messages/heartbeat_request.h"
+#include "maidsafe/vault_manager/messages/heartbeat_response.h"
 #include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/log_message.h"
+#include "maidsafe/vault_manager/messages/network_health_update.h"
+#include "maidsafe/vault_manager/messages/vault_challenge_response.h"
+#include "maidsafe/vault_manager/messages/vault_reconnect_request.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
 #include "maidsafe/vault_manager/messages/vault_started_response.h"
+#include "maidsafe/vault_manager/messages/vault_stats.h"
 
 namespace fs = boost::filesystem;
 
@@ -36,39 +44,145 @@ namespace maidsafe {
 
 namespace vault_manager {
 
-VaultInterface::VaultInterface(tcp::Port vault_manager_port)
+VaultInterface::VaultInterface(tcp::Port vault_manager_port, bool standby)
     : exit_code_promise_(),
       exit_code_flag_(),
+      mutex_(),
+      exiting_(false),
+      reconnecting_(false),
+      joined_network_(false),
+      network_health_(-1),
+      statistics_(),
+      heartbeat_executor_(),
       vault_manager_port_(vault_manager_port),
       on_vault_started_response_(),
       vault_config_(),
       asio_service_(1),
       strand_(asio_service_.service()),
-      tcp_connection_(tcp::Connection::MakeShared(strand_, vault_manager_port_)),
-      connection_closer_([&] { tcp_connection_->Close(); }) {
-  tcp_connection_->Start(
-      [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
-      [this] { OnConnectionClosed(); });
+      tcp_connection_(Connect()),
+      connection_closer_([&] { tcp_connection_->Close(); }),
+      reconnect_service_(1) {
   LOG(kSuccess) << "Connected to VaultManager which is listening on port " << vault_manager_port_;
   std::mutex mutex;
   auto vault_config_future(SetResponseCallback<std::unique_ptr<VaultConfig>, VaultStartedResponse>(
-      on_vault_started_response_, asio_service_.service(), mutex));
+      on_vault_started_response_, asio_service_.service(), mutex,
+      standby ? std::chrono::steady_clock::duration{kStandbyVaultTimeout} : kRpcTimeout));
   Send(tcp_connection_, VaultStarted(process::GetProcessId()));
-  vault_config_ = vault_config_future.get();
+  if (standby)
+    LOG(kInfo) << "Waiting as standby vault for VaultManager to assign config";
+  auto vault_config(vault_config_future.get());
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    vault_config_ = std::move(vault_config);
+  }
   LOG(kSuccess) << "Retrieved config info from VaultManager";
 }
 
-VaultConfig VaultInterface::GetConfiguration() { return *vault_config_; }
+VaultInterface::~VaultInterface() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  exiting_ = true;
+}
+
+std::shared_ptr<tcp::Connection> VaultInterface::Connect() {
+  tcp::ConnectionPtr tcp_connection{tcp::Connection::MakeShared(strand_, vault_manager_port_)};
+  tcp_connection->Start(
+      [this](tcp::Message message) { HandleReceivedMessage(std::move(message)); },
+      [this] { OnConnectionClosed(); });
+  return tcp_connection;
+}
+
+VaultConfig VaultInterface::GetConfiguration() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return *vault_config_;
+}
 
 int VaultInterface::WaitForExit() { return exit_code_promise_.get_future().get(); }
 
-void VaultInterface::SendJoined() { Send(tcp_connection_, JoinedNetwork()); }
+void VaultInterface::SendJoined() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  joined_network_ = true;
+  Send(tcp_connection_, JoinedNetwork());
+}
+
+void VaultInterface::SendNetworkHealth(int network_health) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  network_health_ = network_health;
+  Send(tcp_connection_, NetworkHealthUpdate(network_health));
+}
+
+void VaultInterface::SendLogMessage(const std::string& message) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  Send(tcp_connection_, LogMessage(message));
+}
+
+void VaultInterface::SendStatistics(const VaultStatistics& statistics) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  statistics_ = maidsafe::make_unique<VaultStatistics>(statistics);
+  Send(tcp_connection_, VaultStats(statistics));
+}
+
+void VaultInterface::SetHeartbeatExecutor(
+    std::function<void(std::function<void()>)> executor) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  heartbeat_executor_ = std::move(executor);
+}
 
 void VaultInterface::OnConnectionClosed() {
   LOG(kError) << "Lost connection to Vault Manager";
-  std::call_once(exit_code_flag_, [this] {
-    exit_code_promise_.set_value(ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
-  });
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    if (vault_config_ && !exiting_) {
+      if (!reconnecting_) {
+        reconnecting_ = true;
+        reconnect_service_.service().post([this] { Reconnect(); });
+      }
+      return;
+    }
+  }
+  SetExitCode(ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
+}
+
+void VaultInterface::Reconnect() {
+  const auto kDeadline(std::chrono::steady_clock::now() + kVaultReconnectTimeout);
+  while (std::chrono::steady_clock::now() < kDeadline) {
+    maidsafe::Sleep(std::chrono::seconds(1));
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (exiting_)
+        return;
+    }
+    // Connecting blocks, so is done without holding the lock, which the connection's handlers need.
+    tcp::ConnectionPtr connection;
+    try {
+      connection = Connect();
+    } catch (const std::exception&) {
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (exiting_) {
+        connection->Close();
+        return;
+      }
+      tcp_connection_ = connection;
+      // Allow a subsequent disconnection to trigger a new reconnection attempt.
+      reconnecting_ = false;
+    }
+    LOG(kSuccess) << "Reconnected to VaultManager which is listening on port "
+                  << vault_manager_port_;
+    try {
+      Send(connection, VaultReconnectRequest(process::GetProcessId()));
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to send reconnect request: " << boost::diagnostic_information(e);
+    }
+    return;
+  }
+  LOG(kError) << "Failed to reconnect to VaultManager";
+  SetExitCode(ErrorToInt(MakeError(VaultManagerErrors::connection_aborted)));
+}
+
+void VaultInterface::SetExitCode(int exit_code) {
+  std::call_once(exit_code_flag_, [&] { exit_code_promise_.set_value(exit_code); });
 }
 
 void VaultInterface::HandleReceivedMessage(tcp::Message&& message) {
@@ -83,6 +197,12 @@ void VaultInterface::HandleReceivedMessage(tcp::Message&& message) {
       case MessageTag::kVaultShutdownRequest:
         HandleVaultShutdownRequest();
         break;
+      case MessageTag::kChallenge:
+        HandleChallenge(Parse<Challenge>(binary_input_stream));
+        break;
+      case MessageTag::kHeartbeatRequest:
+        HandleHeartbeatRequest(Parse<HeartbeatRequest>(binary_input_stream));
+        break;
       default:
         return;
     }
@@ -100,7 +220,50 @@ void VaultInterface::HandleVaultStartedResponse(VaultStartedResponse&& vault_sta
 
 void VaultInterface::HandleVaultShutdownRequest() {
   LOG(kInfo) << "Received  ShutdownRequest from Vault Manager";
-  std::call_once(exit_code_flag_, [this] { exit_code_promise_.set_value(0); });
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    exiting_ = true;
+  }
+  SetExitCode(0);
+}
+
+void VaultInterface::HandleChallenge(Challenge&& challenge) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (!vault_config_) {
+    LOG(kError) << "Received Challenge before being configured.";
+    return;
+  }
+  Send(tcp_connection_, VaultChallengeResponse(
+                            asymm::Sign(challenge.plaintext, vault_config_->pmid.private_key())));
+  // The new VaultManager has no record of our network status.
+  if (joined_network_)
+    Send(tcp_connection_, JoinedNetwork());
+  if (network_health_ >= 0)
+    Send(tcp_connection_, NetworkHealthUpdate(network_health_));
+  if (statistics_)
+    Send(tcp_connection_, VaultStats(*statistics_));
+}
+
+void VaultInterface::HandleHeartbeatRequest(HeartbeatRequest&& heartbeat_request) {
+  std::function<void(std::function<void()>)> executor;
+  tcp::ConnectionPtr connection;
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    executor = heartbeat_executor_;
+    connection = tcp_connection_;
+  }
+  uint32_t sequence{heartbeat_request.sequence};
+  std::function<void()> reply{[connection, sequence] {
+    try {
+      Send(connection, HeartbeatResponse(sequence));
+    } catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to send heartbeat response: " << boost::diagnostic_information(e);
+    }
+  }};
+  if (executor)
+    executor(std::move(reply));
+  else
+    reply();
 }
 
 #ifdef TESTING
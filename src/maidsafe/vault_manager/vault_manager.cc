@@ -18,6 +18,8 @@
 
 #include "maidsafe/vault_manager/vault_manager.h"
 
+#include <cstdint>
+#include <future>
 #include <string>
 #include <vector>
 
@@ -35,20 +37,43 @@
 // #include "maidsafe/nfs/client/maid_client.h"
 
 #include "maidsafe/vault_manager/client_connections.h"
+#include "maidsafe/vault_manager/event_log.h"
 #include "maidsafe/vault_manager/new_connections.h"
 #include "maidsafe/vault_manager/process_manager.h"
+#include "maidsafe/vault_manager/rolling_upgrade.h"
+#include "maidsafe/vault_manager/tracing.h"
 #include "maidsafe/vault_manager/utils.h"
 #include "maidsafe/vault_manager/messages/challenge.h"
 #include "maidsafe/vault_manager/messages/challenge_response.h"
+#include "maidsafe/vault_manager/messages/flow_control_ack.h"
+#include "maidsafe/vault_manager/messages/heartbeat_response.h"
 #include "maidsafe/vault_manager/messages/joined_network.h"
+#include "maidsafe/vault_manager/messages/list_vaults_request.h"
+#include "maidsafe/vault_manager/messages/list_vaults_response.h"
 #include "maidsafe/vault_manager/messages/log_message.h"
 #include "maidsafe/vault_manager/messages/max_disk_usage_update.h"
+#include "maidsafe/vault_manager/messages/network_health_update.h"
 #include "maidsafe/vault_manager/messages/network_stable_request.h"
 #include "maidsafe/vault_manager/messages/network_stable_response.h"
+#include "maidsafe/vault_manager/messages/remove_vault_progress.h"
+#include "maidsafe/vault_manager/messages/remove_vault_request.h"
+#include "maidsafe/vault_manager/messages/remove_vault_response.h"
+#include "maidsafe/vault_manager/messages/resume_session_request.h"
+#include "maidsafe/vault_manager/messages/session_ticket.h"
 #include "maidsafe/vault_manager/messages/set_network_as_stable.h"
 #include "maidsafe/vault_manager/messages/start_vault_request.h"
 #include "maidsafe/vault_manager/messages/take_ownership_request.h"
+#include "maidsafe/vault_manager/messages/upgrade_vaults_request.h"
+#include "maidsafe/vault_manager/messages/upgrade_vaults_response.h"
 #include "maidsafe/vault_manager/messages/validate_connection_request.h"
+#include "maidsafe/vault_manager/messages/vault_challenge_response.h"
+#include "maidsafe/vault_manager/messages/vault_events_subscription.h"
+#include "maidsafe/vault_manager/messages/vault_lifecycle_event.h"
+#include "maidsafe/vault_manager/messages/vault_network_status.h"
+#include "maidsafe/vault_manager/messages/vault_stats.h"
+#include "maidsafe/vault_manager/messages/vault_stats_request.h"
+#include "maidsafe/vault_manager/messages/vault_stats_response.h"
+#include "maidsafe/vault_manager/messages/vault_reconnect_request.h"
 #include "maidsafe/vault_manager/messages/vault_running_response.h"
 #include "maidsafe/vault_manager/messages/vault_shutdown_request.h"
 #include "maidsafe/vault_manager/messages/vault_started.h"
@@ -72,8 +97,6 @@ fs::path GetPath(const fs::path& p) {
 
 fs::path GetConfigFilePath() { return GetPath(kConfigFilename); }
 
-fs::path GetVaultDir(const std::string& debug_id) { return GetPath(debug_id); }
-
 fs::path GetVaultExecutablePath() {
 #ifdef TESTING
   if (!GetPathToVault().empty())
@@ -82,6 +105,12 @@ fs::path GetVaultExecutablePath() {
   return process::GetOtherExecutablePath(fs::path{"vault"});
 }
 
+template <typename T>
+T ParseMessage(InputVectorStream& binary_input_stream) {
+  VAULT_MANAGER_TRACE_SPAN("Parse");
+  return Parse<T>(binary_input_stream);
+}
+
 void PutPmidAndSigner(const passport::PmidAndSigner& /*pmid_and_signer*/) {
 //  std::shared_ptr<nfs_client::MaidClient> client_nfs(
 //    nfs_client::MaidClient::MakeShared(passport::MaidAndSigner{passport::CreateMaidAndSigner()}));
@@ -90,21 +119,42 @@ void PutPmidAndSigner(const passport::PmidAndSigner& /*pmid_and_signer*/) {
 //  client_nfs->Stop();
 }
 
+// The directories within which vault directories are created, and so may be deleted.
+std::vector<fs::path> ManagedRoots(const VaultPlacer& vault_placer) {
+  std::vector<fs::path> managed_roots(vault_placer.Volumes());
+  managed_roots.push_back(GetPath(fs::path()));
+  return managed_roots;
+}
+
 }  // unnamed namespace
 
-VaultManager::VaultManager()
+VaultManager::VaultManager(int standby_vault_count, std::vector<fs::path> data_volumes)
     : config_file_handler_(GetConfigFilePath()),
+      event_log_(std::make_shared<EventLog>(GetPath(kEventLogFilename))),
       network_stable_(false),
       tear_down_with_interval_(false),
+      handed_over_(false),
       asio_service_(1),
       strand_(asio_service_.service()),
+      vault_placer_(std::move(data_volumes), GetPath(fs::path())),
+      io_load_timer_(asio_service_.service()),
+      chunkstore_reclaimer_(ManagedRoots(vault_placer_), [this] { return GetProtectedPaths(); }),
+      blocking_io_(asio_service_.service(), kBlockingIoThreads),
+      config_persister_(asio_service_.service(), blocking_io_, config_file_handler_,
+                        [this] { return process_manager_->GetAll(); }),
       listener_(tcp::Listener::MakeShared(
           strand_, [this](tcp::ConnectionPtr connection) { HandleNewConnection(connection); },
           GetInitialListeningPort())),
       process_manager_(ProcessManager::MakeShared(asio_service_.service(), GetVaultExecutablePath(),
                                                   listener_->ListeningPort())),
       client_connections_(ClientConnections::MakeShared(asio_service_.service())),
-      new_connections_(NewConnections::MakeShared(asio_service_.service())) {
+      new_connections_(NewConnections::MakeShared(asio_service_.service())),
+      rolling_upgrade_(),
+      pending_adoptions_() {
+  process_manager_->SetEventLog(event_log_);
+  process_manager_->SetVaultEventFunctor([this](const Identity& owner_name, VaultEvent event) {
+    SendVaultEvent(owner_name, std::move(event));
+  });
   std::vector<VaultInfo> vaults{config_file_handler_.ReadConfigFile()};
   if (vaults.empty()) {
 #ifndef TESTING
@@ -123,19 +173,52 @@ VaultManager::VaultManager()
       }
     } while (!stored_pmid_and_signer);
 
-    vault_info.vault_dir = GetVaultDir(DebugId(vault_info.pmid_and_signer->first.name().value));
-    if (!fs::exists(vault_info.vault_dir))
-      fs::create_directories(vault_info.vault_dir);
-    auto space_info(fs::space(vault_info.vault_dir));
-    vault_info.max_disk_usage = DiskUsage{(9 * space_info.available) / 10};
+    std::string dir_name{DebugId(vault_info.pmid_and_signer->first.name().value)};
     vault_info.label = GenerateLabel();
-    process_manager_->AddProcess(std::move(vault_info));
-    LOG(kSuccess) << "Vault process handed over to process manager.";
-    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+    auto new_vault(std::make_shared<VaultInfo>(std::move(vault_info)));
+    auto placement(std::make_shared<VaultPlacement>());
+    blocking_io_.Run(
+        [this, placement, dir_name] {
+          *placement = vault_placer_.Place(std::vector<fs::path>(), dir_name);
+          try {
+            if (!fs::exists(placement->vault_dir)) {
+              fs::create_directories(placement->vault_dir);
+              MarkAsReclaimable(placement->vault_dir);
+            }
+          } catch (const std::exception&) {
+            vault_placer_.Forget(placement->vault_dir);
+            throw;
+          }
+        },
+        [this, new_vault, placement](std::exception_ptr io_error) {
+          try {
+            if (io_error)
+              std::rethrow_exception(io_error);
+            new_vault->vault_dir = placement->vault_dir;
+            new_vault->max_disk_usage = placement->max_disk_usage;
+            process_manager_->AddProcess(std::move(*new_vault));
+            LOG(kSuccess) << "Vault process handed over to process manager.";
+            config_persister_.MarkDirty();
+          } catch (const std::exception& e) {
+            LOG(kError) << "Failed to start vault: " << boost::diagnostic_information(e);
+            if (!io_error)
+              vault_placer_.Forget(placement->vault_dir);
+          }
+        });
 #endif
   } else {
-    for (auto& vault_info : vaults)
-      process_manager_->AddProcess(std::move(vault_info));
+    for (auto& vault_info : vaults) {
+      if (!process_manager_->AdoptProcess(vault_info))
+        process_manager_->AddProcess(std::move(vault_info));
+    }
+  }
+  // With a single volume there's nothing to choose between.
+  if (vault_placer_.Volumes().size() > 1)
+    asio_service_.service().post([this] { SampleIoLoad(); });
+  if (standby_vault_count > 0) {
+    process_manager_->SetStandbyPool(standby_vault_count, [this](VaultInfoPtr vault_info) {
+      SendVaultConfig(*vault_info);
+    });
   }
   LOG(kInfo) << "VaultManager started";
 }
@@ -146,6 +229,14 @@ void VaultManager::TearDownWithInterval() {
   auto new_connections(new_connections_);
   auto client_connections(client_connections_);
   auto process_manager(process_manager_);
+  // 'rolling_upgrade_' is only accessed on the asio thread.
+  std::promise<void> upgrade_stopped;
+  asio_service_.service().post([&] {
+    if (rolling_upgrade_)
+      rolling_upgrade_->Stop();
+    upgrade_stopped.set_value();
+  });
+  upgrade_stopped.get_future().get();
   auto future(std::async(std::launch::async, [=] {
     listener->StopListening();
     new_connections->CloseAll();
@@ -153,33 +244,79 @@ void VaultManager::TearDownWithInterval() {
     process_manager->StopAllWithInterval();
   }));
   future.get();
+  std::promise<std::shared_future<void>> written;
+  asio_service_.service().post([&] { written.set_value(config_persister_.Flush()); });
+  try {
+    written.get_future().get().get();
+  } catch (const std::exception&) {
+  }  // Already logged by 'config_persister_'.
   asio_service_.Stop();
 }
 
+void VaultManager::TearDownForHandover() {
+  handed_over_ = true;
+  auto listener(listener_);
+  auto new_connections(new_connections_);
+  auto client_connections(client_connections_);
+  auto process_manager(process_manager_);
+  std::promise<void> released;
+  std::shared_future<void> written;
+  asio_service_.service().post([&] {
+    if (rolling_upgrade_)
+      rolling_upgrade_->Stop();
+    listener->StopListening();
+    new_connections->CloseAll();
+    client_connections->CloseAll();
+    written = config_persister_.Flush();
+    process_manager->ReleaseAll();
+    released.set_value();
+  });
+  released.get_future().get();
+  try {
+    written.get();
+  } catch (const std::exception&) {
+  }  // Already logged by 'config_persister_'.
+  asio_service_.Stop();
+  LOG(kInfo) << "VaultManager stopped, leaving vaults running";
+}
+
 VaultManager::~VaultManager() {
-  if (!tear_down_with_interval_) {
+  if (!tear_down_with_interval_ && !handed_over_) {
     auto listener(listener_);
     auto new_connections(new_connections_);
     auto client_connections(client_connections_);
     auto process_manager(process_manager_);
-    asio_service_.service().post([=] {
+    std::promise<std::shared_future<void>> written;
+    asio_service_.service().post([=, &written] {
+      if (rolling_upgrade_)
+        rolling_upgrade_->Stop();
       listener->StopListening();
       new_connections->CloseAll();
       client_connections->CloseAll();
       process_manager->StopAll();
+      // Don't lose changes still waiting out the coalescing window.
+      written.set_value(config_persister_.Flush());
     });
+    try {
+      written.get_future().get().get();
+    } catch (const std::exception&) {
+    }  // Already logged by 'config_persister_'.
     asio_service_.Stop();
   }
 }
 
 void VaultManager::HandleNewConnection(tcp::ConnectionPtr connection) {
-  new_connections_->Add(connection);
+  if (!new_connections_->Add(connection)) {
+    connection->Close();
+    return;
+  }
   tcp::MessageReceivedFunctor on_message{
       [=](tcp::Message message) { HandleReceivedMessage(connection, std::move(message)); }};
   connection->Start(on_message, [=] { HandleConnectionClosed(connection); });
 }
 
 void VaultManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
+  pending_adoptions_.erase(connection);
   if (process_manager_->HandleConnectionClosed(connection) ||
       client_connections_->Remove(connection)) {
     return;
@@ -188,29 +325,77 @@ void VaultManager::HandleConnectionClosed(tcp::ConnectionPtr connection) {
 }
 
 void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Message&& message) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleReceivedMessage");
   try {
     InputVectorStream binary_input_stream(std::move(message));
     MessageTag tag(static_cast<MessageTag>(-1));
-    Parse(binary_input_stream, tag);
+    {
+      VAULT_MANAGER_TRACE_SPAN("Parse");
+      Parse(binary_input_stream, tag);
+    }
     switch (tag) {
       case MessageTag::kValidateConnectionRequest:
         HandleValidateConnectionRequest(connection);
         break;
       case MessageTag::kChallengeResponse:
-        HandleChallengeResponse(connection, Parse<ChallengeResponse>(binary_input_stream));
+        HandleChallengeResponse(connection, ParseMessage<ChallengeResponse>(binary_input_stream));
+        break;
+      case MessageTag::kResumeSessionRequest:
+        HandleResumeSessionRequest(connection,
+                                   ParseMessage<ResumeSessionRequest>(binary_input_stream));
         break;
       case MessageTag::kStartVaultRequest:
-        HandleStartVaultRequest(connection, Parse<StartVaultRequest>(binary_input_stream));
+        HandleStartVaultRequest(connection, ParseMessage<StartVaultRequest>(binary_input_stream));
         break;
       case MessageTag::kTakeOwnershipRequest:
-        HandleTakeOwnershipRequest(connection, Parse<TakeOwnershipRequest>(binary_input_stream));
+        HandleTakeOwnershipRequest(connection,
+                                   ParseMessage<TakeOwnershipRequest>(binary_input_stream));
+        break;
+      case MessageTag::kUpgradeVaultsRequest:
+        HandleUpgradeVaultsRequest(connection,
+                                   ParseMessage<UpgradeVaultsRequest>(binary_input_stream));
+        break;
+      case MessageTag::kVaultStatsRequest:
+        HandleVaultStatsRequest(connection, ParseMessage<VaultStatsRequest>(binary_input_stream));
+        break;
+      case MessageTag::kListVaultsRequest:
+        HandleListVaultsRequest(connection, ParseMessage<ListVaultsRequest>(binary_input_stream));
+        break;
+      case MessageTag::kFlowControlAck:
+        HandleFlowControlAck(connection, ParseMessage<FlowControlAck>(binary_input_stream));
+        break;
+      case MessageTag::kVaultEventsSubscription:
+        HandleVaultEventsSubscription(connection,
+                                      ParseMessage<VaultEventsSubscription>(binary_input_stream));
+        break;
+      case MessageTag::kRemoveVaultRequest:
+        HandleRemoveVaultRequest(connection,
+                                 ParseMessage<RemoveVaultRequest>(binary_input_stream));
         break;
       case MessageTag::kVaultStarted:
-        HandleVaultStarted(connection, Parse<VaultStarted>(binary_input_stream));
+        HandleVaultStarted(connection, ParseMessage<VaultStarted>(binary_input_stream));
         break;
       case MessageTag::kJoinedNetwork:
         HandleJoinedNetwork(connection);
         break;
+      case MessageTag::kNetworkHealthUpdate:
+        HandleNetworkHealthUpdate(connection,
+                                  ParseMessage<NetworkHealthUpdate>(binary_input_stream));
+        break;
+      case MessageTag::kHeartbeatResponse:
+        HandleHeartbeatResponse(connection, ParseMessage<HeartbeatResponse>(binary_input_stream));
+        break;
+      case MessageTag::kVaultStats:
+        HandleVaultStats(connection, ParseMessage<VaultStats>(binary_input_stream));
+        break;
+      case MessageTag::kVaultReconnectRequest:
+        HandleVaultReconnectRequest(connection,
+                                    ParseMessage<VaultReconnectRequest>(binary_input_stream));
+        break;
+      case MessageTag::kVaultChallengeResponse:
+        HandleVaultChallengeResponse(connection,
+                                     ParseMessage<VaultChallengeResponse>(binary_input_stream));
+        break;
 #ifdef TESTING
       case MessageTag::kSetNetworkAsStable:
         HandleSetNetworkAsStable();
@@ -220,7 +405,7 @@ void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Mes
         break;
 #endif
       case MessageTag::kLogMessage:
-        HandleLogMessage(connection, Parse<LogMessage>(binary_input_stream));
+        HandleLogMessage(connection, ParseMessage<LogMessage>(binary_input_stream));
         break;
       default:
         return;
@@ -231,22 +416,58 @@ void VaultManager::HandleReceivedMessage(tcp::ConnectionPtr connection, tcp::Mes
 }
 
 void VaultManager::HandleValidateConnectionRequest(tcp::ConnectionPtr connection) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleValidateConnectionRequest");
   RemoveFromNewConnections(connection);
   asymm::PlainText plain_text{RandomBytes(100, 200)};
 
-  client_connections_->Add(connection, plain_text);
+  try {
+    client_connections_->Add(connection, plain_text);
+  } catch (const std::exception&) {
+    // Over the admission limits; already logged (sparingly) by 'client_connections_'.
+    connection->Close();
+    return;
+  }
   Send(connection, Challenge(std::move(plain_text)));
 }
 
 void VaultManager::HandleChallengeResponse(tcp::ConnectionPtr connection,
                                            ChallengeResponse&& challenge_response) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleChallengeResponse");
   client_connections_->Validate(connection, *challenge_response.public_maid,
                                 challenge_response.signature);
+  HandleClientValidated(connection, challenge_response.public_maid->Name());
+}
+
+void VaultManager::HandleResumeSessionRequest(tcp::ConnectionPtr connection,
+                                              ResumeSessionRequest&& resume_session_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleResumeSessionRequest");
+  Identity client_name;
+  try {
+    client_name = client_connections_->Resume(connection, resume_session_request.ticket);
+  } catch (const std::exception& e) {
+    LOG(kInfo) << "Failed to resume client session: " << boost::diagnostic_information(e);
+    // The client falls back to answering the challenge on receiving an empty ticket.
+    Send(connection, SessionTicket());
+    return;
+  }
+  HandleClientValidated(connection, client_name);
+}
+
+void VaultManager::HandleClientValidated(tcp::ConnectionPtr connection,
+                                         const Identity& client_name) {
+  Send(connection, SessionTicket(client_connections_->IssueTicket(connection)));
+  // Bring the client up to date with any of its vaults which were restarted (e.g. from the config
+  // file) before it connected.
+  for (const auto& vault_info : process_manager_->GetAll()) {
+    if (vault_info->owner_name == client_name && vault_info->joined_network)
+      SendVaultNetworkStatus(*vault_info);
+  }
 }
 
 
 void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
                                            StartVaultRequest&& start_vault_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleStartVaultRequest");
   maidsafe_error error{MakeError(CommonErrors::unknown)};
   VaultInfo vault_info;
   try {
@@ -261,17 +482,11 @@ void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
     }
 #endif
     if (!vault_info.pmid_and_signer) {
+      VAULT_MANAGER_TRACE_SPAN("passport::CreatePmidAndSigner");
       vault_info.pmid_and_signer =
           std::make_shared<passport::PmidAndSigner>(passport::CreatePmidAndSigner());
       PutPmidAndSigner(*vault_info.pmid_and_signer);
     }
-    if (start_vault_request.vault_dir.empty()) {
-      vault_info.vault_dir = GetVaultDir(hex::Substr(vault_info.pmid_and_signer->first.name()));
-      if (!fs::exists(vault_info.vault_dir))
-        fs::create_directories(vault_info.vault_dir);
-    } else {
-      vault_info.vault_dir = std::move(start_vault_request.vault_dir);
-    }
 #ifdef USE_VLOGGING
     vault_info.vlog_session_id = std::move(start_vault_request.vlog_session_id);
 #ifdef TESTING
@@ -279,9 +494,45 @@ void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
         start_vault_request.send_hostname_to_visualiser_server;
 #endif
 #endif
-    process_manager_->AddProcess(std::move(vault_info));
-    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
-    return;
+    if (!start_vault_request.vault_dir.empty()) {
+      // The client's choice of directory is used as-is, so it's never marked as reclaimable.
+      vault_info.vault_dir = std::move(start_vault_request.vault_dir);
+      fs::path vault_dir{vault_info.vault_dir};
+      auto new_vault(std::make_shared<VaultInfo>(std::move(vault_info)));
+      return blocking_io_.Run([this, vault_dir] { CheckVaultDirIsFree(vault_dir); },
+                              [this, connection, new_vault](std::exception_ptr io_error) {
+                                AddVault(connection, std::move(*new_vault), io_error);
+                              });
+    }
+    // Placed by 'vault_placer_' on one of the configured data volumes.
+    std::string dir_name{hex::Substr(vault_info.pmid_and_signer->first.name())};
+    std::vector<fs::path> existing_vault_dirs;
+    for (const auto& vault : process_manager_->GetAll())
+      existing_vault_dirs.push_back(vault->vault_dir);
+    auto new_vault(std::make_shared<VaultInfo>(std::move(vault_info)));
+    auto placement(std::make_shared<VaultPlacement>());
+    return blocking_io_.Run(
+        [this, placement, existing_vault_dirs, dir_name] {
+          *placement = vault_placer_.Place(existing_vault_dirs, dir_name);
+          try {
+            CheckVaultDirIsFree(placement->vault_dir);
+            if (!fs::exists(placement->vault_dir)) {
+              fs::create_directories(placement->vault_dir);
+              MarkAsReclaimable(placement->vault_dir);
+            }
+          } catch (const std::exception&) {
+            vault_placer_.Forget(placement->vault_dir);
+            throw;
+          }
+        },
+        [this, connection, new_vault, placement](std::exception_ptr io_error) {
+          if (!io_error) {
+            new_vault->vault_dir = placement->vault_dir;
+            if (new_vault->max_disk_usage == 0U)
+              new_vault->max_disk_usage = placement->max_disk_usage;
+          }
+          AddVault(connection, std::move(*new_vault), io_error);
+        });
   } catch (const maidsafe_error& e) {
     LOG(kWarning) << boost::diagnostic_information(e);
     error = e;
@@ -292,8 +543,32 @@ void VaultManager::HandleStartVaultRequest(tcp::ConnectionPtr connection,
   Send(connection, VaultRunningResponse(std::move(vault_info.label), std::move(error)));
 }
 
+void VaultManager::AddVault(tcp::ConnectionPtr client, VaultInfo vault_info,
+                            std::exception_ptr io_error) {
+  maidsafe_error error{MakeError(CommonErrors::unknown)};
+  NonEmptyString label{vault_info.label};
+  fs::path vault_dir{vault_info.vault_dir};
+  try {
+    if (io_error)
+      std::rethrow_exception(io_error);
+    process_manager_->AddProcess(std::move(vault_info));
+    config_persister_.MarkDirty();
+    return;
+  } catch (const maidsafe_error& e) {
+    LOG(kWarning) << boost::diagnostic_information(e);
+    error = e;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << boost::diagnostic_information(e);
+  }
+  LOG(kError) << "Failed to add vault " << label;
+  // Otherwise it would count against its volume in later placements.
+  vault_placer_.Forget(vault_dir);
+  Send(client, VaultRunningResponse(std::move(label), std::move(error)));
+}
+
 void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
                                               TakeOwnershipRequest&& take_ownership_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleTakeOwnershipRequest");
   maidsafe_error error{MakeError(CommonErrors::unknown)};
   VaultInfo vault_info;
   try {
@@ -302,22 +577,38 @@ void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
     NonEmptyString label{take_ownership_request.vault_label};
     fs::path new_vault_dir{take_ownership_request.vault_dir};
     DiskUsage new_max_disk_usage{take_ownership_request.max_disk_usage};
-    VaultInfo vault_info{process_manager_->Find(label)};
+    VaultInfoPtr current_info{process_manager_->Find(label)};
 
-    if (vault_info.vault_dir != new_vault_dir) {
-      vault_info.vault_dir = new_vault_dir;
-      vault_info.max_disk_usage = new_max_disk_usage;
-      vault_info.owner_name = client_name;
-      return ChangeChunkstorePath(std::move(vault_info));
+    if (current_info->vault_dir != new_vault_dir) {
+      // TODO(Fraser#5#): 2014-05-13 - Handle sending a "MoveChunkstoreRequest" to avoid stopping
+      //                               then restarting the vault.
+      auto moved_vault(std::make_shared<VaultInfo>(*current_info));
+      moved_vault->vault_dir = new_vault_dir;
+      moved_vault->max_disk_usage = new_max_disk_usage;
+      moved_vault->owner_name = client_name;
+      return blocking_io_.Run(
+          [this, new_vault_dir] { CheckVaultDirIsFree(new_vault_dir); },
+          [this, connection, moved_vault](std::exception_ptr io_error) {
+            if (!io_error)
+              return RestartVault(std::move(*moved_vault));
+            maidsafe_error error{MakeError(CommonErrors::unknown)};
+            try {
+              std::rethrow_exception(io_error);
+            } catch (const maidsafe_error& e) {
+              error = e;
+            } catch (const std::exception&) {
+            }
+            LOG(kError) << "Failed to move vault " << moved_vault->label;
+            Send(connection, VaultRunningResponse(moved_vault->label, std::move(error)));
+          });
     }
 
-    if (vault_info.max_disk_usage != new_max_disk_usage && new_max_disk_usage != 0U)
-      Send(vault_info.tcp_connection, MaxDiskUsageUpdate(new_max_disk_usage));
+    if (current_info->max_disk_usage != new_max_disk_usage && new_max_disk_usage != 0U)
+      Send(current_info->tcp_connection, MaxDiskUsageUpdate(new_max_disk_usage));
 
     process_manager_->AssignOwner(label, client_name, new_max_disk_usage);
-    config_file_handler_.WriteConfigFile(process_manager_->GetAll());
-    Send(connection,
-         VaultRunningResponse(std::move(label), std::move(*vault_info.pmid_and_signer)));
+    config_persister_.MarkDirty();
+    Send(connection, VaultRunningResponse(std::move(label), *current_info->pmid_and_signer));
     return;
   } catch (const maidsafe_error& e) {
     LOG(kWarning) << boost::diagnostic_information(e);
@@ -328,27 +619,252 @@ void VaultManager::HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
   Send(connection, VaultRunningResponse(std::move(vault_info.label), std::move(error)));
 }
 
-void VaultManager::ChangeChunkstorePath(VaultInfo vault_info) {
-  // TODO(Fraser#5#): 2014-05-13 - Handle sending a "MoveChunkstoreRequest" to avoid stopping then
-  //                               restarting the vault.
+void VaultManager::HandleUpgradeVaultsRequest(tcp::ConnectionPtr connection,
+                                              UpgradeVaultsRequest&& upgrade_vaults_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleUpgradeVaultsRequest");
+  maidsafe_error error{MakeError(CommonErrors::unknown)};
+  const uint32_t kRequestId{upgrade_vaults_request.request_id};
+  try {
+    Identity client_name{client_connections_->FindValidated(connection)};
+    if (rolling_upgrade_) {
+      LOG(kError) << "An upgrade is already in progress.";
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+    }
+    // The executable is shared by every vault on this host, so a client may only switch it if it
+    // doesn't restart (or change the next restart of) vaults owned by other clients.
+    for (const auto& vault_info : process_manager_->GetAll()) {
+      if (vault_info->owner_name.IsInitialised() && !(vault_info->owner_name == client_name)) {
+        LOG(kError) << "Client can't upgrade vaults it doesn't own.";
+        BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+      }
+    }
+    auto on_complete([this, connection, kRequestId](maidsafe_error result,
+                                                    std::vector<NonEmptyString> upgraded_labels) {
+      rolling_upgrade_.reset();
+      if (result.code() == make_error_code(CommonErrors::success))
+        Send(connection, UpgradeVaultsResponse(kRequestId, std::move(upgraded_labels)));
+      else
+        Send(connection, UpgradeVaultsResponse(kRequestId, std::move(result)));
+    });
+    auto rolling_upgrade(RollingUpgrade::MakeShared(
+        asio_service_.service(), process_manager_, upgrade_vaults_request.batch_size,
+        kVaultJoinTimeout, [this](VaultInfo vault_info) { RestartVault(std::move(vault_info)); },
+        on_complete));
+    rolling_upgrade->Start(std::move(upgrade_vaults_request.vault_executable_path));
+    rolling_upgrade_ = rolling_upgrade;
+    return;
+  } catch (const maidsafe_error& e) {
+    LOG(kWarning) << boost::diagnostic_information(e);
+    error = e;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << boost::diagnostic_information(e);
+  }
+  Send(connection, UpgradeVaultsResponse(kRequestId, std::move(error)));
+}
+
+void VaultManager::HandleVaultStatsRequest(tcp::ConnectionPtr connection,
+                                           VaultStatsRequest&& vault_stats_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleVaultStatsRequest");
+  try {
+    Identity client_name{client_connections_->FindValidated(connection)};
+    HostStatistics host_statistics;
+    for (const auto& vault : process_manager_->GetAllStatistics()) {
+      const VaultStatistics& statistics(vault.second);
+      if (vault.first->owner_name == client_name)
+        host_statistics.vaults.emplace(vault.first->label, statistics);
+      host_statistics.totals.chunks_stored += statistics.chunks_stored;
+      host_statistics.totals.bytes_used += statistics.bytes_used;
+      host_statistics.totals.get_requests_per_minute += statistics.get_requests_per_minute;
+      host_statistics.totals.put_requests_per_minute += statistics.put_requests_per_minute;
+      host_statistics.totals.routing_table_size += statistics.routing_table_size;
+      host_statistics.totals.cache_hits += statistics.cache_hits;
+      host_statistics.totals.cache_misses += statistics.cache_misses;
+      ++host_statistics.vault_count;
+    }
+    Send(connection,
+         VaultStatsResponse(vault_stats_request.request_id, std::move(host_statistics)));
+  } catch (const maidsafe_error& e) {
+    LOG(kWarning) << "Failed to handle vault stats request: " << boost::diagnostic_information(e);
+    Send(connection, VaultStatsResponse(vault_stats_request.request_id, e));
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to handle vault stats request: " << boost::diagnostic_information(e);
+    Send(connection,
+         VaultStatsResponse(vault_stats_request.request_id, MakeError(CommonErrors::unknown)));
+  }
+}
+
+void VaultManager::HandleListVaultsRequest(tcp::ConnectionPtr connection,
+                                           ListVaultsRequest&& list_vaults_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleListVaultsRequest");
+  // A vault's label is enough to take ownership of it, so clients may only list their own vaults.
+  try {
+    Identity client_name{client_connections_->FindValidated(connection)};
+    Send(connection,
+         ListVaultsResponse(list_vaults_request.request_id,
+                            process_manager_->ListVaults(client_name, list_vaults_request.query)));
+  } catch (const maidsafe_error& e) {
+    LOG(kWarning) << "Failed to handle list vaults request: " << boost::diagnostic_information(e);
+    Send(connection, ListVaultsResponse(list_vaults_request.request_id, e));
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to handle list vaults request: " << boost::diagnostic_information(e);
+    Send(connection,
+         ListVaultsResponse(list_vaults_request.request_id, MakeError(CommonErrors::unknown)));
+  }
+}
+
+void VaultManager::HandleFlowControlAck(tcp::ConnectionPtr connection,
+                                        FlowControlAck&& flow_control_ack) {
+  client_connections_->HandleFlowControlAck(connection, flow_control_ack.message_count);
+}
+
+void VaultManager::HandleVaultEventsSubscription(
+    tcp::ConnectionPtr connection, VaultEventsSubscription&& vault_events_subscription) {
+  try {
+    client_connections_->SetSubscribedToVaultEvents(connection,
+                                                    vault_events_subscription.subscribe);
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to handle vault events subscription: "
+                  << boost::diagnostic_information(e);
+  }
+}
+
+void VaultManager::HandleRemoveVaultRequest(tcp::ConnectionPtr connection,
+                                            RemoveVaultRequest&& remove_vault_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleRemoveVaultRequest");
+  maidsafe_error error{MakeError(CommonErrors::unknown)};
+  NonEmptyString label{std::move(remove_vault_request.vault_label)};
+  try {
+    Identity client_name{client_connections_->FindValidated(connection)};
+    VaultInfoPtr vault_info{process_manager_->Find(label)};
+    // As for ListVaults, don't reveal the existence of other clients' vaults.
+    if (!(vault_info->owner_name == client_name)) {
+      LOG(kWarning) << "Client isn't the owner of vault " << label;
+      BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
+    }
+    fs::path vault_dir{vault_info->vault_dir};
+    process_manager_->StopProcess(
+        label, [this, client_name, label, vault_dir](maidsafe_error /*error*/, int /*exit_code*/) {
+          // The vault is no longer listed by 'process_manager_', so the next write drops it.
+          config_persister_.MarkDirty(
+              [this, client_name, label, vault_dir](std::exception_ptr io_error) {
+                HandleVaultRemoved(client_name, label, vault_dir, io_error);
+              });
+        });
+    return;
+  } catch (const maidsafe_error& e) {
+    LOG(kWarning) << boost::diagnostic_information(e);
+    error = e;
+  } catch (const std::exception& e) {
+    LOG(kWarning) << boost::diagnostic_information(e);
+  }
+  LOG(kError) << "Failed to remove vault " << label;
+  Send(connection, RemoveVaultResponse(std::move(label), std::move(error)));
+}
+
+void VaultManager::HandleVaultRemoved(const Identity& owner_name, const NonEmptyString& label,
+                                      const fs::path& vault_dir, std::exception_ptr io_error) {
+  tcp::ConnectionPtr client;
+  try {
+    client = client_connections_->FindValidated(owner_name);
+  } catch (const std::exception&) {
+  }  // The client may have disconnected; the removal goes ahead regardless.
+
+  if (io_error) {
+    // The vault may still be listed in the config file, so its directory is kept.
+    maidsafe_error error{MakeError(CommonErrors::filesystem_io_error)};
+    try {
+      std::rethrow_exception(io_error);
+    } catch (const maidsafe_error& e) {
+      error = e;
+    } catch (const std::exception&) {
+    }
+    if (client)
+      Send(client, RemoveVaultResponse(label, std::move(error)));
+    return;
+  }
+
+  LOG(kInfo) << "Removed vault " << label;
+  if (client)
+    Send(client, RemoveVaultResponse(label));
+
+  chunkstore_reclaimer_.Reclaim(label, vault_dir,
+                                [this, owner_name](VaultRemovalProgress progress) {
+                                  asio_service_.service().post([this, owner_name, progress] {
+                                    SendRemovalProgress(owner_name, progress);
+                                  });
+                                });
+}
+
+std::future<std::vector<fs::path>> VaultManager::GetProtectedPaths() {
+  auto protected_paths(std::make_shared<std::promise<std::vector<fs::path>>>());
+  asio_service_.service().post([this, protected_paths] {
+    std::vector<fs::path> paths(vault_placer_.Volumes());
+    paths.push_back(GetPath(fs::path()));
+    paths.push_back(process_manager_->VaultExecutablePath());
+    for (const auto& vault : process_manager_->GetAll())
+      paths.push_back(vault->vault_dir);
+    protected_paths->set_value(std::move(paths));
+  });
+  return protected_paths->get_future();
+}
+
+void VaultManager::SampleIoLoad() {
+  blocking_io_.Run([this] { vault_placer_.SampleIoLoad(); },
+                   [this](std::exception_ptr /*io_error*/) {
+                     io_load_timer_.expires_from_now(kIoLoadSampleInterval);
+                     io_load_timer_.async_wait([this](const std::error_code& ec) {
+                       if (ec != asio::error::operation_aborted)
+                         SampleIoLoad();
+                     });
+                   });
+}
+
+void VaultManager::CheckVaultDirIsFree(const fs::path& vault_dir) {
+  if (chunkstore_reclaimer_.IsReclaiming(vault_dir)) {
+    LOG(kError) << vault_dir << " is still being deleted after its previous vault was removed";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::unable_to_handle_request));
+  }
+}
+
+void VaultManager::SendRemovalProgress(const Identity& owner_name,
+                                       VaultRemovalProgress progress) {
+  try {
+    tcp::ConnectionPtr client{client_connections_->FindValidated(owner_name)};
+    Send(client, RemoveVaultProgress(std::move(progress)));
+  } catch (const std::exception&) {
+  }  // We don't care if the client isn't connected.
+}
+
+void VaultManager::RestartVault(VaultInfo vault_info) {
   Send(vault_info.tcp_connection, VaultShutdownRequest());
   ProcessManager::OnExitFunctor on_exit{
       [this, vault_info](maidsafe_error /*error*/, int /*exit_code*/) {
         process_manager_->AddProcess(std::move(vault_info));
-        config_file_handler_.WriteConfigFile(process_manager_->GetAll());
+        config_persister_.MarkDirty();
       }};
   process_manager_->StopProcess(vault_info.tcp_connection, on_exit);
 }
 
 void VaultManager::HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarted&& vault_started) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleVaultStarted");
   // TODO(Fraser#5#): 2014-05-20 - We should validate received ProcessID since a malicious process
   //                  could have spotted a new vault process starting and jumped in with this TCP
   //                  connection before the new vault can connect, passing itself off as the new
   //                  vault (i.e. lying about its own Process ID).
   RemoveFromNewConnections(connection);
-  VaultInfo vault_info{
+  VaultInfoPtr vault_info{
       process_manager_->HandleVaultStarted(connection, {vault_started.process_id})};
+  if (!vault_info->pmid_and_signer) {
+    // This is a standby process - it will be sent its config once it's assigned a vault.
+    return;
+  }
+  SendVaultConfig(*vault_info);
+  LOG(kSuccess) << "Vault started.  Pmid ID: " << vault_info->pmid_and_signer->first.name()
+                << "  Process ID: " << vault_started.process_id
+                << "  Label: " << hex::Encode(vault_info->label);
+}
 
+void VaultManager::SendVaultConfig(const VaultInfo& vault_info) {
   // Send vault its credentials
   Send(vault_info.tcp_connection,
        VaultStartedResponse(vault_info, config_file_handler_.SymmKeyAndIV()));
@@ -362,9 +878,50 @@ void VaultManager::HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarte
     }  // We don't care if the client isn't connected.
   }
 
-  LOG(kSuccess) << "Vault started.  Pmid ID: " << vault_info.pmid_and_signer->first.name()
-                << "  Process ID: " << vault_started.process_id
-                << "  Label: " << hex::Encode(vault_info.label);
+  // Persist the vault's process ID in case this VaultManager is replaced while the vault runs.
+  config_persister_.MarkDirty();
+}
+
+void VaultManager::HandleVaultReconnectRequest(tcp::ConnectionPtr connection,
+                                               VaultReconnectRequest&& vault_reconnect_request) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleVaultReconnectRequest");
+  // Leave the connection in new_connections_ until the challenge is answered so that it's closed if
+  // the vault doesn't respond in time.
+  process_manager_->FindAwaitingAdoption(vault_reconnect_request.process_id);
+  asymm::PlainText plain_text{RandomBytes(100, 200)};
+  pending_adoptions_[connection] = std::make_pair(vault_reconnect_request.process_id, plain_text);
+  Send(connection, Challenge(std::move(plain_text)));
+}
+
+void VaultManager::HandleVaultChallengeResponse(tcp::ConnectionPtr connection,
+                                                VaultChallengeResponse&& vault_challenge_response) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleVaultChallengeResponse");
+  RemoveFromNewConnections(connection);
+  auto itr(pending_adoptions_.find(connection));
+  if (itr == std::end(pending_adoptions_)) {
+    LOG(kError) << "Unexpected VaultChallengeResponse.";
+    connection->Close();
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::connection_not_found));
+  }
+  process::ProcessId process_id{itr->second.first};
+  asymm::PlainText plain_text{std::move(itr->second.second)};
+  pending_adoptions_.erase(itr);
+
+  VaultInfoPtr vault_info{process_manager_->FindAwaitingAdoption(process_id)};
+  bool valid_signature(false);
+  {
+    VAULT_MANAGER_TRACE_SPAN("asymm::CheckSignature");
+    valid_signature = asymm::CheckSignature(plain_text, vault_challenge_response.signature,
+                                            vault_info->pmid_and_signer->first.public_key());
+  }
+  if (!valid_signature) {
+    LOG(kError) << "Process claiming to be vault " << vault_info->label << " failed validation.";
+    connection->Close();
+    BOOST_THROW_EXCEPTION(MakeError(VaultManagerErrors::unvalidated_client));
+  }
+  vault_info = process_manager_->HandleVaultAdopted(connection, process_id);
+  LOG(kSuccess) << "Vault reconnected.  Pmid ID: " << vault_info->pmid_and_signer->first.name()
+                << "  Process ID: " << process_id << "  Label: " << hex::Encode(vault_info->label);
 }
 
 #ifdef TESTING
@@ -388,14 +945,80 @@ void VaultManager::HandleNetworkStableRequest(tcp::ConnectionPtr connection) {
 #endif
 
 void VaultManager::HandleJoinedNetwork(tcp::ConnectionPtr connection) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleJoinedNetwork");
   try {
-    VaultInfo vault_info(process_manager_->Find(connection));
-    // TODO(Prakash) do vault_info need joined field
+    VaultInfoPtr vault_info(process_manager_->SetJoinedNetwork(connection));
     std::string log_message("Vault running as " +
-                            hex::Substr(vault_info.pmid_and_signer->first.name()));
+                            hex::Substr(vault_info->pmid_and_signer->first.name()));
     LOG(kInfo) << log_message;
+    if (rolling_upgrade_)
+      rolling_upgrade_->HandleJoinedNetwork(vault_info->label);
+    SendVaultNetworkStatus(*vault_info);
+    tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info->owner_name)};
+    client_connections_->SendDroppable(client, LogMessage(log_message));
+  } catch (const std::exception&) {
+  }  // We don't care if the client isn't connected.
+}
+
+void VaultManager::HandleNetworkHealthUpdate(tcp::ConnectionPtr connection,
+                                             NetworkHealthUpdate&& network_health_update) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleNetworkHealthUpdate");
+  try {
+    SendVaultNetworkStatus(
+        *process_manager_->SetNetworkHealth(connection, network_health_update.network_health));
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to handle network health update: " << boost::diagnostic_information(e);
+  }
+}
+
+void VaultManager::HandleHeartbeatResponse(tcp::ConnectionPtr connection,
+                                           HeartbeatResponse&& heartbeat_response) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleHeartbeatResponse");
+  try {
+    process_manager_->HandleHeartbeatResponse(connection, heartbeat_response.sequence);
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to handle heartbeat response: " << boost::diagnostic_information(e);
+  }
+}
+
+void VaultManager::HandleVaultStats(tcp::ConnectionPtr connection, VaultStats&& vault_stats) {
+  VAULT_MANAGER_TRACE_SPAN("VaultManager::HandleVaultStats");
+  try {
+    process_manager_->SetStatistics(connection, std::move(vault_stats.statistics));
+  } catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to handle vault stats: " << boost::diagnostic_information(e);
+  }
+}
+
+void VaultManager::SendVaultNetworkStatus(const VaultInfo& vault_info) {
+  if (!vault_info.owner_name.IsInitialised())
+    return;
+  try {
     tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info.owner_name)};
-    Send(client, LogMessage(log_message));
+    // Only the latest status of each vault matters, so these can be coalesced for slow clients.
+    client_connections_->SendDroppable(
+        client,
+        VaultNetworkStatus(vault_info.label, vault_info.joined_network, vault_info.network_health),
+        vault_info.label.string());
+  } catch (const std::exception&) {
+  }  // We don't care if the client isn't connected.
+}
+
+void VaultManager::SendVaultEvent(const Identity& owner_name, VaultEvent event) {
+  if (!owner_name.IsInitialised())
+    return;
+  // Once its process has exited, a vault is no longer on the network.  Its owner is told so that it
+  // doesn't count the vault as joined until a restarted process rejoins.
+  if (event.type == VaultEventType::kStopped || event.type == VaultEventType::kExited) {
+    VaultInfo vault_info;
+    vault_info.owner_name = owner_name;
+    vault_info.label = event.label;
+    SendVaultNetworkStatus(vault_info);
+  }
+  try {
+    tcp::ConnectionPtr client{client_connections_->FindValidated(owner_name)};
+    if (client_connections_->IsSubscribedToVaultEvents(client))
+      Send(client, VaultLifecycleEvent(std::move(event)));
   } catch (const std::exception&) {
   }  // We don't care if the client isn't connected.
 }
@@ -403,9 +1026,9 @@ void VaultManager::HandleJoinedNetwork(tcp::ConnectionPtr connection) {
 void VaultManager::HandleLogMessage(tcp::ConnectionPtr connection, LogMessage&& log_message) {
   LOG(kInfo) << log_message.data;
   try {
-    VaultInfo vault_info(process_manager_->Find(connection));
-    tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info.owner_name)};
-    Send(client, std::move(log_message));
+    VaultInfoPtr vault_info(process_manager_->Find(connection));
+    tcp::ConnectionPtr client{client_connections_->FindValidated(vault_info->owner_name)};
+    client_connections_->SendDroppable(client, std::move(log_message));
   } catch (const std::exception&) {
   }  // We don't care if the client isn't connected.
 }
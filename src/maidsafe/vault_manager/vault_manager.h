@@ -19,20 +19,33 @@
 #ifndef MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_H_
 #define MAIDSAFE_VAULT_MANAGER_VAULT_MANAGER_H_
 
+#include <future>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "asio/io_service_strand.hpp"
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/crypto.h"
+#include "maidsafe/common/identity.h"
+#include "maidsafe/common/process.h"
+#include "maidsafe/common/rsa.h"
 #include "maidsafe/common/types.h"
 #include "maidsafe/passport/types.h"
 
+#include "maidsafe/vault_manager/blocking_io.h"
+#include "maidsafe/vault_manager/chunkstore_reclaimer.h"
 #include "maidsafe/vault_manager/config.h"
 #include "maidsafe/vault_manager/config_file_handler.h"
+#include "maidsafe/vault_manager/config_persister.h"
+#include "maidsafe/vault_manager/vault_event.h"
+#include "maidsafe/vault_manager/vault_removal_progress.h"
 #include "maidsafe/vault_manager/vault_info.h"
+#include "maidsafe/vault_manager/vault_placement.h"
 
 namespace maidsafe {
 
@@ -40,27 +53,55 @@ namespace vault_manager {
 
 struct ChallengeResponse;
 class ClientConnections;
+class EventLog;
+struct FlowControlAck;
+struct HeartbeatResponse;
+struct ListVaultsRequest;
 struct LogMessage;
+struct NetworkHealthUpdate;
 class NewConnections;
+struct RemoveVaultRequest;
 class ProcessManager;
+class RollingUpgrade;
+struct ResumeSessionRequest;
 struct StartVaultRequest;
 struct TakeOwnershipRequest;
+struct UpgradeVaultsRequest;
+struct VaultChallengeResponse;
+struct VaultEventsSubscription;
+struct VaultReconnectRequest;
 struct VaultStarted;
+struct VaultStats;
+struct VaultStatsRequest;
 
 // The VaultManager has several responsibilities:
 // * Reads config file on startup and restarts vaults listed in file.
 // * Writes details of all vaults to config file.
 // * Listens and responds to client and vault requests on the loopback address.
+// * Optionally keeps a pool of pre-started standby vault processes to allow new or restarted vaults
+//   to be brought up without waiting for a new process to be started.
+// * Upgrades the vault executable on request, restarting running vaults in batches.
+// * Adopts vaults left running by a previous VaultManager instance once they reconnect and sign a
+//   challenge with their Pmid, rather than starting duplicates of them.
+// * Removes vaults on request, deleting their directories in the background at a limited rate.
+//   Only directories which the VaultManager itself created on a data volume are deleted.
 class VaultManager {
  public:
   VaultManager(const VaultManager&) = delete;
   VaultManager(VaultManager&&) = delete;
   VaultManager operator=(VaultManager) = delete;
 
-  VaultManager();
+  // New vaults for which the client doesn't specify a directory are placed on one of
+  // 'data_volumes', or in the VaultManager's own directory if that's empty.
+  explicit VaultManager(
+      int standby_vault_count = 0,
+      std::vector<boost::filesystem::path> data_volumes = std::vector<boost::filesystem::path>());
   ~VaultManager();
 
   void TearDownWithInterval();
+  // Stops the VaultManager but leaves its vaults running, so that they can be adopted by the next
+  // VaultManager instance.
+  void TearDownForHandover();
 
  private:
   void HandleNewConnection(tcp::ConnectionPtr connection);
@@ -71,29 +112,82 @@ class VaultManager {
   void HandleValidateConnectionRequest(tcp::ConnectionPtr connection);
   void HandleChallengeResponse(tcp::ConnectionPtr connection,
                                ChallengeResponse&& challenge_response);
+  void HandleResumeSessionRequest(tcp::ConnectionPtr connection,
+                                  ResumeSessionRequest&& resume_session_request);
+  void HandleClientValidated(tcp::ConnectionPtr connection, const Identity& client_name);
   void HandleStartVaultRequest(tcp::ConnectionPtr connection,
                                StartVaultRequest&& start_vault_request);
   void HandleTakeOwnershipRequest(tcp::ConnectionPtr connection,
                                   TakeOwnershipRequest&& take_ownership_request);
+  void HandleUpgradeVaultsRequest(tcp::ConnectionPtr connection,
+                                  UpgradeVaultsRequest&& upgrade_vaults_request);
   void HandleSetNetworkAsStable();
   void HandleNetworkStableRequest(tcp::ConnectionPtr connection);
+  void HandleVaultStatsRequest(tcp::ConnectionPtr connection,
+                               VaultStatsRequest&& vault_stats_request);
+  void HandleListVaultsRequest(tcp::ConnectionPtr connection,
+                               ListVaultsRequest&& list_vaults_request);
+  void HandleFlowControlAck(tcp::ConnectionPtr connection, FlowControlAck&& flow_control_ack);
+  void HandleVaultEventsSubscription(tcp::ConnectionPtr connection,
+                                     VaultEventsSubscription&& vault_events_subscription);
+  void HandleRemoveVaultRequest(tcp::ConnectionPtr connection,
+                                RemoveVaultRequest&& remove_vault_request);
 
   // Messages from Vault
   void HandleVaultStarted(tcp::ConnectionPtr connection, VaultStarted&& vault_started);
   void HandleJoinedNetwork(tcp::ConnectionPtr connection);
+  void HandleNetworkHealthUpdate(tcp::ConnectionPtr connection,
+                                 NetworkHealthUpdate&& network_health_update);
+  void HandleHeartbeatResponse(tcp::ConnectionPtr connection,
+                               HeartbeatResponse&& heartbeat_response);
+  void HandleVaultStats(tcp::ConnectionPtr connection, VaultStats&& vault_stats);
+  void HandleVaultReconnectRequest(tcp::ConnectionPtr connection,
+                                   VaultReconnectRequest&& vault_reconnect_request);
+  void HandleVaultChallengeResponse(tcp::ConnectionPtr connection,
+                                    VaultChallengeResponse&& vault_challenge_response);
   void HandleLogMessage(tcp::ConnectionPtr connection, LogMessage&& log_message);
 
+  void SendVaultConfig(const VaultInfo& vault_info);
+  void SendVaultNetworkStatus(const VaultInfo& vault_info);
+  void SendVaultEvent(const Identity& owner_name, VaultEvent event);
+  void SendRemovalProgress(const Identity& owner_name, VaultRemovalProgress progress);
+
   void RemoveFromNewConnections(tcp::ConnectionPtr connection);
-  void ChangeChunkstorePath(VaultInfo vault_info);
+  void RestartVault(VaultInfo vault_info);
+  // Adds the vault requested by 'client' once its directory is ready, or reports 'io_error'.
+  void AddVault(tcp::ConnectionPtr client, VaultInfo vault_info,
+                std::exception_ptr io_error = std::exception_ptr());
+  // Called once the stopped vault's removal from the config file is durable (or has failed with
+  // 'io_error'), to reply to its owner and start deleting 'vault_dir'.
+  void HandleVaultRemoved(const Identity& owner_name, const NonEmptyString& label,
+                          const boost::filesystem::path& vault_dir, std::exception_ptr io_error);
+  // Provides the paths which 'chunkstore_reclaimer_' mustn't delete, gathered on the asio thread.
+  std::future<std::vector<boost::filesystem::path>> GetProtectedPaths();
+  // Throws if 'vault_dir' is still being deleted after its previous vault was removed.
+  void CheckVaultDirIsFree(const boost::filesystem::path& vault_dir);
+  // Samples the data volumes' I/O load on 'blocking_io_' every kIoLoadSampleInterval.
+  void SampleIoLoad();
 
   ConfigFileHandler config_file_handler_;
-  bool network_stable_, tear_down_with_interval_;
+  // Vault lifecycle events, recorded by 'process_manager_' for offline analysis.
+  std::shared_ptr<EventLog> event_log_;
+  bool network_stable_, tear_down_with_interval_, handed_over_;
   AsioService asio_service_;
   asio::io_service::strand strand_;
+  VaultPlacer vault_placer_;
+  Timer io_load_timer_;
+  ChunkstoreReclaimer chunkstore_reclaimer_;
+  // Declared after the members used by its tasks, since it waits for running tasks on destruction.
+  BlockingIo blocking_io_;
+  ConfigPersister config_persister_;
   std::shared_ptr<tcp::Listener> listener_;
   std::shared_ptr<ProcessManager> process_manager_;
   std::shared_ptr<ClientConnections> client_connections_;
   std::shared_ptr<NewConnections> new_connections_;
+  std::shared_ptr<RollingUpgrade> rolling_upgrade_;
+  // Reconnected vaults which have been sent a challenge but haven't yet responded.
+  std::map<tcp::ConnectionPtr, std::pair<process::ProcessId, asymm::PlainText>,
+           std::owner_less<tcp::ConnectionPtr>> pending_adoptions_;
 };
 
 }  // namespace vault_manager
@@ -22,6 +22,8 @@
 #include <signal.h>
 #endif
 
+#include <atomic>
+#include <chrono>
 #include <future>
 #include <iostream>
 #include <string>
@@ -37,6 +39,7 @@
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/utils.h"
 
+#include "maidsafe/vault_manager/tracing.h"
 #include "maidsafe/vault_manager/vault_manager.h"
 #include "maidsafe/vault_manager/utils.h"
 
@@ -46,12 +49,35 @@ namespace po = boost::program_options;
 namespace {
 
 std::promise<void> g_shutdown_promise;
+std::atomic<bool> g_hand_over_vaults{false};
+std::atomic<bool> g_write_trace{false};
 
 void ShutDownVaultManager(int /*signal*/) {
   std::cout << "Stopping vault_manager." << std::endl;
   g_shutdown_promise.set_value();
 }
 
+#ifndef MAIDSAFE_WIN32
+// Stops the vault_manager but leaves the vaults running for the next instance to adopt.
+void HandOverVaultManager(int signal) {
+  g_hand_over_vaults = true;
+  ShutDownVaultManager(signal);
+}
+
+// The trace is written by the main thread, since file I/O isn't safe in a signal handler.
+void RequestTraceWrite(int /*signal*/) { g_write_trace = true; }
+#endif
+
+void WriteTrace(const fs::path& trace_path) {
+  if (trace_path.empty())
+    return;
+  try {
+    maidsafe::vault_manager::WriteChromeTrace(trace_path);
+  } catch (const std::exception& e) {
+    LOG(kError) << "Failed to write trace: " << boost::diagnostic_information(e);
+  }
+}
+
 #ifdef MAIDSAFE_WIN32
 
 enum { kMaidSafeVaultManagerStdException = 0x1, kMaidSafeVaultServiceUnknownException };
@@ -133,9 +159,19 @@ BOOL CtrlHandler(DWORD control_type) {
 
 #endif
 
-void HandleProgramOptions(int argc, char** argv) {
+po::variables_map HandleProgramOptions(int argc, char** argv) {
   po::options_description options_description("Allowed options");
   options_description.add_options()
+      ("standby_vaults", po::value<int>()->default_value(0),
+       "Number of pre-started vault processes to keep ready for new or restarted vaults.  These "
+       "are started before their vault is known, so unlike other vault processes they aren't "
+       "passed --log_folder and log to the vault executable's default log location")
+      ("data_volumes", po::value<std::vector<std::string>>()->multitoken(),
+       "Directories (ideally one per disk) on which to place new vaults for which the client "
+       "doesn't specify a directory.  Defaults to the vault_manager's own directory")
+      ("trace_file", po::value<std::string>(),
+       "Path to write tracing spans to (Chrome trace format) on exit, or on SIGUSR2.  Only "
+       "effective if built with VAULT_MANAGER_TRACING")
 #ifdef TESTING
       ("port", po::value<int>(), "Listening port")("vault_path", po::value<std::string>(),
                                                    "Path to the vault executable including name")(
@@ -174,6 +210,33 @@ void HandleProgramOptions(int argc, char** argv) {
 
   maidsafe::vault_manager::test::SetEnvironment(port, root_dir, path_to_vault);
 #endif
+  return variables_map;
+}
+
+fs::path GetTracePath(const po::variables_map& variables_map) {
+  if (variables_map.count("trace_file") == 0)
+    return fs::path();
+  if (!maidsafe::vault_manager::TracingEnabled())
+    LOG(kWarning) << "trace_file is ignored since this build doesn't include tracing.";
+  return fs::path(variables_map.at("trace_file").as<std::string>());
+}
+
+int GetStandbyVaultCount(const po::variables_map& variables_map) {
+  int standby_vault_count{variables_map.at("standby_vaults").as<int>()};
+  if (standby_vault_count < 0) {
+    LOG(kError) << "standby_vaults can't be negative";
+    BOOST_THROW_EXCEPTION(maidsafe::MakeError(maidsafe::CommonErrors::invalid_argument));
+  }
+  return standby_vault_count;
+}
+
+std::vector<fs::path> GetDataVolumes(const po::variables_map& variables_map) {
+  std::vector<fs::path> data_volumes;
+  if (variables_map.count("data_volumes") != 0) {
+    for (const auto& data_volume : variables_map.at("data_volumes").as<std::vector<std::string>>())
+      data_volumes.emplace_back(data_volume);
+  }
+  return data_volumes;
 }
 
 }  // unnamed namespace
@@ -183,10 +246,12 @@ int main(int argc, char** argv) {
 #ifdef MAIDSAFE_WIN32
 #ifdef TESTING
   try {
-    HandleProgramOptions(argc, argv);
+    auto variables_map(HandleProgramOptions(argc, argv));
     if (SetConsoleCtrlHandler(reinterpret_cast<PHANDLER_ROUTINE>(CtrlHandler), TRUE)) {
-      maidsafe::vault_manager::VaultManager vault_manager;
+      maidsafe::vault_manager::VaultManager vault_manager{GetStandbyVaultCount(variables_map),
+                                                          GetDataVolumes(variables_map)};
       g_shutdown_promise.get_future().get();
+      WriteTrace(GetTracePath(variables_map));
     } else {
       LOG(kError) << "Failed to set control handler.";
       return -3;
@@ -206,12 +271,23 @@ int main(int argc, char** argv) {
 #endif
 #else
   try {
-    HandleProgramOptions(argc, argv);
-    maidsafe::vault_manager::VaultManager vault_manager;
+    auto variables_map(HandleProgramOptions(argc, argv));
+    const fs::path kTracePath(GetTracePath(variables_map));
+    maidsafe::vault_manager::VaultManager vault_manager{GetStandbyVaultCount(variables_map),
+                                                        GetDataVolumes(variables_map)};
     std::cout << "Successfully started vault_manager" << std::endl;
     signal(SIGINT, ShutDownVaultManager);
     signal(SIGTERM, ShutDownVaultManager);
-    g_shutdown_promise.get_future().get();
+    signal(SIGUSR1, HandOverVaultManager);
+    signal(SIGUSR2, RequestTraceWrite);
+    auto shutdown_future(g_shutdown_promise.get_future());
+    while (shutdown_future.wait_for(std::chrono::seconds(1)) != std::future_status::ready) {
+      if (g_write_trace.exchange(false))
+        WriteTrace(kTracePath);
+    }
+    if (g_hand_over_vaults)
+      vault_manager.TearDownForHandover();
+    WriteTrace(kTracePath);
     std::cout << "Successfully stopped vault_manager" << std::endl;
   } catch (const std::exception& e) {
     LOG(kError) << "Error: " << e.what();
@@ -0,0 +1,214 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/vault_manager/vault_placement.h"
+
+#ifndef MAIDSAFE_WIN32
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+#ifdef __linux__
+#include <sys/sysmacros.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+namespace {
+
+// How much a fully-busy device's score is reduced by, relative to an idle one.
+const double kIoLoadWeight(0.5);
+
+fs::path NearestExisting(fs::path path) {
+  boost::system::error_code error_code;
+  path = fs::absolute(path);
+  while (!path.empty() && !fs::exists(path, error_code))
+    path = path.parent_path();
+  return path;
+}
+
+// Falls back to the path itself if the device can't be determined, so that the path is at least
+// counted against itself.
+std::string GetDevice(const fs::path& path) {
+  fs::path existing{NearestExisting(path)};
+#ifdef MAIDSAFE_WIN32
+  return existing.root_name().string();
+#else
+  struct stat status;
+  if (existing.empty() || stat(existing.c_str(), &status) != 0) {
+    LOG(kWarning) << "Failed to find device for " << path;
+    return path.string();
+  }
+  return std::to_string(major(status.st_dev)) + ":" + std::to_string(minor(status.st_dev));
+#endif
+}
+
+}  // unnamed namespace
+
+std::size_t ChooseVolume(const std::vector<VolumeState>& volumes) {
+  std::size_t chosen(volumes.size());
+  double best_score(0.0);
+  for (std::size_t i(0); i < volumes.size(); ++i) {
+    if (volumes[i].available == 0)
+      continue;
+    double io_load(std::min(std::max(volumes[i].io_load, 0.0), 1.0));
+    double score(static_cast<double>(volumes[i].available) / (volumes[i].vault_count + 1) *
+                 (1.0 - kIoLoadWeight * io_load));
+    if (chosen == volumes.size() || score > best_score) {
+      chosen = i;
+      best_score = score;
+    }
+  }
+  if (chosen == volumes.size()) {
+    LOG(kError) << "No data volume has space for a new vault.";
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::filesystem_io_error));
+  }
+  return chosen;
+}
+
+DiskUsage VaultShare(const VolumeState& volume) {
+  std::uint64_t shares(static_cast<std::uint64_t>(volume.vault_count) + 1);
+  return DiskUsage{(volume.available / 10 * 9) / shares};
+}
+
+std::map<std::string, std::uint64_t> ParseDiskStats(std::istream& input) {
+  // Each line is "<major> <minor> <name>" followed by at least 11 counters, the 10th of which is
+  // the number of milliseconds spent doing I/O.
+  std::map<std::string, std::uint64_t> io_ticks;
+  std::string line;
+  while (std::getline(input, line)) {
+    std::istringstream fields(line);
+    unsigned int major_number(0), minor_number(0);
+    std::string name;
+    if (!(fields >> major_number >> minor_number >> name))
+      continue;
+    std::uint64_t value(0);
+    int counter(0);
+    while (counter < 10 && (fields >> value))
+      ++counter;
+    if (counter == 10)
+      io_ticks[std::to_string(major_number) + ":" + std::to_string(minor_number)] = value;
+  }
+  return io_ticks;
+}
+
+VaultPlacer::VaultPlacer(std::vector<fs::path> data_volumes, fs::path default_volume)
+    : mutex_(),
+      kVolumes_(data_volumes.empty() ? std::vector<fs::path>{std::move(default_volume)}
+                                     : std::move(data_volumes)),
+      last_io_ticks_(),
+      last_sampled_(),
+      io_load_(),
+      placed_() {}
+
+VaultPlacement VaultPlacer::Place(const std::vector<fs::path>& existing_vault_dirs,
+                                  const std::string& dir_name) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  // Vaults placed by earlier calls appear in 'existing_vault_dirs' once they've been added.
+  placed_.erase(std::remove_if(placed_.begin(), placed_.end(),
+                               [&](const fs::path& placed) {
+                                 return std::find(existing_vault_dirs.begin(),
+                                                  existing_vault_dirs.end(),
+                                                  placed) != existing_vault_dirs.end();
+                               }),
+                placed_.end());
+
+  std::vector<VolumeState> volumes{Measure()};
+  std::map<std::string, int> vaults_per_device;
+  for (const auto& vault_dir : existing_vault_dirs)
+    ++vaults_per_device[GetDevice(vault_dir)];
+  for (const auto& vault_dir : placed_)
+    ++vaults_per_device[GetDevice(vault_dir)];
+  for (auto& volume : volumes)
+    volume.vault_count = vaults_per_device[volume.device];
+
+  const VolumeState& chosen(volumes[ChooseVolume(volumes)]);
+  VaultPlacement placement{chosen.path / dir_name, VaultShare(chosen)};
+  placed_.push_back(placement.vault_dir);
+  LOG(kInfo) << "Placing vault in " << placement.vault_dir << " (device " << chosen.device
+             << ", " << chosen.vault_count << " vaults already, I/O load " << chosen.io_load
+             << ")";
+  return placement;
+}
+
+void VaultPlacer::Forget(const fs::path& vault_dir) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  placed_.erase(std::remove(placed_.begin(), placed_.end(), vault_dir), placed_.end());
+}
+
+void VaultPlacer::SampleIoLoad() {
+  std::map<std::string, std::uint64_t> io_ticks;
+#ifdef __linux__
+  std::ifstream disk_stats("/proc/diskstats");
+  if (disk_stats)
+    io_ticks = ParseDiskStats(disk_stats);
+#endif
+  std::lock_guard<std::mutex> lock{mutex_};
+  auto now(std::chrono::steady_clock::now());
+  auto elapsed_ms(std::chrono::duration_cast<std::chrono::milliseconds>(now - last_sampled_));
+  io_load_.clear();
+  if (last_sampled_ != std::chrono::steady_clock::time_point() && elapsed_ms.count() > 0) {
+    for (const auto& current : io_ticks) {
+      auto previous(last_io_ticks_.find(current.first));
+      if (previous != last_io_ticks_.end() && current.second >= previous->second) {
+        io_load_[current.first] = static_cast<double>(current.second - previous->second) /
+                                  static_cast<double>(elapsed_ms.count());
+      }
+    }
+  }
+  last_io_ticks_ = std::move(io_ticks);
+  last_sampled_ = now;
+}
+
+std::vector<VolumeState> VaultPlacer::Measure() {
+  std::vector<VolumeState> volumes;
+  for (const auto& path : kVolumes_) {
+    VolumeState volume{path, GetDevice(path), 0, 0, 0.0};
+    boost::system::error_code error_code;
+    if (!fs::exists(path, error_code))
+      fs::create_directories(path, error_code);
+    auto space_info(fs::space(path, error_code));
+    if (error_code)
+      LOG(kWarning) << "Failed to get free space of " << path << ": " << error_code.message();
+    else
+      volume.available = space_info.available;
+
+    auto io_load(io_load_.find(volume.device));
+    if (io_load != io_load_.end())
+      volume.io_load = io_load->second;
+    volumes.push_back(std::move(volume));
+  }
+  return volumes;
+}
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
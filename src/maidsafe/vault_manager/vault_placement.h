@@ -0,0 +1,115 @@
+/*  Copyright 2015 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_VAULT_MANAGER_VAULT_PLACEMENT_H_
+#define MAIDSAFE_VAULT_MANAGER_VAULT_PLACEMENT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/types.h"
+
+namespace maidsafe {
+
+namespace vault_manager {
+
+// The state of one data volume, as considered when placing a new vault.
+struct VolumeState {
+  boost::filesystem::path path;
+  // Identifies the underlying device, so that vaults on different volumes of it are counted
+  // together.
+  std::string device;
+  std::uint64_t available;
+  int vault_count;
+  // Fraction of the most recent sampling interval during which the device was busy doing I/O, in
+  // [0, 1].
+  double io_load;
+};
+
+// Returns the index in 'volumes' of the one a new vault should be placed on: the one offering the
+// vault the largest share of its free space, weighted against its I/O load.  Volumes with no free
+// space are never chosen.  Throws CommonErrors::filesystem_io_error if none is suitable.
+std::size_t ChooseVolume(const std::vector<VolumeState>& volumes);
+
+// The share of a volume's free space which a new vault on it is allowed to use.
+DiskUsage VaultShare(const VolumeState& volume);
+
+// Parses the contents of /proc/diskstats, returning the milliseconds spent doing I/O so far for
+// each device, keyed by "major:minor".  Malformed lines are skipped.
+std::map<std::string, std::uint64_t> ParseDiskStats(std::istream& input);
+
+struct VaultPlacement {
+  VaultPlacement() : vault_dir(), max_disk_usage(0) {}
+  VaultPlacement(boost::filesystem::path vault_dir_in, DiskUsage max_disk_usage_in)
+      : vault_dir(std::move(vault_dir_in)), max_disk_usage(std::move(max_disk_usage_in)) {}
+
+  boost::filesystem::path vault_dir;
+  DiskUsage max_disk_usage;
+};
+
+// Chooses the directory for each new vault for which the client didn't specify one, from among
+// the configured data volumes.  All member functions block on the filesystem, so should be run via
+// BlockingIo.  They are thread-safe.
+class VaultPlacer {
+ public:
+  // If 'data_volumes' is empty, 'default_volume' is used.
+  VaultPlacer(std::vector<boost::filesystem::path> data_volumes,
+              boost::filesystem::path default_volume);
+  VaultPlacer(const VaultPlacer&) = delete;
+  VaultPlacer(VaultPlacer&&) = delete;
+  VaultPlacer& operator=(VaultPlacer) = delete;
+
+  // Chooses a volume (see ChooseVolume), taking into account the vaults already in
+  // 'existing_vault_dirs' and any placed by previous calls which aren't yet in there.  Returns
+  // '<volume>/<dir_name>' and the vault's share of the volume; the directory isn't created.
+  VaultPlacement Place(const std::vector<boost::filesystem::path>& existing_vault_dirs,
+                       const std::string& dir_name);
+  // Should be called if the vault placed in 'vault_dir' couldn't be started, so that it's no
+  // longer counted.
+  void Forget(const boost::filesystem::path& vault_dir);
+  // Updates each device's I/O load to that since the previous call.  Should be called on a fixed
+  // interval (kIoLoadSampleInterval), so that the load reflects recent activity.
+  void SampleIoLoad();
+  const std::vector<boost::filesystem::path>& Volumes() const { return kVolumes_; }
+
+ private:
+  // Returns each volume's current free space and most recently sampled I/O load.
+  std::vector<VolumeState> Measure();
+
+  std::mutex mutex_;
+  const std::vector<boost::filesystem::path> kVolumes_;
+  std::map<std::string, std::uint64_t> last_io_ticks_;
+  std::chrono::steady_clock::time_point last_sampled_;
+  std::map<std::string, double> io_load_;
+  // Dirs chosen by Place which haven't yet appeared in 'existing_vault_dirs'.
+  std::vector<boost::filesystem::path> placed_;
+};
+
+}  // namespace vault_manager
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_VAULT_MANAGER_VAULT_PLACEMENT_H_